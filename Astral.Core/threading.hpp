@@ -174,6 +174,11 @@ namespace threading
         pthread_create(&threadID, NULL, func, inputArgs);
         return threadID;
     }
+    /// Blocks until the thread has returned, then releases it
+    inline void JoinThread(Thread thread)
+    {
+        pthread_join(thread, NULL);
+    }
 #endif
 
 #ifdef WINDOWS
@@ -184,5 +189,11 @@ namespace threading
     {
         return CreateThread(NULL, 0, func, inputArgs, 0, NULL);
     }
+    /// Blocks until the thread has returned, then releases it
+    inline void JoinThread(Thread thread)
+    {
+        WaitForSingleObject(thread, INFINITE);
+        CloseHandle(thread);
+    }
 #endif
 }
\ No newline at end of file
@@ -27,6 +27,11 @@ struct AstralShadercUniform
     u32 binding;
     usize size;
 };
+struct AstralShadercPushConstants
+{
+    string variableName;
+    usize size;
+};
 struct AstralShadercResource
 {
     string variableName;
@@ -47,6 +52,7 @@ struct AstralShadercShaderVariables
     collections::Array<AstralShadercResource> samplers;
     collections::Array<AstralShadercResource> inputAttachments;
     collections::Array<AstralShadercResource> computeBuffers;
+    collections::Array<AstralShadercPushConstants> pushConstants;
 
     inline AstralShadercShaderVariables()
     {
@@ -55,6 +61,7 @@ struct AstralShadercShaderVariables
         samplers = collections::Array<AstralShadercResource>();
         inputAttachments = collections::Array<AstralShadercResource>();
         computeBuffers = collections::Array<AstralShadercResource>();
+        pushConstants = collections::Array<AstralShadercPushConstants>();
     }
     inline AstralShadercShaderVariables(IAllocator allocator)
     {
@@ -63,6 +70,7 @@ struct AstralShadercShaderVariables
         samplers = collections::Array<AstralShadercResource>(allocator);
         inputAttachments = collections::Array<AstralShadercResource>(allocator);
         computeBuffers = collections::Array<AstralShadercResource>(allocator);
+        pushConstants = collections::Array<AstralShadercPushConstants>(allocator);
     }
     inline void deinit()
     {
@@ -71,6 +79,7 @@ struct AstralShadercShaderVariables
         samplers.deinit();
         inputAttachments.deinit();
         computeBuffers.deinit();
+        pushConstants.deinit();
     }
 };
 
@@ -483,6 +492,25 @@ inline bool AstralShaderc_GenerateReflectionData(IAllocator allocator, AstralSha
         shaderVariables->uniforms.data[i] = uniformData;
     }
 
+    //get push constants, glsl only allows one block per stage but spirv-cross reports them as a list
+    spvc_resources_get_resource_list_for_type(resources, SPVC_RESOURCE_TYPE_PUSH_CONSTANT, &allResources, &uniformCount);
+
+    shaderVariables->pushConstants = collections::Array<AstralShadercPushConstants>(allocator, uniformCount);
+    for (usize i = 0; i < uniformCount; i++)
+    {
+        usize structSize;
+        if (spvc_compiler_get_declared_struct_size(compiler, spvc_compiler_get_type_handle(compiler, allResources[i].type_id), &structSize) != SPVC_SUCCESS)
+        {
+            fprintf(stderr, "Failed to find push constants size\n");
+            return false;
+        }
+
+        AstralShadercPushConstants pushConstantsData;
+        pushConstantsData.variableName = string(allocator, allResources[i].name);
+        pushConstantsData.size = structSize;
+        shaderVariables->pushConstants.data[i] = pushConstantsData;
+    }
+
     //get textures
     usize resourcesCount = 0;
     usize mslBinding = 0;
@@ -926,6 +954,25 @@ inline void AstralShaderc_WriteShaderData(Json::JsonWriter *writer, collections:
         writer->WriteEndArray();
     }
 
+    if (variables->pushConstants.length > 0)
+    {
+        writer->WritePropertyName("pushConstants");
+        writer->WriteStartArray();
+        for (usize i = 0; i < variables->pushConstants.length; i++)
+        {
+            writer->WriteStartObject();
+
+            writer->WritePropertyName("name");
+            writer->WriteString(variables->pushConstants.data[i].variableName.buffer);
+
+            writer->WritePropertyName("size");
+            writer->WriteUintValue(variables->pushConstants.data[i].size);
+
+            writer->WriteEndObject();
+        }
+        writer->WriteEndArray();
+    }
+
     if (variables->textures.length > 0)
     {
         writer->WritePropertyName("images");
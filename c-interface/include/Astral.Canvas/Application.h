@@ -18,6 +18,13 @@ extern "C"
     DynamicFunction const char *AstralCanvasApplication_GetEngineName(AstralCanvasApplication ptr);
     DynamicFunction float AstralCanvasApplication_GetFramesPerSecond(AstralCanvasApplication ptr);
     DynamicFunction void AstralCanvasApplication_SetFramesPerSecond(AstralCanvasApplication ptr, float frames);
+    DynamicFunction u32 AstralCanvasApplication_GetFramesInFlight(AstralCanvasApplication ptr);
+    DynamicFunction void AstralCanvasApplication_SetFramesInFlight(AstralCanvasApplication ptr, u32 frames);
+    DynamicFunction bool AstralCanvasApplication_GetUseDynamicRendering(AstralCanvasApplication ptr);
+    DynamicFunction void AstralCanvasApplication_SetUseDynamicRendering(AstralCanvasApplication ptr, bool value);
+    DynamicFunction const char *AstralCanvasApplication_GetPipelineCachePath(AstralCanvasApplication ptr);
+    DynamicFunction void AstralCanvasApplication_SetPipelineCachePath(AstralCanvasApplication ptr, const char *path);
+    DynamicFunction bool AstralCanvasApplication_SavePipelineCache(AstralCanvasApplication ptr);
     DynamicFunction void AstralCanvasApplication_AddWindow(AstralCanvasApplication ptr, const char *name, i32 width, i32 height, bool resizeable, void *iconData, u32 iconWidth, u32 iconHeight);
     DynamicFunction AstralCanvasWindow AstralCanvasApplication_GetWindow(AstralCanvasApplication ptr, usize index);
     DynamicFunction AstralCanvasApplication AstralCanvasApplication_Init(const char *appName, const char *engineName, u32 appVersion, u32 engineVersion, float framesPerSecond);
@@ -150,6 +150,26 @@ typedef enum
     AstralCanvas_PrimitiveType_TriangleFan,
 } AstralCanvas_PrimitiveType;
 
+typedef enum
+{
+    AstralCanvas_SpriteSortMode_Deferred,
+    AstralCanvas_SpriteSortMode_Texture,
+    AstralCanvas_SpriteSortMode_BackToFront,
+    AstralCanvas_SpriteSortMode_FrontToBack
+} AstralCanvas_SpriteSortMode;
+
+typedef enum
+{
+    AstralCanvas_GPUMemoryKind_Texture,
+    AstralCanvas_GPUMemoryKind_Vertex,
+    AstralCanvas_GPUMemoryKind_Index,
+    AstralCanvas_GPUMemoryKind_Uniform,
+    AstralCanvas_GPUMemoryKind_Compute,
+    AstralCanvas_GPUMemoryKind_Staging,
+
+    AstralCanvas_GPUMemoryKind_Count
+} AstralCanvas_GPUMemoryKind;
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
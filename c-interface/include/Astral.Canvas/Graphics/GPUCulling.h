@@ -0,0 +1,38 @@
+#pragma once
+#include "Linxc.h"
+#include "Astral.Canvas/Graphics/Shader.h"
+#include "Astral.Canvas/Graphics/ComputeBuffer.h"
+#include "Astral.Canvas/Graphics/Graphics.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef struct
+    {
+        float boundingSphere[4];
+        u32 drawRecord;
+        u32 padding[3];
+    } AstralCanvasGPUCullingInstance;
+
+    typedef struct
+    {
+        u32 indexCount;
+        u32 firstIndex;
+        i32 vertexOffset;
+        u32 padding;
+    } AstralCanvasGPUCullingDrawRecord;
+
+    typedef void *AstralCanvasGPUCullingPass;
+    DynamicFunction AstralCanvasGPUCullingPass AstralCanvasGPUCullingPass_Create(AstralCanvasShader cullingShader, u32 maxDraws);
+    DynamicFunction void AstralCanvasGPUCullingPass_Deinit(AstralCanvasGPUCullingPass ptr);
+    /// viewProjection is 16 floats, laid out the same as Maths::Matrix4x4
+    DynamicFunction void AstralCanvasGPUCullingPass_Cull(AstralCanvasGPUCullingPass ptr, AstralCanvasGraphics graphics, AstralCanvasComputeBuffer instances, u32 instanceCount, AstralCanvasComputeBuffer drawRecords, float *viewProjection);
+    DynamicFunction void AstralCanvasGPUCullingPass_Draw(AstralCanvasGPUCullingPass ptr, AstralCanvasGraphics graphics);
+    DynamicFunction AstralCanvasComputeBuffer AstralCanvasGPUCullingPass_GetDrawCommands(AstralCanvasGPUCullingPass ptr);
+    DynamicFunction AstralCanvasComputeBuffer AstralCanvasGPUCullingPass_GetDrawCount(AstralCanvasGPUCullingPass ptr);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+#include "Linxc.h"
+#include "Astral.Canvas/Graphics/Enums.h"
+#include "Astral.Canvas/Graphics/VertexDeclaration.h"
+#include "Astral.Canvas/Graphics/Graphics.h"
+#include "Astral.Canvas/Graphics/VertexBuffer.h"
+#include "Astral.Canvas/Graphics/IndexBuffer.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef struct
+    {
+        AstralCanvasVertexBuffer vertexBuffer;
+        AstralCanvasIndexBuffer indexBuffer;
+        u32 vertexOffset;
+        u32 vertexCount;
+        u32 firstIndex;
+        u32 indexCount;
+    } AstralCanvasGeometryHandle;
+
+    typedef void *AstralCanvasGeometryArena;
+    DynamicFunction AstralCanvasGeometryArena AstralCanvasGeometryArena_Create(AstralCanvasVertexDeclaration vertexType, usize vertexCapacity, AstralCanvas_IndexBufferSize indexElementSize, usize indexCapacity);
+    DynamicFunction void AstralCanvasGeometryArena_Deinit(AstralCanvasGeometryArena ptr);
+    DynamicFunction AstralCanvasGeometryHandle AstralCanvasGeometryArena_Allocate(AstralCanvasGeometryArena ptr, void *vertexData, u32 vertexCount, u8 *indexData, u32 indexCount);
+    DynamicFunction void AstralCanvasGeometryArena_Free(AstralCanvasGeometryArena ptr, AstralCanvasGeometryHandle handle);
+    DynamicFunction void AstralCanvasGeometryArena_Bind(AstralCanvasGeometryArena ptr, AstralCanvasGraphics graphics, u32 bindingPoint);
+    DynamicFunction void AstralCanvasGeometryArena_Draw(AstralCanvasGeometryArena ptr, AstralCanvasGraphics graphics, AstralCanvasGeometryHandle handle, u32 instanceCount, u32 firstInstance);
+
+#ifdef __cplusplus
+}
+#endif
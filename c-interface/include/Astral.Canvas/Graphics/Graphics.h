@@ -9,6 +9,7 @@
 #include "Astral.Canvas/Graphics/RenderProgram.h"
 #include "Astral.Canvas/Graphics/RenderPipeline.h"
 #include "Astral.Canvas/Graphics/Color.h"
+#include "Astral.Canvas/Graphics/Compute.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -21,6 +22,15 @@ extern "C"
         i32 width;
         i32 height;
     } AstralCanvasClipArea;
+    typedef struct
+    {
+        u32 pipelineBinds;
+        u32 vertexBufferBinds;
+        u32 indexBufferBinds;
+        u32 viewports;
+        u32 scissors;
+        u32 descriptorSetBinds;
+    } AstralCanvasGraphicsSkippedCommands;
     typedef void *AstralCanvasGraphics;
 
     DynamicFunction AstralCanvasRenderProgram AstralCanvasGraphics_GetCurrentRenderProgram(AstralCanvasGraphics ptr);
@@ -32,6 +42,7 @@ extern "C"
     DynamicFunction void AstralCanvasGraphics_SetIndexBuffer(AstralCanvasGraphics ptr, const AstralCanvasIndexBuffer indexBuffer);
     DynamicFunction void AstralCanvasGraphics_SetRenderTarget(AstralCanvasGraphics ptr, AstralCanvasRenderTarget target);
     DynamicFunction void AstralCanvasGraphics_StartRenderProgram(AstralCanvasGraphics ptr, AstralCanvasRenderProgram program, AstralCanvasColor clearColor);
+    DynamicFunction void AstralCanvasGraphics_StartRenderProgramForContexts(AstralCanvasGraphics ptr, AstralCanvasRenderProgram program, AstralCanvasColor clearColor);
     DynamicFunction void AstralCanvasGraphics_EndRenderProgram(AstralCanvasGraphics ptr);
     DynamicFunction void AstralCanvasGraphics_UseRenderPipeline(AstralCanvasGraphics ptr, AstralCanvasRenderPipeline pipeline);
     DynamicFunction void AstralCanvasGraphics_AwaitGraphicsIdle(AstralCanvasGraphics ptr);
@@ -41,15 +52,27 @@ extern "C"
     DynamicFunction void AstralCanvasGraphics_SetShaderVariableSampler(AstralCanvasGraphics ptr, const char* variableName, AstralCanvasSamplerState sampler);
     DynamicFunction void AstralCanvasGraphics_SetShaderVariableSamplers(AstralCanvasGraphics ptr, const char* variableName, AstralCanvasSamplerState *samplers, usize count);
     DynamicFunction void AstralCanvasGraphics_SetShaderVariableComputeBuffer(AstralCanvasGraphics ptr, const char* variableName, AstralCanvasComputeBuffer computeBuffer);
+    DynamicFunction void AstralCanvasGraphics_SetShaderVariableByHandle(AstralCanvasGraphics ptr, AstralCanvasShaderVariableHandle handle, void* data, usize size);
+    DynamicFunction void AstralCanvasGraphics_SetShaderVariableTextureByHandle(AstralCanvasGraphics ptr, AstralCanvasShaderVariableHandle handle, AstralCanvasTexture2D texture);
+    DynamicFunction void AstralCanvasGraphics_SetShaderVariableTexturesByHandle(AstralCanvasGraphics ptr, AstralCanvasShaderVariableHandle handle, AstralCanvasTexture2D *textures, usize count);
+    DynamicFunction void AstralCanvasGraphics_SetShaderVariableSamplerByHandle(AstralCanvasGraphics ptr, AstralCanvasShaderVariableHandle handle, AstralCanvasSamplerState sampler);
+    DynamicFunction void AstralCanvasGraphics_SetShaderVariableSamplersByHandle(AstralCanvasGraphics ptr, AstralCanvasShaderVariableHandle handle, AstralCanvasSamplerState *samplers, usize count);
+    DynamicFunction void AstralCanvasGraphics_SetShaderVariableComputeBufferByHandle(AstralCanvasGraphics ptr, AstralCanvasShaderVariableHandle handle, AstralCanvasComputeBuffer computeBuffer);
+    DynamicFunction void AstralCanvasGraphics_SetPushConstants(AstralCanvasGraphics ptr, void *data, u32 size, u32 offset);
+    DynamicFunction void AstralCanvasGraphics_SetDrawMerging(AstralCanvasGraphics ptr, bool enabled);
+    DynamicFunction void AstralCanvasGraphics_FlushMergedDraws(AstralCanvasGraphics ptr);
     DynamicFunction void AstralCanvasGraphics_SendUpdatedUniforms(AstralCanvasGraphics ptr);
     DynamicFunction void AstralCanvasGraphics_DrawIndexedPrimitives(AstralCanvasGraphics ptr, u32 indexCount, u32 instanceCount, u32 firstIndex, u32 vertexOffset, u32 firstInstance);
     DynamicFunction void AstralCanvasGraphics_DrawIndexedPrimitivesIndirectCount(AstralCanvasGraphics ptr, AstralCanvasComputeBuffer drawDataBuffer, usize drawDataBufferOffset, AstralCanvasComputeBuffer drawCountBuffer, usize drawCountBufferOffset, u32 maxDrawCount);
     DynamicFunction void AstralCanvasGraphics_DrawIndexedPrimitivesIndirect(AstralCanvasGraphics ptr, AstralCanvasComputeBuffer drawDataBuffer, usize drawDataBufferOffset, u32 drawCount);
+    DynamicFunction void AstralCanvasGraphics_DispatchCompute(AstralCanvasGraphics ptr, AstralCanvasComputePipeline pipeline, u32 threadsX, u32 threadsY, u32 threadsZ);
     DynamicFunction void AstralCanvasGraphics_NextRenderPass(AstralCanvasGraphics ptr);
     DynamicFunction AstralCanvasClipArea AstralCanvasGraphics_GetClipArea(AstralCanvasGraphics ptr);
     DynamicFunction void AstralCanvasGraphics_SetClipArea(AstralCanvasGraphics ptr, i32 x, i32 y, i32 w, i32 h);
     DynamicFunction AstralCanvasClipArea AstralCanvasGraphics_GetViewport(AstralCanvasGraphics ptr);
     DynamicFunction void AstralCanvasGraphics_SetViewport(AstralCanvasGraphics ptr, i32 x, i32 y, i32 w, i32 h);
+    DynamicFunction AstralCanvasGraphicsSkippedCommands AstralCanvasGraphics_GetSkippedCommands(AstralCanvasGraphics ptr);
+    DynamicFunction void AstralCanvasGraphics_ResetSkippedCommands(AstralCanvasGraphics ptr);
 
 #ifdef __cplusplus
 }
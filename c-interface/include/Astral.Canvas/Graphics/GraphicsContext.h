@@ -0,0 +1,19 @@
+#pragma once
+#include "Linxc.h"
+#include "Astral.Canvas/Graphics/Graphics.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+    typedef void *AstralCanvasGraphicsContext;
+
+    DynamicFunction AstralCanvasGraphicsContext AstralCanvasGraphicsContext_Create();
+    DynamicFunction void AstralCanvasGraphicsContext_Deinit(AstralCanvasGraphicsContext ptr);
+    DynamicFunction AstralCanvasGraphics AstralCanvasGraphicsContext_GetGraphics(AstralCanvasGraphicsContext ptr);
+    DynamicFunction bool AstralCanvasGraphicsContext_Begin(AstralCanvasGraphicsContext ptr, AstralCanvasGraphics parent, u32 order);
+    DynamicFunction void AstralCanvasGraphicsContext_End(AstralCanvasGraphicsContext ptr);
+
+#ifdef __cplusplus
+}
+#endif
@@ -10,7 +10,7 @@ extern "C"
 
     DynamicFunction usize AstralCanvasInstanceBuffer_GetInstanceSize(AstralCanvasInstanceBuffer ptr);
     DynamicFunction usize AstralCanvasInstanceBuffer_GetCount(AstralCanvasInstanceBuffer ptr);
-    DynamicFunction AstralCanvasInstanceBuffer AstralCanvasInstanceBuffer_Create(usize instanceSize, usize instanceCount, bool canRead);
+    DynamicFunction AstralCanvasInstanceBuffer AstralCanvasInstanceBuffer_Create(usize instanceSize, usize instanceCount, bool canRead, bool isDynamic);
     DynamicFunction void AstralCanvasInstanceBuffer_Deinit(AstralCanvasInstanceBuffer ptr);
     DynamicFunction void AstralCanvasInstanceBuffer_SetData(AstralCanvasInstanceBuffer ptr, void* instanceData, usize instanceCount);
 #ifdef __cplusplus
@@ -0,0 +1,44 @@
+#pragma once
+#include "Linxc.h"
+#include "Astral.Canvas/Graphics/Enums.h"
+
+#define ASTRALCANVAS_MAX_MEMORY_HEAPS 16
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    def_delegate(AstralCanvas_GPUMemoryBudgetCallback, void, u32 heapIndex, u64 usage, u64 softBudget);
+
+    typedef struct
+    {
+        u64 usage;
+        u64 budget;
+        u64 peakUsage;
+        u64 allocationBytes;
+        u32 allocationCount;
+        bool deviceLocal;
+    } AstralCanvasGPUMemoryHeapStatistics;
+
+    typedef struct
+    {
+        u32 allocationCount;
+        u64 bytes;
+        u64 peakBytes;
+    } AstralCanvasGPUMemoryKindStatistics;
+
+    typedef struct
+    {
+        u32 heapCount;
+        AstralCanvasGPUMemoryHeapStatistics heaps[ASTRALCANVAS_MAX_MEMORY_HEAPS];
+        AstralCanvasGPUMemoryKindStatistics kinds[AstralCanvas_GPUMemoryKind_Count];
+    } AstralCanvasGPUMemoryStatistics;
+
+    DynamicFunction bool AstralCanvas_GetGPUMemoryStatistics(AstralCanvasGPUMemoryStatistics *result);
+    DynamicFunction void AstralCanvas_ResetGPUMemoryPeaks();
+    DynamicFunction void AstralCanvas_SetGPUMemorySoftBudget(float budgetFraction, AstralCanvas_GPUMemoryBudgetCallback callback);
+
+#ifdef __cplusplus
+}
+#endif
@@ -2,6 +2,7 @@
 #include "Linxc.h"
 #include "Astral.Canvas/Graphics/Shader.h"
 #include "Astral.Canvas/Graphics/VertexDeclaration.h"
+#include "Astral.Canvas/Graphics/RenderProgram.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -23,6 +24,14 @@ extern "C"
     #define OPAQUE_BLEND AstralCanvasBlendState{AstralCanvas_Blend_One, AstralCanvas_Blend_One, AstralCanvas_Blend_Zero, AstralCanvas_Blend_Zero}
 
     typedef void *AstralCanvasRenderPipeline;
+    typedef void *AstralCanvasRenderPipelinePrewarm;
+
+    typedef struct
+    {
+        AstralCanvasRenderPipeline pipeline;
+        AstralCanvasRenderProgram renderProgram;
+        u32 renderPass;
+    } AstralCanvasRenderPipelinePrewarmEntry;
 
     DynamicFunction void *AstralCanvasRenderPipeline_GetLayout(AstralCanvasRenderPipeline ptr);
     DynamicFunction AstralCanvasShader AstralCanvasRenderPipeline_GetShader(AstralCanvasRenderPipeline ptr);
@@ -32,6 +41,7 @@ extern "C"
     DynamicFunction bool AstralCanvasRenderPipeline_IsDepthWrite(AstralCanvasRenderPipeline ptr);
     DynamicFunction bool AstralCanvasRenderPipeline_IsDepthTest(AstralCanvasRenderPipeline ptr);
     DynamicFunction void AstralCanvasRenderPipeline_Deinit(AstralCanvasRenderPipeline ptr);
+    DynamicFunction bool AstralCanvasRenderPipeline_IsReadyFor(AstralCanvasRenderPipeline ptr, AstralCanvasRenderProgram renderProgram, u32 renderPass);
     DynamicFunction AstralCanvasRenderPipeline AstralCanvasRenderPipeline_Init(
         AstralCanvasShader pipelineShader, 
         AstralCanvas_CullMode pipelineCullMode, 
@@ -42,6 +52,12 @@ extern "C"
         AstralCanvasVertexDeclaration* vertexDeclarations,
         usize vertexDeclarationCount);
 
+    DynamicFunction AstralCanvasRenderPipelinePrewarm AstralCanvasRenderPipelinePrewarm_Start(AstralCanvasRenderPipelinePrewarmEntry *entries, usize entryCount, u32 threadCount);
+    DynamicFunction float AstralCanvasRenderPipelinePrewarm_GetProgress(AstralCanvasRenderPipelinePrewarm ptr);
+    DynamicFunction bool AstralCanvasRenderPipelinePrewarm_IsComplete(AstralCanvasRenderPipelinePrewarm ptr);
+    DynamicFunction void AstralCanvasRenderPipelinePrewarm_Await(AstralCanvasRenderPipelinePrewarm ptr);
+    DynamicFunction void AstralCanvasRenderPipelinePrewarm_Deinit(AstralCanvasRenderPipelinePrewarm ptr);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
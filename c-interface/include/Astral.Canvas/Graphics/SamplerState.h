@@ -11,6 +11,7 @@ extern "C"
 
     DynamicFunction AstralCanvasSamplerState AstralCanvasSamplerState_Init(AstralCanvas_SampleMode thisSampleMode, AstralCanvas_RepeatMode thisRepeatMode, bool isAnisotropic, float thisAnisotropyLevel);
     DynamicFunction void AstralCanvasSamplerState_Deinit(AstralCanvasSamplerState ptr);
+    DynamicFunction u32 AstralCanvasSamplerState_GetBindlessIndex(AstralCanvasSamplerState ptr);
 
 #ifdef __cplusplus
 }
@@ -11,6 +11,12 @@ extern "C"
 #endif
     typedef void *AstralCanvasShaderVariable;
     typedef void *AstralCanvasShader;
+    /// Resolved once with AstralCanvasShader_GetVariableHandle, then passed to the ByHandle setters to skip the name lookup
+    typedef struct
+    {
+        i32 binding;
+        AstralCanvas_ShaderResourceType type;
+    } AstralCanvasShaderVariableHandle;
 
     typedef struct
     {
@@ -52,6 +58,14 @@ extern "C"
     DynamicFunction void AstralCanvasShader_SetShaderVariableSamplers(AstralCanvasShader ptr, const char* variableName, AstralCanvasSamplerState *samplers, usize count);
     DynamicFunction void AstralCanvasShader_SetShaderVariableComputeBuffer(AstralCanvasShader ptr, const char* variableName, AstralCanvasComputeBuffer computeBuffer);
 
+    DynamicFunction AstralCanvasShaderVariableHandle AstralCanvasShader_GetVariableHandle(AstralCanvasShader ptr, const char* variableName);
+    DynamicFunction void AstralCanvasShader_SetShaderVariableByHandle(AstralCanvasShader ptr, AstralCanvasShaderVariableHandle handle, void* varPtr, usize size);
+    DynamicFunction void AstralCanvasShader_SetShaderVariableTextureByHandle(AstralCanvasShader ptr, AstralCanvasShaderVariableHandle handle, AstralCanvasTexture2D texture);
+    DynamicFunction void AstralCanvasShader_SetShaderVariableTexturesByHandle(AstralCanvasShader ptr, AstralCanvasShaderVariableHandle handle, AstralCanvasTexture2D *textures, usize count);
+    DynamicFunction void AstralCanvasShader_SetShaderVariableSamplerByHandle(AstralCanvasShader ptr, AstralCanvasShaderVariableHandle handle, AstralCanvasSamplerState sampler);
+    DynamicFunction void AstralCanvasShader_SetShaderVariableSamplersByHandle(AstralCanvasShader ptr, AstralCanvasShaderVariableHandle handle, AstralCanvasSamplerState *samplers, usize count);
+    DynamicFunction void AstralCanvasShader_SetShaderVariableComputeBufferByHandle(AstralCanvasShader ptr, AstralCanvasShaderVariableHandle handle, AstralCanvasComputeBuffer computeBuffer);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
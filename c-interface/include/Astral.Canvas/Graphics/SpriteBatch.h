@@ -0,0 +1,29 @@
+#pragma once
+#include "Linxc.h"
+#include "Astral.Canvas/Window.h"
+#include "Astral.Canvas/Graphics/Enums.h"
+#include "Astral.Canvas/Graphics/Color.h"
+#include "Astral.Canvas/Graphics/Shader.h"
+#include "Astral.Canvas/Graphics/Texture2D.h"
+#include "Astral.Canvas/Graphics/SamplerState.h"
+#include "Astral.Canvas/Graphics/RenderPipeline.h"
+#include "Astral.Canvas/Graphics/Graphics.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    typedef void *AstralCanvasSpriteBatch;
+    DynamicFunction AstralCanvasSpriteBatch AstralCanvasSpriteBatch_Create(AstralCanvasShader spriteShader, AstralCanvasBlendState blendState, usize initialCapacity);
+    DynamicFunction void AstralCanvasSpriteBatch_Deinit(AstralCanvasSpriteBatch ptr);
+    /// transform is 16 floats, laid out the same as Maths::Matrix4x4
+    DynamicFunction void AstralCanvasSpriteBatch_Begin(AstralCanvasSpriteBatch ptr, AstralCanvas_SpriteSortMode sortMode, float *transform, AstralCanvasSamplerState sampler);
+    DynamicFunction void AstralCanvasSpriteBatch_Draw(AstralCanvasSpriteBatch ptr, AstralCanvasTexture2D texture, float positionX, float positionY, AstralCanvasColor color);
+    /// sourceRectangle may be NULL to draw the whole texture
+    DynamicFunction void AstralCanvasSpriteBatch_DrawEx(AstralCanvasSpriteBatch ptr, AstralCanvasTexture2D texture, float positionX, float positionY, AstralCanvasRectangle *sourceRectangle, AstralCanvasColor color, float rotation, float originX, float originY, float scaleX, float scaleY, float depth);
+    DynamicFunction void AstralCanvasSpriteBatch_End(AstralCanvasSpriteBatch ptr, AstralCanvasGraphics graphics);
+
+#ifdef __cplusplus
+}
+#endif
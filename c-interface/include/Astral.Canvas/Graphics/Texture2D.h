@@ -22,6 +22,7 @@ extern "C"
     DynamicFunction bool AstralCanvasTexture2D_UsedForRenderTarget(AstralCanvasTexture2D ptr);
     DynamicFunction void *AstralCanvasTexture2D_GetImageHandle(AstralCanvasTexture2D ptr);
     DynamicFunction void *AstralCanvasTexture2D_GetImageView(AstralCanvasTexture2D ptr);
+    DynamicFunction u32 AstralCanvasTexture2D_GetBindlessIndex(AstralCanvasTexture2D ptr);
     DynamicFunction void AstralCanvasTexture2D_Deinit(AstralCanvasTexture2D ptr);
     DynamicFunction AstralCanvasTexture2D AstralCanvasTexture2D_FromHandle(void *handle, u32 width, u32 height, AstralCanvas_ImageFormat imageFormat, bool usedForRenderTarget);
     DynamicFunction AstralCanvasTexture2D AstralCanvasTexture2D_FromData(u8* data, u32 width, u32 height, AstralCanvas_ImageFormat imageFormat, bool usedForRenderTarget, bool storeData);
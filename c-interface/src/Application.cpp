@@ -22,6 +22,41 @@ void AstralCanvasApplication_SetFramesPerSecond(AstralCanvasApplication ptr, flo
     ((AstralCanvas::Application *)ptr)->framesPerSecond = frames;
 }
 exportC 
+u32 AstralCanvasApplication_GetFramesInFlight(AstralCanvasApplication ptr)
+{
+    return ((AstralCanvas::Application *)ptr)->framesInFlight;
+}
+exportC 
+void AstralCanvasApplication_SetFramesInFlight(AstralCanvasApplication ptr, u32 frames)
+{
+    ((AstralCanvas::Application *)ptr)->framesInFlight = frames;
+}
+exportC 
+bool AstralCanvasApplication_GetUseDynamicRendering(AstralCanvasApplication ptr)
+{
+    return ((AstralCanvas::Application *)ptr)->useDynamicRendering;
+}
+exportC 
+void AstralCanvasApplication_SetUseDynamicRendering(AstralCanvasApplication ptr, bool value)
+{
+    ((AstralCanvas::Application *)ptr)->useDynamicRendering = value;
+}
+exportC 
+const char *AstralCanvasApplication_GetPipelineCachePath(AstralCanvasApplication ptr)
+{
+    return ((AstralCanvas::Application *)ptr)->pipelineCachePath;
+}
+exportC 
+void AstralCanvasApplication_SetPipelineCachePath(AstralCanvasApplication ptr, const char *path)
+{
+    ((AstralCanvas::Application *)ptr)->pipelineCachePath = path;
+}
+exportC 
+bool AstralCanvasApplication_SavePipelineCache(AstralCanvasApplication ptr)
+{
+    return ((AstralCanvas::Application *)ptr)->SavePipelineCache();
+}
+exportC 
 void AstralCanvasApplication_AddWindow(AstralCanvasApplication ptr, const char *name, i32 width, i32 height, bool resizeable, void *iconData, u32 iconWidth, u32 iconHeight)
 {
     ((AstralCanvas::Application *)ptr)->AddWindow(name, width, height, resizeable, iconData, iconWidth, iconHeight);
@@ -0,0 +1,33 @@
+#include "Astral.Canvas/Graphics/GPUCulling.h"
+#include "Graphics/GPUCulling.hpp"
+#include <string.h>
+
+exportC AstralCanvasGPUCullingPass AstralCanvasGPUCullingPass_Create(AstralCanvasShader cullingShader, u32 maxDraws)
+{
+    AstralCanvas::GPUCullingPass* result = (AstralCanvas::GPUCullingPass*)malloc(sizeof(AstralCanvas::GPUCullingPass));
+    *result = AstralCanvas::GPUCullingPass((AstralCanvas::Shader*)cullingShader, maxDraws);
+    return (AstralCanvasGPUCullingPass)result;
+}
+exportC void AstralCanvasGPUCullingPass_Deinit(AstralCanvasGPUCullingPass ptr)
+{
+    ((AstralCanvas::GPUCullingPass *)ptr)->deinit();
+    free(ptr);
+}
+exportC void AstralCanvasGPUCullingPass_Cull(AstralCanvasGPUCullingPass ptr, AstralCanvasGraphics graphics, AstralCanvasComputeBuffer instances, u32 instanceCount, AstralCanvasComputeBuffer drawRecords, float *viewProjection)
+{
+    Maths::Matrix4x4 matrix;
+    memcpy(&matrix.M11, viewProjection, sizeof(float) * 16);
+    ((AstralCanvas::GPUCullingPass *)ptr)->Cull((AstralCanvas::Graphics *)graphics, (AstralCanvas::ComputeBuffer *)instances, instanceCount, (AstralCanvas::ComputeBuffer *)drawRecords, matrix);
+}
+exportC void AstralCanvasGPUCullingPass_Draw(AstralCanvasGPUCullingPass ptr, AstralCanvasGraphics graphics)
+{
+    ((AstralCanvas::GPUCullingPass *)ptr)->Draw((AstralCanvas::Graphics *)graphics);
+}
+exportC AstralCanvasComputeBuffer AstralCanvasGPUCullingPass_GetDrawCommands(AstralCanvasGPUCullingPass ptr)
+{
+    return (AstralCanvasComputeBuffer)((AstralCanvas::GPUCullingPass *)ptr)->GetDrawCommands();
+}
+exportC AstralCanvasComputeBuffer AstralCanvasGPUCullingPass_GetDrawCount(AstralCanvasGPUCullingPass ptr)
+{
+    return (AstralCanvasComputeBuffer)((AstralCanvas::GPUCullingPass *)ptr)->GetDrawCount();
+}
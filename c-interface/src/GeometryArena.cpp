@@ -0,0 +1,37 @@
+#include "Astral.Canvas/Graphics/GeometryArena.h"
+#include "Graphics/GeometryArena.hpp"
+
+inline AstralCanvas::GeometryHandle AstralCanvasGeometryHandle_ToHandle(AstralCanvasGeometryHandle handle)
+{
+    return AstralCanvas::GeometryHandle{(const AstralCanvas::VertexBuffer *)handle.vertexBuffer, (const AstralCanvas::IndexBuffer *)handle.indexBuffer, handle.vertexOffset, handle.vertexCount, handle.firstIndex, handle.indexCount};
+}
+
+exportC AstralCanvasGeometryArena AstralCanvasGeometryArena_Create(AstralCanvasVertexDeclaration vertexType, usize vertexCapacity, AstralCanvas_IndexBufferSize indexElementSize, usize indexCapacity)
+{
+    AstralCanvas::GeometryArena *result = (AstralCanvas::GeometryArena *)GetCAllocator().Allocate(sizeof(AstralCanvas::GeometryArena));
+    *result = AstralCanvas::GeometryArena(GetCAllocator(), (AstralCanvas::VertexDeclaration *)vertexType, vertexCapacity, (AstralCanvas::IndexBufferSize)indexElementSize, indexCapacity);
+    return (AstralCanvasGeometryArena)result;
+}
+exportC void AstralCanvasGeometryArena_Deinit(AstralCanvasGeometryArena ptr)
+{
+    ((AstralCanvas::GeometryArena *)ptr)->deinit();
+    GetCAllocator().Free(ptr);
+}
+exportC AstralCanvasGeometryHandle AstralCanvasGeometryArena_Allocate(AstralCanvasGeometryArena ptr, void *vertexData, u32 vertexCount, u8 *indexData, u32 indexCount)
+{
+    AstralCanvas::GeometryHandle handle = ((AstralCanvas::GeometryArena *)ptr)->Allocate(vertexData, vertexCount, indexData, indexCount);
+    AstralCanvasGeometryHandle result = {(AstralCanvasVertexBuffer)handle.vertexBuffer, (AstralCanvasIndexBuffer)handle.indexBuffer, handle.vertexOffset, handle.vertexCount, handle.firstIndex, handle.indexCount};
+    return result;
+}
+exportC void AstralCanvasGeometryArena_Free(AstralCanvasGeometryArena ptr, AstralCanvasGeometryHandle handle)
+{
+    ((AstralCanvas::GeometryArena *)ptr)->Free(AstralCanvasGeometryHandle_ToHandle(handle));
+}
+exportC void AstralCanvasGeometryArena_Bind(AstralCanvasGeometryArena ptr, AstralCanvasGraphics graphics, u32 bindingPoint)
+{
+    ((AstralCanvas::GeometryArena *)ptr)->Bind((AstralCanvas::Graphics *)graphics, bindingPoint);
+}
+exportC void AstralCanvasGeometryArena_Draw(AstralCanvasGeometryArena ptr, AstralCanvasGraphics graphics, AstralCanvasGeometryHandle handle, u32 instanceCount, u32 firstInstance)
+{
+    ((AstralCanvas::GeometryArena *)ptr)->Draw((AstralCanvas::Graphics *)graphics, AstralCanvasGeometryHandle_ToHandle(handle), instanceCount, firstInstance);
+}
@@ -1,5 +1,14 @@
 #include "Astral.Canvas/Graphics/Graphics.h"
 #include "Graphics/Graphics.hpp"
+#include "Graphics/Compute.hpp"
+
+inline AstralCanvas::ShaderVariableHandle AstralCanvasShaderVariableHandle_ToHandle(AstralCanvasShaderVariableHandle handle)
+{
+    AstralCanvas::ShaderVariableHandle result;
+    result.binding = handle.binding;
+    result.type = (AstralCanvas::ShaderResourceType)handle.type;
+    return result;
+}
 
 exportC AstralCanvasRenderProgram AstralCanvasGraphics_GetCurrentRenderProgram(AstralCanvasGraphics ptr)
 {
@@ -37,6 +46,10 @@ exportC void AstralCanvasGraphics_StartRenderProgram(AstralCanvasGraphics ptr, A
 {
     ((AstralCanvas::Graphics *)ptr)->StartRenderProgram((AstralCanvas::RenderProgram*)program, AstralCanvas::Color(clearColor.R, clearColor.G, clearColor.B, clearColor.A));
 }
+exportC void AstralCanvasGraphics_StartRenderProgramForContexts(AstralCanvasGraphics ptr, AstralCanvasRenderProgram program, AstralCanvasColor clearColor)
+{
+    ((AstralCanvas::Graphics *)ptr)->StartRenderProgram((AstralCanvas::RenderProgram*)program, AstralCanvas::Color(clearColor.R, clearColor.G, clearColor.B, clearColor.A), true);
+}
 exportC void AstralCanvasGraphics_EndRenderProgram(AstralCanvasGraphics ptr)
 {
     ((AstralCanvas::Graphics *)ptr)->EndRenderProgram();
@@ -73,6 +86,42 @@ exportC void AstralCanvasGraphics_SetShaderVariableComputeBuffer(AstralCanvasGra
 {
     ((AstralCanvas::Graphics *)ptr)->SetShaderVariableComputeBuffer(variableName, (AstralCanvas::ComputeBuffer*)computeBuffer);
 }
+exportC void AstralCanvasGraphics_SetShaderVariableByHandle(AstralCanvasGraphics ptr, AstralCanvasShaderVariableHandle handle, void* data, usize size)
+{
+    ((AstralCanvas::Graphics *)ptr)->SetShaderVariable(AstralCanvasShaderVariableHandle_ToHandle(handle), data, size);
+}
+exportC void AstralCanvasGraphics_SetShaderVariableTextureByHandle(AstralCanvasGraphics ptr, AstralCanvasShaderVariableHandle handle, AstralCanvasTexture2D texture)
+{
+    ((AstralCanvas::Graphics *)ptr)->SetShaderVariableTexture(AstralCanvasShaderVariableHandle_ToHandle(handle), (AstralCanvas::Texture2D*)texture);
+}
+exportC void AstralCanvasGraphics_SetShaderVariableTexturesByHandle(AstralCanvasGraphics ptr, AstralCanvasShaderVariableHandle handle, AstralCanvasTexture2D *textures, usize count)
+{
+    ((AstralCanvas::Graphics *)ptr)->SetShaderVariableTextures(AstralCanvasShaderVariableHandle_ToHandle(handle), (AstralCanvas::Texture2D**)textures, count);
+}
+exportC void AstralCanvasGraphics_SetShaderVariableSamplerByHandle(AstralCanvasGraphics ptr, AstralCanvasShaderVariableHandle handle, AstralCanvasSamplerState sampler)
+{
+    ((AstralCanvas::Graphics *)ptr)->SetShaderVariableSampler(AstralCanvasShaderVariableHandle_ToHandle(handle), (AstralCanvas::SamplerState*)sampler);
+}
+exportC void AstralCanvasGraphics_SetShaderVariableSamplersByHandle(AstralCanvasGraphics ptr, AstralCanvasShaderVariableHandle handle, AstralCanvasSamplerState *samplers, usize count)
+{
+    ((AstralCanvas::Graphics *)ptr)->SetShaderVariableSamplers(AstralCanvasShaderVariableHandle_ToHandle(handle), (AstralCanvas::SamplerState**)samplers, count);
+}
+exportC void AstralCanvasGraphics_SetShaderVariableComputeBufferByHandle(AstralCanvasGraphics ptr, AstralCanvasShaderVariableHandle handle, AstralCanvasComputeBuffer computeBuffer)
+{
+    ((AstralCanvas::Graphics *)ptr)->SetShaderVariableComputeBuffer(AstralCanvasShaderVariableHandle_ToHandle(handle), (AstralCanvas::ComputeBuffer*)computeBuffer);
+}
+exportC void AstralCanvasGraphics_SetPushConstants(AstralCanvasGraphics ptr, void *data, u32 size, u32 offset)
+{
+    ((AstralCanvas::Graphics *)ptr)->SetPushConstants(data, size, offset);
+}
+exportC void AstralCanvasGraphics_SetDrawMerging(AstralCanvasGraphics ptr, bool enabled)
+{
+    ((AstralCanvas::Graphics *)ptr)->SetDrawMerging(enabled);
+}
+exportC void AstralCanvasGraphics_FlushMergedDraws(AstralCanvasGraphics ptr)
+{
+    ((AstralCanvas::Graphics *)ptr)->FlushMergedDraws();
+}
 exportC void AstralCanvasGraphics_SendUpdatedUniforms(AstralCanvasGraphics ptr)
 {
     ((AstralCanvas::Graphics *)ptr)->SendUpdatedUniforms();
@@ -89,6 +138,10 @@ exportC void AstralCanvasGraphics_DrawIndexedPrimitivesIndirect(AstralCanvasGrap
 {
     ((AstralCanvas::Graphics *)ptr)->DrawIndexedPrimitivesIndirect((AstralCanvas::ComputeBuffer*)drawDataBuffer, drawDataBufferOffset, drawCount);
 }
+exportC void AstralCanvasGraphics_DispatchCompute(AstralCanvasGraphics ptr, AstralCanvasComputePipeline pipeline, u32 threadsX, u32 threadsY, u32 threadsZ)
+{
+    ((AstralCanvas::Graphics *)ptr)->DispatchCompute((AstralCanvas::ComputePipeline *)pipeline, threadsX, threadsY, threadsZ);
+}
 exportC void AstralCanvasGraphics_NextRenderPass(AstralCanvasGraphics ptr)
 {
     ((AstralCanvas::Graphics *)ptr)->NextRenderPass();
@@ -110,4 +163,13 @@ exportC AstralCanvasClipArea AstralCanvasGraphics_GetViewport(AstralCanvasGraphi
 exportC void AstralCanvasGraphics_SetViewport(AstralCanvasGraphics ptr, i32 x, i32 y, i32 w, i32 h)
 {
     ((AstralCanvas::Graphics *)ptr)->Viewport = {x, y, w, h};
-}
\ No newline at end of file
+}
+exportC AstralCanvasGraphicsSkippedCommands AstralCanvasGraphics_GetSkippedCommands(AstralCanvasGraphics ptr)
+{
+    AstralCanvas::GraphicsSkippedCommands skipped = ((AstralCanvas::Graphics *)ptr)->skippedCommands;
+    return {skipped.pipelineBinds, skipped.vertexBufferBinds, skipped.indexBufferBinds, skipped.viewports, skipped.scissors, skipped.descriptorSetBinds};
+}
+exportC void AstralCanvasGraphics_ResetSkippedCommands(AstralCanvasGraphics ptr)
+{
+    ((AstralCanvas::Graphics *)ptr)->ResetSkippedCommands();
+}
@@ -0,0 +1,26 @@
+#include "Astral.Canvas/Graphics/GraphicsContext.h"
+#include "Graphics/GraphicsContext.hpp"
+
+exportC AstralCanvasGraphicsContext AstralCanvasGraphicsContext_Create()
+{
+    AstralCanvas::GraphicsContext *result = (AstralCanvas::GraphicsContext *)GetCAllocator().Allocate(sizeof(AstralCanvas::GraphicsContext));
+    *result = AstralCanvas::GraphicsContext(GetCAllocator());
+    return result;
+}
+exportC void AstralCanvasGraphicsContext_Deinit(AstralCanvasGraphicsContext ptr)
+{
+    ((AstralCanvas::GraphicsContext *)ptr)->deinit();
+    GetCAllocator().Free(ptr);
+}
+exportC AstralCanvasGraphics AstralCanvasGraphicsContext_GetGraphics(AstralCanvasGraphicsContext ptr)
+{
+    return &((AstralCanvas::GraphicsContext *)ptr)->graphics;
+}
+exportC bool AstralCanvasGraphicsContext_Begin(AstralCanvasGraphicsContext ptr, AstralCanvasGraphics parent, u32 order)
+{
+    return ((AstralCanvas::GraphicsContext *)ptr)->Begin((AstralCanvas::Graphics *)parent, order);
+}
+exportC void AstralCanvasGraphicsContext_End(AstralCanvasGraphicsContext ptr)
+{
+    ((AstralCanvas::GraphicsContext *)ptr)->End();
+}
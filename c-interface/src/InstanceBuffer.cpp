@@ -9,10 +9,10 @@ exportC usize AstralCanvasInstanceBuffer_GetCount(AstralCanvasInstanceBuffer ptr
 {
     return ((AstralCanvas::InstanceBuffer *)ptr)->instanceCount;
 }
-exportC AstralCanvasInstanceBuffer AstralCanvasInstanceBuffer_Create(usize instanceSize, usize instanceCount, bool canRead)
+exportC AstralCanvasInstanceBuffer AstralCanvasInstanceBuffer_Create(usize instanceSize, usize instanceCount, bool canRead, bool isDynamic)
 {
     AstralCanvas::InstanceBuffer *result = (AstralCanvas::InstanceBuffer *)GetCAllocator().Allocate(sizeof(AstralCanvas::InstanceBuffer));
-    *result = AstralCanvas::InstanceBuffer(instanceSize, instanceCount, canRead);
+    *result = AstralCanvas::InstanceBuffer(instanceSize, instanceCount, canRead, isDynamic);
     return result;
 }
 exportC void AstralCanvasInstanceBuffer_Deinit(AstralCanvasInstanceBuffer ptr)
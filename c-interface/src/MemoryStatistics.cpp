@@ -0,0 +1,34 @@
+#include "Astral.Canvas/Graphics/MemoryStatistics.h"
+#include "Graphics/MemoryStatistics.hpp"
+
+exportC bool AstralCanvas_GetGPUMemoryStatistics(AstralCanvasGPUMemoryStatistics *result)
+{
+    AstralCanvas::GPUMemoryStatistics statistics;
+    bool success = AstralCanvas::GetGPUMemoryStatistics(&statistics);
+
+    result->heapCount = statistics.heapCount;
+    for (u32 i = 0; i < ASTRALCANVAS_MAX_MEMORY_HEAPS; i++)
+    {
+        result->heaps[i].usage = statistics.heaps[i].usage;
+        result->heaps[i].budget = statistics.heaps[i].budget;
+        result->heaps[i].peakUsage = statistics.heaps[i].peakUsage;
+        result->heaps[i].allocationBytes = statistics.heaps[i].allocationBytes;
+        result->heaps[i].allocationCount = statistics.heaps[i].allocationCount;
+        result->heaps[i].deviceLocal = statistics.heaps[i].deviceLocal;
+    }
+    for (u32 i = 0; i < AstralCanvas::GPUMemoryKind_Count; i++)
+    {
+        result->kinds[i].allocationCount = statistics.kinds[i].allocationCount;
+        result->kinds[i].bytes = statistics.kinds[i].bytes;
+        result->kinds[i].peakBytes = statistics.kinds[i].peakBytes;
+    }
+    return success;
+}
+exportC void AstralCanvas_ResetGPUMemoryPeaks()
+{
+    AstralCanvas::ResetGPUMemoryPeaks();
+}
+exportC void AstralCanvas_SetGPUMemorySoftBudget(float budgetFraction, AstralCanvas_GPUMemoryBudgetCallback callback)
+{
+    AstralCanvas::SetGPUMemorySoftBudget(budgetFraction, (AstralCanvas::GPUMemoryBudgetCallback)callback);
+}
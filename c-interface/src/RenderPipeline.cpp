@@ -39,6 +39,10 @@ exportC void AstralCanvasRenderPipeline_Deinit(AstralCanvasRenderPipeline ptr)
 {
     ((AstralCanvas::RenderPipeline *)ptr)->deinit();
 }
+exportC bool AstralCanvasRenderPipeline_IsReadyFor(AstralCanvasRenderPipeline ptr, AstralCanvasRenderProgram renderProgram, u32 renderPass)
+{
+    return ((AstralCanvas::RenderPipeline *)ptr)->TryGetFor((AstralCanvas::RenderProgram *)renderProgram, renderPass) != NULL;
+}
 
 exportC AstralCanvasRenderPipeline AstralCanvasRenderPipeline_Init(
     AstralCanvasShader pipelineShader, 
@@ -65,4 +69,29 @@ exportC AstralCanvasRenderPipeline AstralCanvasRenderPipeline_Init(
 
     *result = AstralCanvas::RenderPipeline(GetCAllocator(), (AstralCanvas::Shader *)pipelineShader, (AstralCanvas::CullMode)pipelineCullMode, (AstralCanvas::PrimitiveType)pipelinePrimitiveType, blendState, testDepth, writeToDepth, vertexDecls);
     return result;
-}
\ No newline at end of file
+}
+
+exportC AstralCanvasRenderPipelinePrewarm AstralCanvasRenderPipelinePrewarm_Start(AstralCanvasRenderPipelinePrewarmEntry *entries, usize entryCount, u32 threadCount)
+{
+    AstralCanvas::RenderPipelinePrewarm *result = (AstralCanvas::RenderPipelinePrewarm *)GetCAllocator().Allocate(sizeof(AstralCanvas::RenderPipelinePrewarm));
+    *result = AstralCanvas::RenderPipelinePrewarm(GetCAllocator(), (AstralCanvas::RenderPipelinePrewarmEntry *)entries, entryCount);
+    result->Start(threadCount);
+    return result;
+}
+exportC float AstralCanvasRenderPipelinePrewarm_GetProgress(AstralCanvasRenderPipelinePrewarm ptr)
+{
+    return ((AstralCanvas::RenderPipelinePrewarm *)ptr)->GetProgress();
+}
+exportC bool AstralCanvasRenderPipelinePrewarm_IsComplete(AstralCanvasRenderPipelinePrewarm ptr)
+{
+    return ((AstralCanvas::RenderPipelinePrewarm *)ptr)->IsComplete();
+}
+exportC void AstralCanvasRenderPipelinePrewarm_Await(AstralCanvasRenderPipelinePrewarm ptr)
+{
+    ((AstralCanvas::RenderPipelinePrewarm *)ptr)->Await();
+}
+exportC void AstralCanvasRenderPipelinePrewarm_Deinit(AstralCanvasRenderPipelinePrewarm ptr)
+{
+    ((AstralCanvas::RenderPipelinePrewarm *)ptr)->deinit();
+    GetCAllocator().Free(ptr);
+}
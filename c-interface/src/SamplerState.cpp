@@ -13,6 +13,10 @@ exportC void AstralCanvasSamplerState_Deinit(AstralCanvasSamplerState ptr)
     ((AstralCanvas::SamplerState *)ptr)->deinit();
     GetCAllocator().Free(ptr);
 }
+exportC u32 AstralCanvasSamplerState_GetBindlessIndex(AstralCanvasSamplerState ptr)
+{
+    return ((AstralCanvas::SamplerState *)ptr)->bindlessIndex;
+}
 
 /*exportC AstralCanvasSamplerState AstralCanvasSampler_GetPointClamp()
 {
@@ -1,6 +1,14 @@
 #include "Astral.Canvas/Graphics/Shader.h"
 #include "Graphics/Shader.hpp"
 
+inline AstralCanvas::ShaderVariableHandle AstralCanvasShaderVariableHandle_ToHandle(AstralCanvasShaderVariableHandle handle)
+{
+    AstralCanvas::ShaderVariableHandle result;
+    result.binding = handle.binding;
+    result.type = (AstralCanvas::ShaderResourceType)handle.type;
+    return result;
+}
+
 exportC void AstralCanvasExportedMaterial_Deinit(AstralCanvasExportedMaterial material)
 {
     free(material.params);
@@ -149,4 +157,36 @@ exportC void AstralCanvasShader_SetShaderVariableSamplers(AstralCanvasShader ptr
 exportC void AstralCanvasShader_SetShaderVariableComputeBuffer(AstralCanvasShader ptr, const char* variableName, AstralCanvasComputeBuffer computeBuffer)
 {
     ((AstralCanvas::Shader *)ptr)->SetShaderVariableComputeBuffer(variableName, (AstralCanvas::ComputeBuffer*)computeBuffer);
+}
+exportC AstralCanvasShaderVariableHandle AstralCanvasShader_GetVariableHandle(AstralCanvasShader ptr, const char* variableName)
+{
+    AstralCanvas::ShaderVariableHandle handle = ((AstralCanvas::Shader *)ptr)->GetVariableHandle(variableName);
+    AstralCanvasShaderVariableHandle result;
+    result.binding = handle.binding;
+    result.type = (AstralCanvas_ShaderResourceType)handle.type;
+    return result;
+}
+exportC void AstralCanvasShader_SetShaderVariableByHandle(AstralCanvasShader ptr, AstralCanvasShaderVariableHandle handle, void* varPtr, usize size)
+{
+    ((AstralCanvas::Shader *)ptr)->SetShaderVariable(AstralCanvasShaderVariableHandle_ToHandle(handle), varPtr, size);
+}
+exportC void AstralCanvasShader_SetShaderVariableTextureByHandle(AstralCanvasShader ptr, AstralCanvasShaderVariableHandle handle, AstralCanvasTexture2D texture)
+{
+    ((AstralCanvas::Shader *)ptr)->SetShaderVariableTexture(AstralCanvasShaderVariableHandle_ToHandle(handle), (AstralCanvas::Texture2D*)texture);
+}
+exportC void AstralCanvasShader_SetShaderVariableTexturesByHandle(AstralCanvasShader ptr, AstralCanvasShaderVariableHandle handle, AstralCanvasTexture2D *textures, usize count)
+{
+    ((AstralCanvas::Shader *)ptr)->SetShaderVariableTextures(AstralCanvasShaderVariableHandle_ToHandle(handle), (AstralCanvas::Texture2D**)textures, count);
+}
+exportC void AstralCanvasShader_SetShaderVariableSamplerByHandle(AstralCanvasShader ptr, AstralCanvasShaderVariableHandle handle, AstralCanvasSamplerState sampler)
+{
+    ((AstralCanvas::Shader *)ptr)->SetShaderVariableSampler(AstralCanvasShaderVariableHandle_ToHandle(handle), (AstralCanvas::SamplerState*)sampler);
+}
+exportC void AstralCanvasShader_SetShaderVariableSamplersByHandle(AstralCanvasShader ptr, AstralCanvasShaderVariableHandle handle, AstralCanvasSamplerState *samplers, usize count)
+{
+    ((AstralCanvas::Shader *)ptr)->SetShaderVariableSamplers(AstralCanvasShaderVariableHandle_ToHandle(handle), (AstralCanvas::SamplerState**)samplers, count);
+}
+exportC void AstralCanvasShader_SetShaderVariableComputeBufferByHandle(AstralCanvasShader ptr, AstralCanvasShaderVariableHandle handle, AstralCanvasComputeBuffer computeBuffer)
+{
+    ((AstralCanvas::Shader *)ptr)->SetShaderVariableComputeBuffer(AstralCanvasShaderVariableHandle_ToHandle(handle), (AstralCanvas::ComputeBuffer*)computeBuffer);
 }
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "Astral.Canvas/Graphics/SpriteBatch.h"
+#include "Graphics/SpriteBatch.hpp"
+#include <string.h>
+
+exportC AstralCanvasSpriteBatch AstralCanvasSpriteBatch_Create(AstralCanvasShader spriteShader, AstralCanvasBlendState blendState, usize initialCapacity)
+{
+    AstralCanvas::SpriteBatch* result = (AstralCanvas::SpriteBatch*)GetCAllocator().Allocate(sizeof(AstralCanvas::SpriteBatch));
+    AstralCanvas::BlendState blend;
+    blend.sourceAlphaBlend = (AstralCanvas::Blend)blendState.srcAlpha;
+    blend.destinationAlphaBlend = (AstralCanvas::Blend)blendState.destAlpha;
+    blend.sourceColorBlend = (AstralCanvas::Blend)blendState.srcColor;
+    blend.destinationColorBlend = (AstralCanvas::Blend)blendState.destColor;
+
+    *result = AstralCanvas::SpriteBatch(GetCAllocator(), (AstralCanvas::Shader *)spriteShader, blend, initialCapacity);
+    return (AstralCanvasSpriteBatch)result;
+}
+exportC void AstralCanvasSpriteBatch_Deinit(AstralCanvasSpriteBatch ptr)
+{
+    ((AstralCanvas::SpriteBatch *)ptr)->deinit();
+    GetCAllocator().Free(ptr);
+}
+exportC void AstralCanvasSpriteBatch_Begin(AstralCanvasSpriteBatch ptr, AstralCanvas_SpriteSortMode sortMode, float *transform, AstralCanvasSamplerState sampler)
+{
+    Maths::Matrix4x4 matrix;
+    memcpy(&matrix.M11, transform, sizeof(float) * 16);
+    ((AstralCanvas::SpriteBatch *)ptr)->Begin((AstralCanvas::SpriteSortMode)sortMode, matrix, (AstralCanvas::SamplerState *)sampler);
+}
+exportC void AstralCanvasSpriteBatch_Draw(AstralCanvasSpriteBatch ptr, AstralCanvasTexture2D texture, float positionX, float positionY, AstralCanvasColor color)
+{
+    AstralCanvas::Color asColor;
+    asColor.packed = color.packed;
+    ((AstralCanvas::SpriteBatch *)ptr)->Draw((AstralCanvas::Texture2D *)texture, Maths::Vec2(positionX, positionY), asColor);
+}
+exportC void AstralCanvasSpriteBatch_DrawEx(AstralCanvasSpriteBatch ptr, AstralCanvasTexture2D texture, float positionX, float positionY, AstralCanvasRectangle *sourceRectangle, AstralCanvasColor color, float rotation, float originX, float originY, float scaleX, float scaleY, float depth)
+{
+    AstralCanvas::Color asColor;
+    asColor.packed = color.packed;
+    ((AstralCanvas::SpriteBatch *)ptr)->Draw((AstralCanvas::Texture2D *)texture, Maths::Vec2(positionX, positionY), (Maths::Rectangle *)sourceRectangle, asColor, rotation, Maths::Vec2(originX, originY), Maths::Vec2(scaleX, scaleY), depth);
+}
+exportC void AstralCanvasSpriteBatch_End(AstralCanvasSpriteBatch ptr, AstralCanvasGraphics graphics)
+{
+    ((AstralCanvas::SpriteBatch *)ptr)->End((AstralCanvas::Graphics *)graphics);
+}
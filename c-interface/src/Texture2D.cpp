@@ -50,6 +50,10 @@ exportC void *AstralCanvasTexture2D_GetImageView(AstralCanvasTexture2D ptr)
 {
     return ((AstralCanvas::Texture2D *)ptr)->imageView;
 }
+exportC u32 AstralCanvasTexture2D_GetBindlessIndex(AstralCanvasTexture2D ptr)
+{
+    return ((AstralCanvas::Texture2D *)ptr)->bindlessIndex;
+}
 exportC void AstralCanvasTexture2D_Deinit(AstralCanvasTexture2D ptr)
 {
     ((AstralCanvas::Texture2D *)ptr)->deinit();
@@ -27,6 +27,13 @@ namespace AstralCanvas
 		bool shouldResetDeltaTimer;
 
 		float framesPerSecond;
+		/// How many frames the CPU may record ahead of the GPU. Must be set before FinalizeGraphicsBackend, valid values are 2 to 3
+		u32 framesInFlight;
+		/// Draw single pass render programs without render pass and framebuffer objects where the device allows it. Must be set before FinalizeGraphicsBackend
+		bool useDynamicRendering;
+		/// File compiled pipelines are cached in between runs, usually inside the application's own cache directory. Must be set before
+		/// FinalizeGraphicsBackend and outlive the application. NULL by default, which keeps the cache in memory only
+		const char *pipelineCachePath;
 
 		Application();
 		Application* init(IAllocator allocators, string appName, string engineName, u32 appVersion, u32 engineVersion, float framesPerSecond);
@@ -34,6 +41,8 @@ namespace AstralCanvas
 		bool FinalizeGraphicsBackend();
 		void Run(ApplicationUpdateFunction updateFunc, ApplicationUpdateFunction drawFunc, ApplicationUpdateFunction postEndDrawFunc, ApplicationInitFunction initFunc, ApplicationDeinitFunction deinitFunc);
 		void ResetDeltaTimer();
+		/// Writes compiled pipelines to pipelineCachePath now rather than waiting for shutdown
+		bool SavePipelineCache();
 	};
 
 	Application* ApplicationInit(IAllocator ASTRALCORE_ALLOCATORS, string appName, string engineName, u32 appVersion, u32 engineVersion, float framesPerSecond);
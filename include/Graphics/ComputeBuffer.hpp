@@ -16,6 +16,9 @@ namespace AstralCanvas
         bool CPUCanRead;
 
         MemoryAllocation memoryAllocation;
+        /// The stages and accesses the buffer was last used with on the GPU, as recorded by barriers. 0 if unused so far
+        u64 usageStageMask;
+        u64 usageAccessMask;
 
         ComputeBuffer();
         ComputeBuffer(usize elementSize, usize elementCount, bool accessedAsVertexBuffer = false, bool accessedAsIndirectDrawData = false, bool CPUCanRead = false);
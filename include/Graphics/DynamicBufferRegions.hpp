@@ -0,0 +1,38 @@
+#pragma once
+#include "Linxc.h"
+
+namespace AstralCanvas
+{
+    /// Splits a dynamic buffer into one region per frame in flight. The first write of every frame moves on to the next
+    /// region, so the CPU never writes over data that a frame still in flight is reading, and the buffer is bound at the
+    /// offset of the region last written. A region only holds what was written to it, so writes that do not cover
+    /// everything being drawn must go through BeginPartialWrite
+    struct DynamicBufferRegions
+    {
+        usize regionSize;
+        u32 regionCount;
+        u32 currentRegion;
+        u64 writtenFrameNumber;
+
+        DynamicBufferRegions();
+        DynamicBufferRegions(usize regionSize);
+
+        /// Returns the byte offset of the region to write to. Anything not rewritten in the new region is as old as the
+        /// last time that region came around
+        usize BeginWrite();
+        /// Like BeginWrite, but copies the last written region into the new one when moving on, so whatever is not
+        /// rewritten stays as it was last written. mappedData is the start of the whole buffer. A write at writeOffset 0
+        /// starts the frame's contents over like BeginWrite does, as the mapped memory is too slow to read back for nothing
+        usize BeginPartialWrite(u8 *mappedData, usize writeOffset);
+        /// Whether the next BeginWrite moves on to another region, whose contents are then stale
+        bool WillMoveToNextRegion();
+        inline usize GetCurrentOffset() const
+        {
+            return (usize)currentRegion * regionSize;
+        }
+        inline usize GetTotalSize() const
+        {
+            return regionSize * (usize)regionCount;
+        }
+    };
+}
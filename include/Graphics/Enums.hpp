@@ -156,4 +156,33 @@ namespace AstralCanvas
 
         //PrimitiveType_LineStripWithAdjacency
     };
-}
+
+    enum SpriteSortMode
+    {
+        /// Sprites are drawn in the order they were submitted
+        SpriteSortMode_Deferred,
+        /// Sprites sharing a texture are drawn next to each other, in submission order otherwise
+        SpriteSortMode_Texture,
+        /// Sprites with the greatest depth are drawn first
+        SpriteSortMode_BackToFront,
+        /// Sprites with the least depth are drawn first
+        SpriteSortMode_FrontToBack
+    };
+
+    /// What a block of GPU memory was allocated for, as reported by GetGPUMemoryStatistics
+    enum GPUMemoryKind
+    {
+        /// Textures, render targets and render graph attachments
+        GPUMemoryKind_Texture,
+        /// Vertex and instance buffers
+        GPUMemoryKind_Vertex,
+        GPUMemoryKind_Index,
+        /// Uniform buffers and the per frame uniform arenas
+        GPUMemoryKind_Uniform,
+        GPUMemoryKind_Compute,
+        /// Upload and readback buffers
+        GPUMemoryKind_Staging,
+
+        GPUMemoryKind_Count
+    };
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+#include "Graphics/Compute.hpp"
+#include "Graphics/Graphics.hpp"
+#include "Maths/Matrix4x4.hpp"
+
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanInstanceData.hpp"
+/// How many frames of output buffers a culling pass keeps, so culling for one frame does not overwrite the commands a
+/// previous frame still in flight is drawing from
+#define ASTRALCANVAS_GPUCULLING_BUFFERED_FRAMES ASTRALVULKAN_MAX_FRAMES_IN_FLIGHT
+#else
+#define ASTRALCANVAS_GPUCULLING_BUFFERED_FRAMES 1
+#endif
+/// How many times a culling pass can Cull within one frame, such as once per shadow cascade and once for the camera
+#define ASTRALCANVAS_GPUCULLING_MAX_CULLS_PER_FRAME 4
+/// Local size of the culling shader, see src/Graphics/Shaders/GPUCulling.shader
+#define ASTRALCANVAS_GPUCULLING_GROUP_SIZE 64
+
+namespace AstralCanvas
+{
+    /// One element of the instances buffer given to GPUCullingPass::Cull. Layout matches CullingInstance in the shader
+    struct GPUCullingInstance
+    {
+        /// World space center in xyz, radius in w
+        float boundingSphere[4];
+        /// Index into the draw records buffer of the mesh this instance draws
+        u32 drawRecord;
+        u32 padding[3];
+    };
+    /// The index range of one mesh, shared by every instance that draws it
+    struct GPUCullingDrawRecord
+    {
+        u32 indexCount;
+        u32 firstIndex;
+        i32 vertexOffset;
+        u32 padding;
+    };
+
+    /// The commands written by one Cull and how many of them are visible
+    struct GPUCullingOutput
+    {
+        ComputeBuffer drawCommands;
+        ComputeBuffer drawCount;
+        /// Copied back after culling when the GPU cannot take the draw count from a buffer
+        u32 visibleCount;
+    };
+
+    /// Frustum culls instances on the GPU and writes a compacted DrawIndexedIndirectCommand for every visible one, along
+    /// with how many were written, ready for Graphics::DrawIndexedPrimitivesIndirectCount. Each command draws a single
+    /// instance with firstInstance set to that instance's index, so vertex shaders can look up per instance data
+    /// with gl_InstanceIndex. The shader is the one compiled from src/Graphics/Shaders/GPUCulling.shader.
+    /// On Vulkan this needs drawIndirectFirstInstance, creation fails without it. Without drawIndirectCount the visible
+    /// count is copied back after culling and drawn with a plain indirect draw instead, which means waiting on the dispatch
+    struct GPUCullingPass
+    {
+        Shader *shader;
+        ComputePipeline pipeline;
+        u32 maxDraws;
+
+        /// Output buffers of each frame in flight, created the first time a frame needs them
+        GPUCullingOutput outputs[ASTRALCANVAS_GPUCULLING_BUFFERED_FRAMES][ASTRALCANVAS_GPUCULLING_MAX_CULLS_PER_FRAME];
+        /// The outputs of the last Cull
+        GPUCullingOutput *currentOutput;
+        u64 cullFrameNumber;
+        u32 cullsThisFrame;
+        bool readBackDrawCount;
+
+        ShaderVariableHandle cullingDataHandle;
+        ShaderVariableHandle instancesHandle;
+        ShaderVariableHandle drawRecordsHandle;
+        ShaderVariableHandle drawCommandsHandle;
+        ShaderVariableHandle drawCountHandle;
+
+        GPUCullingPass();
+        GPUCullingPass(Shader *cullingShader, u32 maxDraws);
+
+        /// Culls the first instanceCount elements of instances (GPUCullingInstance) against the frustum of viewProjection
+        /// into the next set of output buffers, which stay valid until the end of the frame. Visible instances past
+        /// maxDraws are dropped. The dispatch is recorded into the frame through graphics ahead of the draws using its
+        /// results, so it must be called outside of a render program. Returns NULL if the pass could not be created or
+        /// the frame is out of outputs
+        GPUCullingOutput *Cull(Graphics *graphics, ComputeBuffer *instances, u32 instanceCount, ComputeBuffer *drawRecords, Maths::Matrix4x4 viewProjection);
+        /// Draws the results of the last Cull with the currently bound pipeline, vertex and index buffers
+        void Draw(Graphics *graphics);
+        /// Draws the results of an earlier Cull of this frame
+        void Draw(Graphics *graphics, GPUCullingOutput *output);
+        inline ComputeBuffer *GetDrawCommands()
+        {
+            return currentOutput != NULL ? &currentOutput->drawCommands : NULL;
+        }
+        inline ComputeBuffer *GetDrawCount()
+        {
+            return currentOutput != NULL ? &currentOutput->drawCount : NULL;
+        }
+        void deinit();
+    };
+}
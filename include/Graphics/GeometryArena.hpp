@@ -0,0 +1,60 @@
+#pragma once
+#include "Graphics/Graphics.hpp"
+#include "vector.hpp"
+
+namespace AstralCanvas
+{
+    /// A range of vertices or indices inside a GeometryArena, in elements
+    struct GeometryArenaRange
+    {
+        u32 offset;
+        u32 count;
+    };
+    struct GeometryArenaPendingFree
+    {
+        GeometryArenaRange vertices;
+        GeometryArenaRange indices;
+        u64 releasedOnFrame;
+    };
+    /// Where a mesh lives inside its GeometryArena. Accepted by Graphics::SetVertexBuffer, SetIndexBuffer and
+    /// DrawIndexedPrimitives in place of the buffers and ranges. vertexCount is 0 if the allocation failed
+    struct GeometryHandle
+    {
+        const VertexBuffer *vertexBuffer;
+        const IndexBuffer *indexBuffer;
+        u32 vertexOffset;
+        u32 vertexCount;
+        u32 firstIndex;
+        u32 indexCount;
+    };
+
+    /// Holds many meshes in one large device local vertex buffer and one index buffer, handing out ranges of each
+    /// from a first fit free list. Meshes sharing an arena need no rebinds between draws, so consecutive draws from it
+    /// can be merged into multi draw indirect. The arena does not grow, size it for everything it will ever hold
+    struct GeometryArena
+    {
+        VertexBuffer vertices;
+        IndexBuffer indices;
+        /// Sorted by offset, neighbouring ranges are always merged
+        collections::vector<GeometryArenaRange> freeVertices;
+        collections::vector<GeometryArenaRange> freeIndices;
+        /// Freed ranges in release order, waiting for every frame that could still draw them to retire
+        collections::vector<GeometryArenaPendingFree> pendingFrees;
+
+        GeometryArena();
+        GeometryArena(IAllocator allocator, VertexDeclaration *vertexType, usize vertexCapacity, IndexBufferSize indexElementSize, usize indexCapacity);
+
+        /// Reserves room for a mesh and uploads it. Indices are relative to the mesh's own first vertex
+        GeometryHandle Allocate(void *vertexData, u32 vertexCount, u8 *indexData, u32 indexCount);
+        /// The ranges are handed out again once every frame in flight at the time of the call has retired
+        void Free(GeometryHandle handle);
+        /// Returns the ranges of retired frees to the free lists. Called by Allocate
+        void RetireFrees();
+
+        /// Binds the arena's vertex buffer at bindingPoint and its index buffer
+        void Bind(Graphics *graphics, u32 bindingPoint = 0);
+        /// Draws a mesh. The arena must be bound
+        void Draw(Graphics *graphics, GeometryHandle handle, u32 instanceCount = 1, u32 firstInstance = 0);
+        void deinit();
+    };
+}
@@ -9,10 +9,16 @@
 #include "Graphics/RenderTarget.hpp"
 #include "Graphics/SamplerState.hpp"
 #include "hashset.hpp"
+#include "vector.hpp"
+#include "threading.hpp"
 #include "Windowing/Window.hpp"
 
+#define ASTRALCANVAS_MAX_VERTEX_BINDINGS 8
+
 namespace AstralCanvas
 {
+    struct GeometryHandle;
+    struct ComputePipeline;
     struct DrawIndexedIndirectCommand {
         u32    indexCount;
         u32    instanceCount;
@@ -20,6 +26,47 @@ namespace AstralCanvas
         i32     vertexOffset;
         u32    firstInstance;
     };
+    /// Commands recorded by a GraphicsContext, waiting to be executed by the Graphics they were recorded for
+    struct GraphicsSecondaryCommands
+    {
+        void *commandBuffer;
+        /// Secondaries are executed from lowest to highest order
+        u32 order;
+        u32 renderPass;
+    };
+    /// What has already been recorded into the current command buffer, so that commands which would not change anything can be skipped
+    struct GraphicsBoundState
+    {
+        void *pipeline;
+        void *pipelineLayout;
+        void *descriptorSet;
+        /// Sets are shared between draws binding the same resources, so the offsets decide whether a rebind is needed
+        u32 dynamicOffsets[MAX_UNIFORMS_IN_SHADER];
+        u32 dynamicOffsetCount;
+        /// The pipeline layout the bindless heap was last bound with. NULL once another layout has bound a set over it
+        void *bindlessLayout;
+        void *vertexBuffers[ASTRALCANVAS_MAX_VERTEX_BINDINGS];
+        /// Dynamic buffers move between regions of the same buffer, so the offset decides whether a rebind is needed
+        usize vertexBufferOffsets[ASTRALCANVAS_MAX_VERTEX_BINDINGS];
+        void *indexBuffer;
+        IndexBufferSize indexElementSize;
+        bool viewportSet;
+        Maths::Rectangle viewport;
+        bool scissorSet;
+        Maths::Rectangle scissor;
+    };
+    /// How many commands were skipped because they matched the bound state
+    struct GraphicsSkippedCommands
+    {
+        u32 pipelineBinds;
+        u32 vertexBufferBinds;
+        u32 indexBufferBinds;
+        u32 viewports;
+        u32 scissors;
+        u32 descriptorSetBinds;
+        /// Draws that went out as part of an indirect draw instead of on their own
+        u32 mergedDraws;
+    };
     struct Graphics
     {
         AstralCanvas::Window *currentWindow;
@@ -29,40 +76,111 @@ namespace AstralCanvas
         RenderPipeline *currentRenderPipeline;
         collections::hashset<Shader*> usedShaders;
         Color clearColor;
+        /// Clear colors of the current render program's attachments, in the order they were added. Empty if every
+        /// attachment is cleared to clearColor
+        collections::Array<Color> attachmentClearColors;
 
         const IndexBuffer *currentIndexBuffer;
         
         void* currentCommandEncoderInstance;
 
+        /// Only set on the Graphics owned by a GraphicsContext. Commands are recorded into this
+        /// instead of the frame's main command buffer
+        void *recordingCommandBuffer;
+        /// Whether the current render program was started to execute commands recorded by GraphicsContexts.
+        /// If so, draw commands must not be issued through this Graphics until the program ends
+        bool executesSecondaryCommands;
+        threading::Mutex secondaryCommandsMutex;
+        collections::vector<GraphicsSecondaryCommands> secondaryCommands;
+        /// Reused by ExecuteSecondaryCommands to gather the command buffers recorded for the current render pass
+        collections::vector<void *> secondaryCommandBuffers;
+        /// Uniform state of every shader variables were set on through this Graphics. Only used by the Graphics owned by a
+        /// GraphicsContext, the frame's own Graphics shares each shader's own state with variables set on the shader directly
+        collections::vector<ShaderDrawState> shaderDrawStates;
+
         Maths::Rectangle Viewport;
         Maths::Rectangle ClipArea;
 
+        GraphicsBoundState boundState;
+        /// Draws deferred while draw merging is enabled, recorded together once something they depend on changes
+        collections::vector<DrawIndexedIndirectCommand> mergedDraws;
+        bool mergeDraws;
+        /// Accumulates until ResetSkippedCommands is called
+        GraphicsSkippedCommands skippedCommands;
+
         Graphics();
 
+        /// Forgets everything bound so far. Must be called whenever commands start going into a different command buffer,
+        /// or after commands this Graphics did not record itself have been executed
+        void ResetBoundState();
+        void ResetSkippedCommands();
+        /// Where variables set through this Graphics on the given shader are staged until its next draw
+        ShaderDrawState *GetShaderDrawState(Shader *shader);
+
         void SetClipArea(Maths::Rectangle newClipArea);
         void SetVertexBuffer(const VertexBuffer *vb, u32 bindingPoint = 0);
         void SetComputeBufferAsVertexBuffer(const ComputeBuffer* computeBuffer, u32 bindingPoint = 0);
         void SetInstanceBuffer(const InstanceBuffer *instanceBuffer, u32 bindingPoint = 0);
         void SetIndexBuffer(const IndexBuffer *indexBuffer);
+        /// Binds the buffers of the handle's GeometryArena. Every mesh in the arena shares them, so switching between
+        /// meshes of one arena rebinds nothing
+        void SetVertexBuffer(GeometryHandle handle, u32 bindingPoint = 0);
+        void SetIndexBuffer(GeometryHandle handle);
         void SetRenderTarget(RenderTarget *target);
-        void StartRenderProgram(RenderProgram *program, const Color clearColor);
+        /// Set useGraphicsContexts to record this program's draws from GraphicsContexts on other threads
+        void StartRenderProgram(RenderProgram *program, const Color clearColor, bool useGraphicsContexts = false);
+        /// Like StartRenderProgram, but with a clear color for each attachment of the program, in the order they were added.
+        /// Entries of depth attachments are ignored. The array must stay valid until EndRenderProgram
+        void StartRenderProgram(RenderProgram *program, collections::Array<Color> attachmentClearColors, bool useGraphicsContexts = false);
         void NextRenderPass();
         void EndRenderProgram();
         void UseRenderPipeline(RenderPipeline *pipeline);
 
+        /// Blocks until the GPU has finished all submitted work. Resources released with deinit are normally destroyed once
+        /// the frames using them retire, this also destroys any still waiting
         void AwaitGraphicsIdle();
 
+        /// Queues a GraphicsContext's finished commands for the current render pass. Safe to call from any thread
+        void SubmitSecondaryCommands(void *commandBuffer, u32 order, collections::hashset<Shader*> *contextUsedShaders);
+        /// Executes all secondaries queued for the current render pass in order. Called by NextRenderPass and EndRenderProgram
+        void ExecuteSecondaryCommands();
+
         void SetShaderVariable(const char* variableName, void* ptr, usize size);
         void SetShaderVariableTexture(const char* variableName, Texture2D *texture);
         void SetShaderVariableTextures(const char* variableName, Texture2D **textures, usize count);
         void SetShaderVariableSampler(const char* variableName, SamplerState *sampler);
         void SetShaderVariableSamplers(const char* variableName, SamplerState **samplers, usize count);
         void SetShaderVariableComputeBuffer(const char* variableName, ComputeBuffer *computeBuffer);
+        /// Handles must have been resolved from the shader of the current render pipeline
+        void SetShaderVariable(ShaderVariableHandle handle, void* ptr, usize size);
+        void SetShaderVariableTexture(ShaderVariableHandle handle, Texture2D *texture);
+        void SetShaderVariableTextures(ShaderVariableHandle handle, Texture2D **textures, usize count);
+        void SetShaderVariableSampler(ShaderVariableHandle handle, SamplerState *sampler);
+        void SetShaderVariableSamplers(ShaderVariableHandle handle, SamplerState **samplers, usize count);
+        void SetShaderVariableComputeBuffer(ShaderVariableHandle handle, ComputeBuffer *computeBuffer);
+        /// Writes straight into the command buffer without touching any descriptors, the cheapest way to send small
+        /// per-draw data. Stays set for every draw until overwritten. Vulkan only
+        void SetPushConstants(void *data, u32 size, u32 offset = 0);
 
         void SendUpdatedUniforms();
 
+        /// While enabled, DrawIndexedPrimitives is deferred, and consecutive draws sharing every bound pipeline, buffer,
+        /// descriptor set and dynamic state are recorded as a single indirect draw. Draws of adjacent index ranges are
+        /// also joined into one command when the pipeline draws lists. Vulkan only, other backends draw immediately
+        void SetDrawMerging(bool enabled);
+        /// Records every deferred draw. Called automatically before any command the deferred draws must come before
+        void FlushMergedDraws();
+
         void DrawIndexedPrimitivesIndirect(ComputeBuffer* drawDataBuffer, usize drawDataBufferOffset, u32 drawCount);
         void DrawIndexedPrimitivesIndirectCount(ComputeBuffer *drawDataBuffer, usize drawDataBufferOffset, ComputeBuffer *drawCountBuffer, usize drawCountBufferOffset, u32 maxDrawCount);
         void DrawIndexedPrimitives(u32 indexCount, u32 instanceCount, u32 firstIndex = 0, u32 vertexOffset = 0, u32 firstInstance = 0);
+        /// Draws the mesh's range of its arena. The arena's buffers must be bound
+        void DrawIndexedPrimitives(GeometryHandle handle, u32 instanceCount = 1, u32 firstInstance = 0);
+
+        /// Records the dispatch into the frame's command buffer, so it runs in order with the frame's draws instead of
+        /// being waited on like ComputePipeline::DispatchNow. Variables are staged through this Graphics, the same as
+        /// for draws. Must be called outside of a render program, and anything reading the results has to be
+        /// synchronized against the dispatch. Vulkan only
+        void DispatchCompute(ComputePipeline *pipeline, u32 threadsX, u32 threadsY, u32 threadsZ);
     };
 }
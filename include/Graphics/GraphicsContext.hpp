@@ -0,0 +1,36 @@
+#pragma once
+#include "Linxc.h"
+#include "Graphics/Graphics.hpp"
+//the frames in flight limit is defined outside the Vulkan guard, so contexts can size their per-frame arrays with it
+#include "Graphics/Vulkan/VulkanInstanceData.hpp"
+
+namespace AstralCanvas
+{
+    /// Records draw commands on a worker thread for a Graphics whose current render program was started with
+    /// useGraphicsContexts. Each context owns its own command pools, so a context must only be used by one thread at a time.
+    /// Recorded commands are executed by the parent in order of the order given to Begin, regardless of which thread finished first.
+    /// Shader variables set through a context's graphics are staged for that context alone, so contexts may draw with the same shader in parallel
+    struct GraphicsContext
+    {
+        IAllocator allocator;
+        /// Issue commands through this between Begin and End
+        Graphics graphics;
+        Graphics *parent;
+        u32 order;
+
+        //one pool per frame in flight, reset once that frame's fence has been waited on
+        void *commandPools[ASTRALVULKAN_MAX_FRAMES_IN_FLIGHT];
+        collections::vector<void *> commandBuffers[ASTRALVULKAN_MAX_FRAMES_IN_FLIGHT];
+        usize usedCommandBuffers[ASTRALVULKAN_MAX_FRAMES_IN_FLIGHT];
+        u64 poolFrameNumbers[ASTRALVULKAN_MAX_FRAMES_IN_FLIGHT];
+
+        GraphicsContext();
+        GraphicsContext(IAllocator allocator);
+
+        /// Begins recording commands for the parent's current render pass
+        bool Begin(Graphics *parent, u32 order);
+        /// Finishes recording and hands the commands to the parent to be executed at its next NextRenderPass or EndRenderProgram
+        void End();
+        void deinit();
+    };
+}
@@ -17,6 +17,8 @@ namespace AstralCanvas
         IndexBuffer(IndexBufferSize thisIndexElementSize, usize indexCount);
 
         void SetData(u8* bytes, usize sizeOfBytes);
+        /// Writes sizeOfBytes bytes of indices starting at startIndex, leaving the rest of the buffer untouched
+        void SetData(u8* bytes, usize sizeOfBytes, usize startIndex);
         void Construct();
         void deinit();
     };
@@ -2,6 +2,7 @@
 #include "Linxc.h"
 #include "Graphics/VertexDeclarations.hpp"
 #include "Graphics/MemoryAllocation.hpp"
+#include "Graphics/DynamicBufferRegions.hpp"
 
 namespace AstralCanvas
 {
@@ -11,11 +12,15 @@ namespace AstralCanvas
         bool canRead;
         usize instanceSize;
         usize instanceCount;
+        /// Host visible and written in place by SetData instead of staged, for data that changes every frame
+        bool isDynamic;
+        /// Only split when isDynamic, bound at the offset of the region last written
+        DynamicBufferRegions regions;
 
         MemoryAllocation memoryAllocation;
 
         InstanceBuffer();
-        InstanceBuffer(usize instanceSize, usize instanceCount, bool canRead = false);
+        InstanceBuffer(usize instanceSize, usize instanceCount, bool canRead = false, bool isDynamic = false);
 
         void SetData(void* instancesData, usize count);
         void Construct();
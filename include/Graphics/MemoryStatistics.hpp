@@ -0,0 +1,51 @@
+#pragma once
+#include "Linxc.h"
+#include "Graphics/Enums.hpp"
+
+/// Matches VK_MAX_MEMORY_HEAPS
+#define ASTRALCANVAS_MAX_MEMORY_HEAPS 16
+
+namespace AstralCanvas
+{
+    /// Called once when a heap's usage rises above the soft budget. It is not called again for that heap until usage
+    /// has dropped back under the soft budget
+    def_delegate(GPUMemoryBudgetCallback, void, u32 heapIndex, u64 usage, u64 softBudget);
+
+    struct GPUMemoryHeapStatistics
+    {
+        /// Bytes of this heap currently in use by the application, counting whole memory blocks
+        u64 usage;
+        /// Bytes the driver reports can be used before it has to start paging. Where the driver cannot report it,
+        /// this is estimated from the heap's size
+        u64 budget;
+        /// The greatest usage seen since the last call to ResetGPUMemoryPeaks
+        u64 peakUsage;
+        /// Bytes occupied by allocations, the rest of usage is free space within blocks
+        u64 allocationBytes;
+        u32 allocationCount;
+        /// Whether this heap is video memory rather than system memory the GPU can see
+        bool deviceLocal;
+    };
+    struct GPUMemoryKindStatistics
+    {
+        u32 allocationCount;
+        u64 bytes;
+        /// The greatest number of bytes allocated for this kind since the last call to ResetGPUMemoryPeaks
+        u64 peakBytes;
+    };
+    struct GPUMemoryStatistics
+    {
+        u32 heapCount;
+        GPUMemoryHeapStatistics heaps[ASTRALCANVAS_MAX_MEMORY_HEAPS];
+        GPUMemoryKindStatistics kinds[GPUMemoryKind_Count];
+    };
+
+    /// Fills result with the current usage and budget of each heap, and what the engine's allocations were made for.
+    /// Returns false if the active backend cannot report memory usage
+    bool GetGPUMemoryStatistics(GPUMemoryStatistics *result);
+    /// Restarts peak tracking of every heap and kind from their current usage
+    void ResetGPUMemoryPeaks();
+    /// Calls callback whenever a heap's usage goes over budgetFraction of its budget. Budgets are checked once per frame.
+    /// Pass NULL to remove the callback
+    void SetGPUMemorySoftBudget(float budgetFraction, GPUMemoryBudgetCallback callback);
+}
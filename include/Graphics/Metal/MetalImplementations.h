@@ -53,5 +53,5 @@ void AstralCanvasMetal_DestroySampler(AstralCanvas::SamplerState *sampler);
 void AstralCanvasMetal_SetClipArea(void *commandEncoder, Maths::Rectangle clipArea);
 
 void AstralCanvasMetal_AddUniformDescriptorSets(AstralCanvas::Shader *shader);
-void AstralCanvasMetal_SyncUniformsWithGPU(void *commandEncoder, AstralCanvas::Shader *shader);
+void AstralCanvasMetal_SyncUniformsWithGPU(void *commandEncoder, AstralCanvas::Shader *shader, usize descriptorSlot);
 #endif
@@ -0,0 +1,114 @@
+#pragma once
+#include "Linxc.h"
+#include "vector.hpp"
+#include "Graphics/Graphics.hpp"
+#include "Graphics/RenderProgram.hpp"
+#include "Graphics/RenderTarget.hpp"
+#include "Graphics/Texture2D.hpp"
+
+namespace AstralCanvas
+{
+    /// Index of a texture within a RenderGraph. -1 if none
+    typedef i32 RenderGraphResource;
+
+    def_delegate(RenderGraphPassFunction, void, Graphics *graphics, void *userData);
+
+    enum RenderGraphResourceType
+    {
+        /// Created and owned by the graph. Only lives between the first and last pass that uses it,
+        /// so its memory may be shared with other transient textures
+        RenderGraphResource_Transient,
+        /// A texture owned by the user that the graph reads from or renders into
+        RenderGraphResource_Imported,
+        /// The current window's swapchain image
+        RenderGraphResource_Backbuffer
+    };
+
+    struct RenderGraphTexture
+    {
+        RenderGraphResourceType type;
+        u32 width;
+        u32 height;
+        ImageFormat imageFormat;
+        /// Whether the texture should survive past the end of the graph. Passes that do not
+        /// eventually contribute to an output are culled
+        bool isOutput;
+        /// Points to transientTexture for transient textures
+        Texture2D *texture;
+        Texture2D transientTexture;
+
+        //filled in by Compile
+        i32 firstUse;
+        i32 lastUse;
+        i32 memoryBlock;
+        /// Whether another texture used the memory block before this one
+        bool aliasesPrevious;
+    };
+
+    struct RenderGraphPass
+    {
+        const char *name;
+        RenderGraphPassFunction execute;
+        void *userData;
+        /// Textures sampled by the pass' shaders
+        collections::vector<RenderGraphResource> reads;
+        collections::vector<RenderGraphResource> colorWrites;
+        /// Whether each of colorWrites is cleared, and the color it is cleared to
+        collections::vector<bool> colorClears;
+        collections::vector<Color> clearValues;
+        RenderGraphResource depthWrite;
+        bool clearDepth;
+
+        //filled in by Compile
+        bool culled;
+        bool writesBackbuffer;
+        /// Index into colorWrites of the backbuffer, if writesBackbuffer
+        usize backbufferWrite;
+        RenderProgram program;
+        RenderTarget target;
+    };
+
+    struct RenderGraphMemoryBlock
+    {
+        MemoryAllocation memory;
+        usize size;
+        u32 memoryTypeBits;
+        i32 lastUse;
+    };
+
+    /// Builds a frame out of passes that declare which textures they read and write. On Compile, passes are ordered
+    /// so that every read of a texture sees the write declared before it and finishes before the next write, passes that
+    /// do not contribute to an output are culled, and transient textures whose lifetimes do not overlap are placed in the
+    /// same memory. Layout transitions between passes are recorded automatically on Execute.
+    struct RenderGraph
+    {
+        IAllocator allocator;
+        collections::vector<RenderGraphTexture> textures;
+        collections::vector<RenderGraphPass> passes;
+        collections::vector<RenderGraphMemoryBlock> memoryBlocks;
+        /// Indices into passes, in the order they will be executed. Does not include culled passes
+        collections::vector<u32> executionOrder;
+        bool compiled;
+
+        RenderGraph();
+        RenderGraph(IAllocator allocator);
+
+        RenderGraphResource CreateTexture(u32 width, u32 height, ImageFormat imageFormat);
+        RenderGraphResource ImportTexture(Texture2D *texture, bool isOutput);
+        /// Passes writing to the backbuffer also use the swapchain's depth buffer, and are never culled
+        RenderGraphResource ImportBackbuffer();
+
+        u32 AddPass(const char *name, RenderGraphPassFunction execute, void *userData);
+        void PassReads(u32 pass, RenderGraphResource resource);
+        void PassWrites(u32 pass, RenderGraphResource resource, bool clear, Color clearValue);
+        void PassWritesDepth(u32 pass, RenderGraphResource resource, bool clear);
+
+        /// Must be called again after adding passes or textures
+        bool Compile();
+        /// Records every pass into the current frame. Must not be called while a render program is active
+        void Execute(Graphics *graphics);
+        /// Releases everything created by Compile, but keeps the declared passes and textures
+        void ReleaseCompiled();
+        void deinit();
+    };
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "Linxc.h"
 #include "hashmap.hpp"
+#include "threading.hpp"
 #include "Graphics/VertexDeclarations.hpp"
 #include "Graphics/Shader.hpp"
 #include "Graphics/BlendState.hpp"
@@ -10,26 +11,36 @@ namespace AstralCanvas
 {
     //Because the creation of a renderpipeline handles requires a render program and pass,
     //we should cache and reuse renderpipeline handles wherever possible, like when
-    //using the same pipeline for the same pass
+    //using the same pipeline for the same pass.
+    //Programs using dynamic rendering have no handle, so their pipelines are shared by all programs
+    //with the same attachment formats instead
     struct RenderPipelineBindZone
     {
         void *renderProgramHandle;
         u32 subPassHandle;
+        /// One byte per color attachment format, only used with dynamic rendering
+        u64 colorFormats;
+        u32 depthFormat;
     };
     inline u32 RenderPipelineBindZoneHash(RenderPipelineBindZone zone)
     {
         u32 hash = 7;
         hash = hash * 31 + (u32)(usize)zone.renderProgramHandle;
         hash = hash * 31 + zone.subPassHandle;
+        hash = hash * 31 + (u32)zone.colorFormats;
+        hash = hash * 31 + (u32)(zone.colorFormats >> 32);
+        hash = hash * 31 + zone.depthFormat;
         return hash;
     }
     inline bool RenderPipelineBindZoneEql(RenderPipelineBindZone A, RenderPipelineBindZone B)
     {
-        return A.renderProgramHandle == B.renderProgramHandle && A.subPassHandle == B.subPassHandle;
+        return A.renderProgramHandle == B.renderProgramHandle && A.subPassHandle == B.subPassHandle && A.colorFormats == B.colorFormats && A.depthFormat == B.depthFormat;
     }
     struct RenderPipeline
     {
         collections::hashmap<RenderPipelineBindZone, void *> zoneToPipelineInstance;
+        /// Guards zoneToPipelineInstance, as GraphicsContexts may look up pipelines from multiple threads
+        threading::Mutex zoneMutex;
         void *layout;
         Shader *shader;
         collections::Array<VertexDeclaration*> vertexDeclarations;
@@ -42,8 +53,46 @@ namespace AstralCanvas
         void deinit();
         /// Retrieves or creates an instance of this pipeline for use in the given render program and pass.
         void *GetOrCreateFor(AstralCanvas::RenderProgram *renderProgram, u32 renderPassToUse);
+        /// Retrieves the instance for the given render program and pass without compiling it. Returns NULL if it is not ready yet
+        void *TryGetFor(AstralCanvas::RenderProgram *renderProgram, u32 renderPassToUse);
 
         RenderPipeline();
         RenderPipeline(IAllocator allocator, Shader *pipelineShader, CullMode pipelineCullMode, PrimitiveType pipelinePrimitiveType, BlendState pipelineBlendState, bool testDepth, bool writeToDepth, collections::Array<VertexDeclaration*> pipelineVertexDeclarations);
     };
+
+    struct RenderPipelinePrewarmEntry
+    {
+        RenderPipeline *pipeline;
+        RenderProgram *renderProgram;
+        u32 renderPass;
+    };
+
+    /// Compiles pipelines for the render programs and passes they will be used with ahead of time, so that
+    /// UseRenderPipeline never has to wait on the driver mid-frame. Must stay at the same address and
+    /// the pipelines and programs must stay alive until IsComplete returns true
+    struct RenderPipelinePrewarm
+    {
+        IAllocator allocator;
+        collections::Array<RenderPipelinePrewarmEntry> entries;
+        threading::Mutex mutex;
+        usize nextEntry;
+        usize completedEntries;
+        u32 runningWorkers;
+        /// Joined by Await
+        collections::Array<threading::Thread> workers;
+
+        RenderPipelinePrewarm();
+        RenderPipelinePrewarm(IAllocator allocator, RenderPipelinePrewarmEntry *entries, usize entryCount);
+
+        /// Spawns worker threads to compile the entries, may only be called once. Backends that cannot compile off the main thread compile everything in Await instead
+        void Start(u32 threadCount);
+        /// Compiles one remaining entry on the calling thread. Returns false once every entry has been taken
+        bool CompileNext();
+        /// Between 0 and 1, for loading screens
+        float GetProgress();
+        bool IsComplete();
+        /// Compiles remaining entries on the calling thread, then joins the workers
+        void Await();
+        void deinit();
+    };
 }
\ No newline at end of file
@@ -57,6 +57,8 @@ namespace AstralCanvas
     {
         IAllocator allocator;
         void *handle;
+        /// Set by Construct when the program is drawn with dynamic rendering, in which case handle stays NULL
+        bool usesDynamicRendering;
         collections::vector<RenderProgramImageAttachment> attachments;
         collections::vector<RenderPass> renderPasses;
 
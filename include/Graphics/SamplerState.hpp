@@ -17,6 +17,8 @@ namespace AstralCanvas
         bool anisotropic;
         /// The level of anisotropy, if anisotropic is enabled
         float anisotropyLevel;
+        /// Index of the sampler in the bindless heap, stable until deinit. 0 if the sampler is not in the heap
+        u32 bindlessIndex;
 
         SamplerState();
         SamplerState(SampleMode thisSampleMode, RepeatMode thisRepeatMode, bool isAnisotropic, float thisAnisotropyLevel);
@@ -2,11 +2,16 @@
 #include "Linxc.h"
 #include "string.hpp"
 #include "array.hpp"
+#include "vector.hpp"
+#include "threading.hpp"
 #include "Graphics/ShaderResources.hpp"
 #include "Graphics/Enums.hpp"
 #include "Json.hpp"
 
 #define MAX_UNIFORMS_IN_SHADER 16
+/// Images and samplers declared in this set index into the bindless heap instead of being set per draw. Binding 0 holds
+/// every texture and binding 1 every sampler, indexed by Texture2D::bindlessIndex and SamplerState::bindlessIndex
+#define ASTRALCANVAS_BINDLESS_SET 1
 
 #ifdef ASTRALCANVAS_VULKAN
 #include "vulkan/vulkan.h"
@@ -34,6 +39,41 @@ namespace AstralCanvas
             params.deinit();
         }
     };
+    /// A variable resolved once with Shader::GetVariableHandle. Setters taking a handle find the variable by its binding
+    /// instead of comparing names, which matters when variables are set every draw. Only valid for the shader it was
+    /// resolved from. binding is -1 if the variable was not found, in which case setting it does nothing
+    struct ShaderVariableHandle
+    {
+        i32 binding;
+        ShaderResourceType type;
+    };
+    struct Shader;
+    /// Where a shader's variables go between being set and being drawn with. Kept by whoever records the draw rather than
+    /// by the shared Shader, so GraphicsContexts recording with the same shader in parallel never touch each other's state.
+    /// Each shader keeps one of its own for variables set on it directly
+    struct ShaderDrawState
+    {
+        /// NULL for the shader's own state
+        Shader *shader;
+        /// Set once a variable has been staged, at which point descriptorSlot is claimed until the next sync
+        bool uniformsHasBeenSet;
+        /// The staging slot claimed from the shader for the next draw
+        usize descriptorSlot;
+        /// The descriptor set written by the last SyncUniformsWithGPU. On Vulkan this is owned by the descriptor set
+        /// cache, and stays valid until the frame it was last bound in has retired
+        void *descriptorSet;
+        /// Offsets into the uniform arena for every uniform buffer in descriptorSet, in binding order.
+        /// Must be passed alongside the set when binding it
+        u32 dynamicOffsets[MAX_UNIFORMS_IN_SHADER];
+        u32 dynamicOffsetCount;
+        /// Scratch space for the handles written into the set, reused between syncs to look up identical sets
+        /// written by earlier draws
+        collections::vector<u8> descriptorSetKey;
+
+        ShaderDrawState();
+        ShaderDrawState(IAllocator allocator, Shader *shader);
+        void deinit();
+    };
     struct Shader
     {
         IAllocator allocator;
@@ -42,16 +82,25 @@ namespace AstralCanvas
         ShaderModule shaderModule2;
         ShaderVariables shaderVariables;
         PipelineLayout shaderPipelineLayout;
-        bool uniformsHasBeenSet;
 
         collections::Array<ShaderMaterialExport> usedMaterials;
 
-        usize descriptorForThisDrawCall;
-        collections::vector<void *> descriptorSets;
+        /// Number of staging slots created by CheckDescriptorSetAvailability
+        usize descriptorSlotCount;
+        /// Number of staging slots handed out to draw states this frame
+        usize descriptorSlotsClaimed;
+        /// Guards slot claims and the staging data, which may be reallocated whenever a slot is created
+        threading::Mutex stagingMutex;
+        /// Used by the setters and syncs not given a draw state of their own
+        ShaderDrawState drawState;
 
         i32 GetVariableBinding(const char* variableName);
-        void CheckDescriptorSetAvailability(bool forceAddNewDescriptor = false);
-        void SyncUniformsWithGPU(void *commandEncoder);
+        /// Creates staging slots until slot exists. Must be called with stagingMutex held
+        void CheckDescriptorSetAvailability(usize slot);
+        /// Returns every staging slot to the shader. Only call once nothing recording this frame still holds a slot
+        void ResetDescriptorSlots();
+        /// Writes the variables staged in drawState for the GPU, and claims a new slot on the next set
+        void SyncUniformsWithGPU(void *commandEncoder, ShaderDrawState *drawState = NULL);
 
         void SetShaderVariable(const char* variableName, void* ptr, usize size);
         void SetShaderVariableTexture(const char* variableName, Texture2D *texture);
@@ -60,6 +109,15 @@ namespace AstralCanvas
         void SetShaderVariableSamplers(const char* variableName, SamplerState **samplers, usize count);
         void SetShaderVariableComputeBuffer(const char* variableName, ComputeBuffer* computeBuffer);
 
+        ShaderVariableHandle GetVariableHandle(const char* variableName);
+        /// Variables are staged into drawState, or into the shader's own if NULL
+        void SetShaderVariable(ShaderVariableHandle handle, void* ptr, usize size, ShaderDrawState *drawState = NULL);
+        void SetShaderVariableTexture(ShaderVariableHandle handle, Texture2D *texture, ShaderDrawState *drawState = NULL);
+        void SetShaderVariableTextures(ShaderVariableHandle handle, Texture2D **textures, usize count, ShaderDrawState *drawState = NULL);
+        void SetShaderVariableSampler(ShaderVariableHandle handle, SamplerState *sampler, ShaderDrawState *drawState = NULL);
+        void SetShaderVariableSamplers(ShaderVariableHandle handle, SamplerState **samplers, usize count, ShaderDrawState *drawState = NULL);
+        void SetShaderVariableComputeBuffer(ShaderVariableHandle handle, ComputeBuffer* computeBuffer, ShaderDrawState *drawState = NULL);
+
         Shader();
         Shader(IAllocator allocator, ShaderType type);
         void deinit();
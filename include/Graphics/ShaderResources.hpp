@@ -19,6 +19,13 @@ namespace AstralCanvas
             {
                 UniformBuffer ub;
                 bool ownsUniformBuffer;
+                /// Vulkan only, replaces ub. The uniform's contents, copied into the frame's uniform arena on sync
+                void *uniformData;
+                /// Where uniformData was last copied to and during which frame, reused until the uniform changes
+                /// or the frame's arena is rewound
+                void *arenaBuffer;
+                u32 arenaOffset;
+                u64 arenaFrameNumber;
             };
             ComputeBuffer* computeBuffer;
             struct
@@ -33,6 +40,9 @@ namespace AstralCanvas
             };
         };
         bool mutated;
+        /// Whether the slot was ever given a resource. Descriptor sets are allocated fresh every frame and need every
+        /// set binding written, not only the ones mutated since the last sync
+        bool hasBeenSet;
     };
     struct ShaderResource
     {
@@ -53,6 +63,12 @@ namespace AstralCanvas
     {
         IAllocator allocator;
         collections::denseset<ShaderResource> uniforms;
+        /// Size of the largest push constant block declared by any stage, 0 if the shader has none. Every stage
+        /// shares a single range starting at offset 0
+        u32 pushConstantsSize;
+        ShaderInputAccessedBy pushConstantsAccessedBy;
+        /// Whether any stage reads from the bindless heap, which is then bound alongside the shader's own set
+        bool usesBindlessHeap;
 
         ShaderVariables();
         ShaderVariables(IAllocator allocator);
@@ -0,0 +1,69 @@
+#pragma once
+#include "Graphics/Graphics.hpp"
+#include "Graphics/BlendState.hpp"
+#include "Maths/Matrix4x4.hpp"
+#include "Maths/Vec2.hpp"
+#include "vector.hpp"
+
+namespace AstralCanvas
+{
+    /// Per instance data of one sprite, as read by src/Graphics/Shaders/SpriteBatch.shader
+    struct SpriteBatchInstance
+    {
+        /// Position in xy, size in zw
+        float destination[4];
+        /// Top left UV in xy, bottom right UV in zw
+        float source[4];
+        float color[4];
+        /// Origin in pixels of the destination in xy, rotation in radians around it in z and depth in w
+        float originRotationDepth[4];
+        u32 textureIndex;
+        u32 samplerIndex;
+        u32 padding[2];
+    };
+
+    /// Draws sprites as instances of a single quad, one instanced draw per End. Textures and samplers are read from the
+    /// bindless heap by their bindless index, so sprites with different textures still share a draw. The shader is the
+    /// one compiled from src/Graphics/Shaders/SpriteBatch.shader. Creating one on a GPU without bindless support raises an error
+    struct SpriteBatch
+    {
+        IAllocator allocator;
+        Shader *shader;
+        RenderPipeline pipeline;
+        ShaderVariableHandle matricesHandle;
+
+        /// Allocated so the pipeline and buffers referring to them stay valid when the batch is copied
+        VertexDeclaration *quadDecl;
+        VertexDeclaration *instanceDecl;
+        VertexBuffer quadVertices;
+        IndexBuffer quadIndices;
+
+        /// Dynamic, so every frame in flight writes to its own region. Each End in a frame appends after the last
+        VertexBuffer instanceStream;
+        usize streamCapacity;
+        usize streamHead;
+
+        collections::vector<SpriteBatchInstance> sprites;
+        collections::vector<SpriteBatchInstance> sortedSprites;
+        collections::vector<u64> sortKeys;
+
+        bool begun;
+        SpriteSortMode sortMode;
+        Maths::Matrix4x4 transform;
+        u32 samplerIndex;
+
+        SpriteBatch();
+        SpriteBatch(IAllocator allocator, Shader *spriteShader, BlendState blendState, usize initialCapacity = 1024);
+
+        /// transform takes sprite positions, in pixels, to clip space
+        void Begin(SpriteSortMode sortMode, Maths::Matrix4x4 transform, SamplerState *sampler);
+        void Draw(Texture2D *texture, Maths::Vec2 position, Color color);
+        /// sourceRectangle may be NULL to draw the whole texture. origin is in texels of the source rectangle and is what
+        /// position, rotation and scale are relative to
+        void Draw(Texture2D *texture, Maths::Vec2 position, Maths::Rectangle *sourceRectangle, Color color, float rotation, Maths::Vec2 origin, Maths::Vec2 scale, float depth);
+        /// Sorts the sprites, writes them to the instance stream and draws them all with one instanced draw. Binds the
+        /// batch's pipeline, vertex and index buffers, so anything drawn afterwards has to bind its own
+        void End(Graphics *graphics);
+        void deinit();
+    };
+}
@@ -39,6 +39,13 @@ namespace AstralCanvas
         AstralCanvas::MemoryAllocation allocatedMemory;
         /// The internal layout of the image. Will be modified at render time!
         u64 imageLayout;
+        /// The stages and accesses the image was last used with, as recorded by barriers. Only trusted while imageLayout is
+        /// still usageLayout, otherwise the layout was changed elsewhere and barriers fall back to what the layout implies
+        u64 usageLayout;
+        u64 usageStageMask;
+        u64 usageAccessMask;
+        /// Index of the texture in the bindless heap, stable until deinit. 0 if the texture is not in the heap
+        u32 bindlessIndex;
 
         void deinit();
         void Construct();
@@ -2,6 +2,7 @@
 #include "Linxc.h"
 #include "Graphics/VertexDeclarations.hpp"
 #include "Graphics/MemoryAllocation.hpp"
+#include "Graphics/DynamicBufferRegions.hpp"
 
 namespace AstralCanvas
 {
@@ -12,6 +13,8 @@ namespace AstralCanvas
         VertexDeclaration *vertexType;
         usize vertexCount;
         bool isDynamic;
+        /// Only split when isDynamic, bound at the offset of the region last written
+        DynamicBufferRegions regions;
 
         MemoryAllocation memoryAllocation;
 
@@ -19,6 +22,9 @@ namespace AstralCanvas
         VertexBuffer(VertexDeclaration *thisVertexType, usize vertexCount, bool isDynamic = false, bool canRead = false);
 
         void SetData(void* verticesData, usize count);
+        /// Writes count vertices starting at startVertex, leaving the rest of the buffer untouched. On dynamic buffers, the
+        /// first write of a frame at vertex 0 starts the frame's contents over like SetData without a start does
+        void SetData(void* verticesData, usize count, usize startVertex);
         void *GetData(IAllocator allocator, usize* dataLength);
         void Construct();
         void deinit();
@@ -0,0 +1,53 @@
+#pragma once
+#ifdef ASTRALCANVAS_VULKAN
+#include <vulkan/vulkan.h>
+#include "Graphics/Vulkan/VulkanGPU.hpp"
+#include "Graphics/Texture2D.hpp"
+#include "Graphics/ComputeBuffer.hpp"
+
+#define ASTRALVULKAN_MAX_BATCHED_BARRIERS 32
+
+/// The pipeline stages and memory accesses a resource is used with while in a given layout
+struct AstralCanvasVkResourceState
+{
+    VkPipelineStageFlags2 stageMask;
+    VkAccessFlags2 accessMask;
+};
+
+/// Looks up how an image in the given layout was last accessed (asDestination = false)
+/// or is about to be accessed (asDestination = true)
+AstralCanvasVkResourceState AstralCanvasVk_GetImageLayoutState(VkImageLayout layout, bool asDestination);
+
+/// Collects barriers so that they can be recorded with a single vkCmdPipelineBarrier2 call,
+/// or a single vkCmdPipelineBarrier call on devices without synchronization2.
+/// Flushes early if more than ASTRALVULKAN_MAX_BATCHED_BARRIERS of a kind are added
+struct AstralCanvasVkBarrierBatch
+{
+    AstralVulkanGPU *gpu;
+    VkCommandBuffer commandBuffer;
+
+    VkImageMemoryBarrier2 imageBarriers[ASTRALVULKAN_MAX_BATCHED_BARRIERS];
+    u32 imageBarrierCount;
+    VkBufferMemoryBarrier2 bufferBarriers[ASTRALVULKAN_MAX_BATCHED_BARRIERS];
+    u32 bufferBarrierCount;
+    VkMemoryBarrier2 memoryBarrier;
+    bool hasMemoryBarrier;
+
+    AstralCanvasVkBarrierBatch(AstralVulkanGPU *gpu, VkCommandBuffer commandBuffer);
+
+    void TransitionImage(VkImage image, u32 mipLevels, VkImageAspectFlags aspectFlags, VkImageLayout oldLayout, VkImageLayout newLayout);
+    /// Waits on the texture's last recorded use rather than everything its layout could imply, and records the new one.
+    /// Nothing is recorded for reads following reads in the same layout
+    void AccessTexture(AstralCanvas::Texture2D *texture, VkImageAspectFlags aspectFlags, VkImageLayout newLayout, VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask);
+    /// AccessTexture with whatever the new layout is used for. Does nothing if the texture is already in the new layout
+    void TransitionTexture(AstralCanvas::Texture2D *texture, VkImageAspectFlags aspectFlags, VkImageLayout newLayout);
+    /// Like AccessTexture for the whole buffer. Nothing is recorded for the first use of a buffer or for reads following reads
+    void AccessBuffer(AstralCanvas::ComputeBuffer *buffer, VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask);
+    void BufferBarrier(VkBuffer buffer, usize offset, usize size, VkPipelineStageFlags2 srcStageMask, VkAccessFlags2 srcAccessMask, VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask);
+    /// Global barriers are merged into one
+    void GlobalBarrier(VkPipelineStageFlags2 srcStageMask, VkAccessFlags2 srcAccessMask, VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask);
+
+    /// Records all collected barriers into the command buffer and empties the batch
+    void Flush();
+};
+#endif
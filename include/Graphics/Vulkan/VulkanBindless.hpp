@@ -0,0 +1,30 @@
+#pragma once
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanGPU.hpp"
+#include "allocators.hpp"
+
+/// Upper bounds of the heap, further clamped to what the device allows for update after bind descriptors
+#define ASTRALVULKAN_BINDLESS_MAX_TEXTURES 16384
+#define ASTRALVULKAN_BINDLESS_MAX_SAMPLERS 1024
+#define ASTRALVULKAN_BINDLESS_TEXTURES_BINDING 0
+#define ASTRALVULKAN_BINDLESS_SAMPLERS_BINDING 1
+
+/// Creates the global descriptor set that every live texture and sampler is written into. Does nothing and succeeds
+/// on devices without descriptor indexing, in which case nothing is ever added to the heap
+bool AstralCanvasVk_CreateBindlessHeap(AstralVulkanGPU *gpu, IAllocator allocator);
+void AstralCanvasVk_DestroyBindlessHeap(AstralVulkanGPU *gpu);
+
+/// NULL if the heap is unavailable
+VkDescriptorSetLayout AstralCanvasVk_GetBindlessSetLayout();
+VkDescriptorSet AstralCanvasVk_GetBindlessSet();
+/// Stands in for the shader's own set in pipeline layouts of shaders that only use the heap
+VkDescriptorSetLayout AstralCanvasVk_GetEmptySetLayout();
+
+/// Writes the view into a free slot of the heap and returns its index, which stays the same for the lifetime of the
+/// texture. Returns 0 if the heap is unavailable or full, index 0 is never handed out
+u32 AstralCanvasVk_BindlessAddTexture(AstralVulkanGPU *gpu, VkImageView imageView);
+u32 AstralCanvasVk_BindlessAddSampler(AstralVulkanGPU *gpu, VkSampler sampler);
+/// Frees the slot. It is only handed out again once every frame that could still be reading it has retired
+void AstralCanvasVk_BindlessRemoveTexture(u32 index);
+void AstralCanvasVk_BindlessRemoveSampler(u32 index);
+#endif
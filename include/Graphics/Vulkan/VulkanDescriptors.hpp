@@ -0,0 +1,39 @@
+#pragma once
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanGPU.hpp"
+#include "allocators.hpp"
+
+/// How many sets each descriptor pool can hold. Once every pool is full another one is chained rather than failing
+#define ASTRALVULKAN_DESCRIPTOR_POOL_SETS 1024
+/// Cached sets that no draw has asked for in this many frames are evicted
+#define ASTRALVULKAN_DESCRIPTOR_SET_MAX_UNUSED_FRAMES 64
+
+/// The set's layout followed by every handle written into it, serialized by the caller as whole u64 words. Two sets
+/// with equal keys are interchangeable for as long as none of those handles is destroyed
+struct AstralCanvasVkDescriptorSetKey
+{
+    u8 *data;
+    usize size;
+    u32 hash;
+};
+
+/// Creates the first descriptor pool and the cache of written sets
+bool AstralCanvasVk_CreateDescriptorPools(AstralVulkanGPU *gpu, IAllocator allocator);
+void AstralCanvasVk_DestroyDescriptorPools(AstralVulkanGPU *gpu);
+
+/// Evicts sets that have gone unused for too long, and frees evicted sets the GPU has finished with. Must only be called
+/// after the current frame's fence has been waited on
+void AstralCanvasVk_RetireCachedDescriptorSets(AstralVulkanGPU *gpu);
+/// Allocates a set from the persistent pools, writing the pool it came from into pool. Safe to call from any thread
+VkDescriptorSet AstralCanvasVk_AllocateDescriptorSet(AstralVulkanGPU *gpu, VkDescriptorSetLayout setLayout, VkDescriptorPool *pool);
+
+/// Returns a set written earlier with the same key, this frame or any frame before it, or NULL if there is none
+VkDescriptorSet AstralCanvasVk_GetCachedDescriptorSet(AstralCanvasVkDescriptorSetKey key);
+/// Remembers a fully written set until it is evicted. The key data is copied
+void AstralCanvasVk_CacheDescriptorSet(VkDescriptorSetLayout setLayout, AstralCanvasVkDescriptorSetKey key, VkDescriptorSet set, VkDescriptorPool pool);
+/// Evicts every cached set of the layout, so that a layout created later with the same handle never matches them
+void AstralCanvasVk_EvictCachedDescriptorSets(VkDescriptorSetLayout setLayout);
+/// Evicts every cached set whose key contains the handle. Called whenever a buffer, image view or sampler is actually
+/// destroyed, since a resource created later may be given the same handle
+void AstralCanvasVk_EvictDescriptorSetsReferencing(u64 handle);
+#endif
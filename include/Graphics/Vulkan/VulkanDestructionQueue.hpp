@@ -0,0 +1,34 @@
+#pragma once
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanGPU.hpp"
+#include "Graphics/MemoryAllocation.hpp"
+#include "Graphics/Enums.hpp"
+#include "allocators.hpp"
+
+/// Resources released by deinit are queued here with the frame they were released on, and only destroyed once every
+/// frame that could still be using them has retired. This way resources can be freed at any time without idling the device
+bool AstralCanvasVk_CreateDestructionQueue(IAllocator allocator);
+/// Destroys everything still in the queue. The device must be idle
+void AstralCanvasVk_DestroyDestructionQueue(AstralVulkanGPU *gpu);
+
+/// Queues the buffer and, if memory is not NULL, its memory
+void AstralCanvasVk_QueueDestroyBuffer(VkBuffer buffer, AstralCanvas::GPUMemoryKind kind, AstralCanvas::MemoryAllocation *memory);
+/// Queues the image and, if memory is not NULL, its memory
+void AstralCanvasVk_QueueDestroyImage(VkImage image, AstralCanvas::GPUMemoryKind kind, AstralCanvas::MemoryAllocation *memory);
+void AstralCanvasVk_QueueDestroyImageView(VkImageView imageView);
+void AstralCanvasVk_QueueDestroySampler(VkSampler sampler);
+void AstralCanvasVk_QueueDestroyFramebuffer(VkFramebuffer framebuffer);
+void AstralCanvasVk_QueueDestroyPipeline(VkPipeline pipeline);
+void AstralCanvasVk_QueueDestroyPipelineLayout(VkPipelineLayout layout);
+void AstralCanvasVk_QueueDestroyRenderPass(VkRenderPass renderPass);
+void AstralCanvasVk_QueueDestroyDescriptorSetLayout(VkDescriptorSetLayout setLayout);
+/// Queues the pool along with every command buffer allocated from it
+void AstralCanvasVk_QueueDestroyCommandPool(VkCommandPool commandPool);
+/// Queues memory that is not owned by a single buffer or image, such as memory shared by aliased images
+void AstralCanvasVk_QueueFreeMemory(AstralCanvas::GPUMemoryKind kind, AstralCanvas::MemoryAllocation *memory);
+
+/// Destroys everything released on frames the GPU has finished with. Must only be called after the current frame's fence has been waited on
+void AstralCanvasVk_RetireDestructions(AstralVulkanGPU *gpu);
+/// Destroys everything in the queue regardless of when it was released. Must only be called while the device is idle
+void AstralCanvasVk_FlushDestructions(AstralVulkanGPU *gpu);
+#endif
@@ -10,8 +10,6 @@
 #include "string.hpp"
 #include "ErrorHandling.hpp"
 
-#define ASTRALVULKAN_MAX_DESCRIPTOR_SETS 1024
-
 VkBool32 AstralCanvasVk_ErrorCallback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity, VkDebugUtilsMessageTypeFlagsEXT messageTypes, const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData, void* pUserData);
 
 bool AstralCanvasVk_InitializeFor(IAllocator allocator, collections::Array<const char*> validationLayersToUse, collections::Array<const char*> requiredExtensions, AstralCanvas::Window *window);
@@ -169,7 +169,8 @@ inline VkDescriptorType AstralCanvasVk_FromResourceType(AstralCanvas::ShaderReso
         case AstralCanvas::ShaderResourceType::ShaderResourceType_Sampler:
             return VK_DESCRIPTOR_TYPE_SAMPLER;
         case AstralCanvas::ShaderResourceType::ShaderResourceType_Uniform:
-            return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            //uniform data lives in the per-frame uniform arena, the offset into it is supplied at bind time
+            return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         case AstralCanvas::ShaderResourceType::ShaderResourceType_StructuredBuffer:
             return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
         case AstralCanvas::ShaderResourceType::ShaderResourceType_InputAttachment:
@@ -10,6 +10,58 @@
 #include "string.hpp"
 #include "threading.hpp"
 
+/// Identifies a transient command buffer submission on a queue. Tickets on the same queue
+/// are handed out in submission order, and 0 is never a valid ticket
+typedef u64 AstralCanvasVkSubmitTicket;
+
+struct AstralCanvasVkPendingSubmission
+{
+    AstralCanvasVkSubmitTicket ticket;
+    VkFence fence;
+    VkCommandBuffer commandBuffer;
+    /// Threads currently waiting on the fence. The submission is not recycled while any are, so the fence
+    /// cannot be reset and handed to another submission in the middle of their wait
+    u32 waiters;
+};
+
+/// Tracks in-flight transient submissions of a queue so that their fences and command buffers
+/// can be recycled once the GPU is done with them. Lives behind a pointer since queues
+/// that fall back to the graphics queue are copies of it and must share the same state
+struct AstralCanvasVkSubmissionTracker
+{
+    threading::Mutex mutex;
+    AstralCanvasVkSubmitTicket nextTicket;
+    collections::vector<AstralCanvasVkPendingSubmission> pending;
+    collections::vector<VkFence> freeFences;
+    collections::vector<VkCommandBuffer> freeCommandBuffers;
+
+    inline AstralCanvasVkSubmissionTracker()
+    {
+        mutex = threading::Mutex::init();
+        nextTicket = 1;
+        pending = collections::vector<AstralCanvasVkPendingSubmission>(GetCAllocator());
+        freeFences = collections::vector<VkFence>(GetCAllocator());
+        freeCommandBuffers = collections::vector<VkCommandBuffer>(GetCAllocator());
+    }
+    inline void deinit(VkDevice logicalDevice)
+    {
+        for (usize i = 0; i < pending.count; i++)
+        {
+            vkWaitForFences(logicalDevice, 1, &pending.ptr[i].fence, true, UINT64_MAX);
+            vkDestroyFence(logicalDevice, pending.ptr[i].fence, NULL);
+        }
+        for (usize i = 0; i < freeFences.count; i++)
+        {
+            vkDestroyFence(logicalDevice, freeFences.ptr[i], NULL);
+        }
+        //command buffers are released alongside the transient command pool
+        pending.deinit();
+        freeFences.deinit();
+        freeCommandBuffers.deinit();
+        mutex.deinit();
+    }
+};
+
 struct AstralCanvasVkCommandQueue
 {
     VkDevice logicalDevice;
@@ -21,6 +73,8 @@ struct AstralCanvasVkCommandQueue
     VkCommandPool transientCommandPool;
     threading::Mutex commandPoolMutex;
 
+    AstralCanvasVkSubmissionTracker *submissions;
+
     inline AstralCanvasVkCommandQueue()
     {
         logicalDevice = NULL;
@@ -29,6 +83,7 @@ struct AstralCanvasVkCommandQueue
         transientCommandPool = NULL;
         commandPoolMutex = threading::Mutex();
         queueFence = NULL;
+        submissions = NULL;
     }
     inline AstralCanvasVkCommandQueue(VkDevice thisLogicalDevice, VkQueue thisQueue, VkFence thisQueueFence, VkCommandPool thisTransientCommandPool)
     {
@@ -38,9 +93,17 @@ struct AstralCanvasVkCommandQueue
         transientCommandPool = thisTransientCommandPool;
         queueMutex = threading::Mutex::init();
         commandPoolMutex = threading::Mutex::init();
+        submissions = (AstralCanvasVkSubmissionTracker *)malloc(sizeof(AstralCanvasVkSubmissionTracker));
+        *submissions = AstralCanvasVkSubmissionTracker();
     }
     inline void deinit()
     {
+        if (submissions != NULL)
+        {
+            submissions->deinit(logicalDevice);
+            free(submissions);
+            submissions = NULL;
+        }
         if (queueFence != NULL)
         {
             vkDestroyFence(logicalDevice, queueFence, NULL);
@@ -62,6 +125,20 @@ struct AstralVulkanGPU
     AstralVulkanQueueProperties queueInfo;
     VkPhysicalDeviceProperties properties;
     VkPhysicalDeviceFeatures features;
+    /// Whether vkCmdPipelineBarrier2 and friends were enabled on the logical device
+    bool supportsSynchronization2;
+    /// Whether vkCmdBeginRendering can be used in place of render pass and framebuffer objects
+    bool supportsDynamicRendering;
+    /// Whether the descriptor indexing features needed by the bindless heap were enabled on the logical device
+    bool supportsBindless;
+    /// Whether vkCmdDrawIndexedIndirect can be given more than one draw
+    bool supportsMultiDrawIndirect;
+    /// Whether indirect draws may set firstInstance to something other than 0
+    bool supportsDrawIndirectFirstInstance;
+    /// Whether vkCmdDrawIndexedIndirectCount can be used, which GPU culling results are drawn with
+    bool supportsDrawIndirectCount;
+    /// Whether VK_EXT_memory_budget was enabled, letting the allocator report the driver's real per heap budget
+    bool supportsMemoryBudget;
 
     AstralCanvasVkCommandQueue DedicatedGraphicsQueue;
     AstralCanvasVkCommandQueue DedicatedComputeQueue;
@@ -75,6 +152,13 @@ struct AstralVulkanGPU
         queueInfo = AstralVulkanQueueProperties();
         properties = {};
         features = {};
+        supportsSynchronization2 = false;
+        supportsDynamicRendering = false;
+        supportsBindless = false;
+        supportsMultiDrawIndirect = false;
+        supportsDrawIndirectFirstInstance = false;
+        supportsDrawIndirectCount = false;
+        supportsMemoryBudget = false;
         DedicatedGraphicsQueue = AstralCanvasVkCommandQueue();
         DedicatedComputeQueue = AstralCanvasVkCommandQueue();
         DedicatedTransferQueue = AstralCanvasVkCommandQueue();
@@ -87,6 +171,13 @@ struct AstralVulkanGPU
 
         vkGetPhysicalDeviceFeatures(thisPhysicalDevice, &this->features);
         vkGetPhysicalDeviceProperties(thisPhysicalDevice, &this->properties);
+        supportsSynchronization2 = false;
+        supportsDynamicRendering = false;
+        supportsBindless = false;
+        supportsMultiDrawIndirect = false;
+        supportsDrawIndirectFirstInstance = false;
+        supportsDrawIndirectCount = false;
+        supportsMemoryBudget = false;
 
         DedicatedGraphicsQueue = AstralCanvasVkCommandQueue();
         DedicatedComputeQueue = AstralCanvasVkCommandQueue();
@@ -96,6 +187,7 @@ struct AstralVulkanGPU
 bool AstralCanvasVk_SelectGPU(IAllocator allocator, VkInstance instance, VkSurfaceKHR windowSurface, collections::Array<const char *> requiredExtensions, AstralVulkanGPU *output);
 void AstralCanvasVk_ReleaseGPU(AstralVulkanGPU *gpu);
 bool AstralCanvasVk_GPUExtensionsSupported(AstralVulkanGPU *gpu);
+bool AstralCanvasVk_GPUSupportsExtension(AstralVulkanGPU *gpu, const char *extensionName);
 u32 AstralCanvasVk_GetGPUScore(AstralVulkanGPU* gpu, VkSurfaceKHR windowSurface);
 bool AstralCanvasVk_CreateLogicalDevice(AstralVulkanGPU* gpu, IAllocator allocator);
 #endif
@@ -5,12 +5,15 @@
 #include "Graphics/Vulkan/VulkanGPU.hpp"
 #include "Graphics/Vulkan/VulkanInstanceData.hpp"
 #include "Graphics/MemoryAllocation.hpp"
+#include "Graphics/Vulkan/VulkanMemoryStatistics.hpp"
 #include "Graphics/RenderTarget.hpp"
 #include "Graphics/RenderProgram.hpp"
 #include "Graphics/Shader.hpp"
 #include "Graphics/RenderPipeline.hpp"
 #include "ErrorHandling.hpp"
 
+#define ASTRALVULKAN_MAX_COLOR_ATTACHMENTS 8
+
 struct AstralCanvasVkTextureToTransition
 {
     AstralCanvas::Texture2D *texture;
@@ -21,7 +24,19 @@ struct AstralCanvasVkTextureToTransition
 VkBuffer AstralCanvasVk_CreateResourceBuffer(AstralVulkanGPU *gpu, usize size, VkBufferUsageFlags usageFlags);
 
 VkCommandBuffer AstralCanvasVk_CreateTransientCommandBuffer(AstralVulkanGPU *gpu, AstralCanvasVkCommandQueue *queueToUse, bool alsoBeginBuffer);
+/// Ends and submits the transient command buffer, then blocks until it has finished executing
 void AstralCanvasVk_EndTransientCommandBuffer(AstralVulkanGPU *gpu, AstralCanvasVkCommandQueue *queueToUse, VkCommandBuffer commandBuffer);
+/// Ends and submits the transient command buffer without waiting for it. The command buffer is recycled once the returned ticket retires
+AstralCanvasVkSubmitTicket AstralCanvasVk_SubmitTransientCommandBuffer(AstralVulkanGPU *gpu, AstralCanvasVkCommandQueue *queueToUse, VkCommandBuffer commandBuffer);
+/// Returns true once the GPU has finished executing the submission with the given ticket
+bool AstralCanvasVk_TransientSubmissionCompleted(AstralVulkanGPU *gpu, AstralCanvasVkCommandQueue *queueToUse, AstralCanvasVkSubmitTicket ticket);
+void AstralCanvasVk_AwaitTransientSubmission(AstralVulkanGPU *gpu, AstralCanvasVkCommandQueue *queueToUse, AstralCanvasVkSubmitTicket ticket);
+/// Recycles the fences and command buffers of all transient submissions the GPU has finished with
+void AstralCanvasVk_RetireTransientSubmissions(AstralVulkanGPU *gpu, AstralCanvasVkCommandQueue *queueToUse);
+
+/// Retrieves the formats of the attachments written by a pass, as needed by dynamic rendering.
+/// colorFormats must fit ASTRALVULKAN_MAX_COLOR_ATTACHMENTS. Returns the number of color attachments
+u32 AstralCanvasVk_GetPassAttachmentFormats(AstralCanvas::RenderProgram *program, u32 renderPass, VkFormat *colorFormats, VkFormat *depthFormat, VkFormat *stencilFormat);
 
 void AstralCanvasVk_CopyBufferToBuffer(AstralVulkanGPU *gpu, VkBuffer from, VkBuffer to, usize copySize);
 
@@ -32,7 +47,8 @@ void AstralCanvasVk_TransitionTextureLayouts(AstralVulkanGPU *gpu, AstralCanvasV
 void AstralCanvasVk_TransitionTextureLayout(AstralVulkanGPU *gpu, VkCommandBuffer commandBufferToUse, AstralCanvas::Texture2D *texture, VkImageAspectFlags aspectFlags, VkImageLayout newLayout);
 void AstralCanvasVk_TransitionImageLayout(AstralVulkanGPU *gpu, VkCommandBuffer commandBufferToUse, VkImage imageHandle, u32 mipLevels, VkImageAspectFlags aspectFlags, VkImageLayout oldLayout, VkImageLayout newLayout);
 
-inline AstralCanvas::MemoryAllocation AstralCanvasVk_AllocateMemoryForImage(VkImage image, VmaMemoryUsage memoryUsage, VkMemoryPropertyFlagBits memoryProperties)
+/// Allocates and binds memory for the image, counting it towards the given kind in the memory statistics
+inline AstralCanvas::MemoryAllocation AstralCanvasVk_AllocateMemoryForImage(VkImage image, AstralCanvas::GPUMemoryKind kind, VmaMemoryUsage memoryUsage, VkMemoryPropertyFlagBits memoryProperties)
 {
     VmaAllocator vma = AstralCanvasVk_GetCurrentVulkanAllocator();
 
@@ -40,18 +56,21 @@ inline AstralCanvas::MemoryAllocation AstralCanvasVk_AllocateMemoryForImage(VkIm
     allocationCreateInfo.usage = memoryUsage;
     allocationCreateInfo.requiredFlags = memoryProperties;
 
-    AstralCanvas::MemoryAllocation memoryAllocated;
+    AstralCanvas::MemoryAllocation memoryAllocated{};
 
     if (vmaAllocateMemoryForImage(vma, image, &allocationCreateInfo, &memoryAllocated.vkAllocation, &memoryAllocated.vkAllocationInfo) != VK_SUCCESS)
     {
         THROW_ERR("Failed to create memory for image");
+        return memoryAllocated;
     }
 
     vmaBindImageMemory(vma, memoryAllocated.vkAllocation, image);
+    AstralCanvasVk_TrackAllocation(kind, &memoryAllocated);
 
     return memoryAllocated;
 }
-inline AstralCanvas::MemoryAllocation AstralCanvasVk_AllocateMemoryForBuffer(VkBuffer buffer, VmaMemoryUsage memoryUsage, VkMemoryPropertyFlags memoryProperties, bool createMapped = true)
+/// Allocates and binds memory for the buffer, counting it towards the given kind in the memory statistics
+inline AstralCanvas::MemoryAllocation AstralCanvasVk_AllocateMemoryForBuffer(VkBuffer buffer, AstralCanvas::GPUMemoryKind kind, VmaMemoryUsage memoryUsage, VkMemoryPropertyFlags memoryProperties, bool createMapped = true)
 {
     VmaAllocator vma = AstralCanvasVk_GetCurrentVulkanAllocator();
     
@@ -68,10 +87,18 @@ inline AstralCanvas::MemoryAllocation AstralCanvasVk_AllocateMemoryForBuffer(VkB
     if (vmaAllocateMemoryForBuffer(vma, buffer, &allocationCreateInfo, &memoryAllocated.vkAllocation, &memoryAllocated.vkAllocationInfo) != VK_SUCCESS)
     {
         THROW_ERR("Failed to create memory for buffer");
+        return memoryAllocated;
     }
 
     vmaBindBufferMemory(AstralCanvasVk_GetCurrentVulkanAllocator(), memoryAllocated.vkAllocation, buffer);
+    AstralCanvasVk_TrackAllocation(kind, &memoryAllocated);
 
     return memoryAllocated;
 }
+/// Frees memory from one of the allocate functions above, kind must match the one it was allocated with
+inline void AstralCanvasVk_FreeMemory(AstralCanvas::GPUMemoryKind kind, AstralCanvas::MemoryAllocation *memory)
+{
+    AstralCanvasVk_UntrackAllocation(kind, memory);
+    vmaFreeMemory(AstralCanvasVk_GetCurrentVulkanAllocator(), memory->vkAllocation);
+}
 #endif
@@ -1,4 +1,8 @@
 #pragma once
+#define ASTRALVULKAN_DEFAULT_FRAMES_IN_FLIGHT 2
+#define ASTRALVULKAN_MIN_FRAMES_IN_FLIGHT 2
+#define ASTRALVULKAN_MAX_FRAMES_IN_FLIGHT 3
+
 #ifdef ASTRALCANVAS_VULKAN
 #include <Graphics/Vulkan/VulkanGPU.hpp>
 #include <Graphics/Vulkan/VulkanSwapchain.hpp>
@@ -25,18 +29,42 @@ void AstralCanvasVk_SetCurrentVulkanAllocator(VmaAllocator allocator);
 //AstralVulkanSwapchain *AstralCanvasVk_GetCurrentSwapchain();
 //void AstralCanvasVk_SetCurrentSwapchain(AstralVulkanSwapchain swapchain);
 
-VkSemaphore AstralCanvasVk_GetAwaitPresentCompleteSemaphore();
-void AstralCanvasVk_SetAwaitPresentCompleteSemaphore(VkSemaphore semaphore);
+/// Everything the CPU needs to record a frame while the GPU may still be processing
+/// up to (framesInFlight - 1) previous frames.
+struct AstralCanvasVkFrameData
+{
+    /// Signalled when the GPU has finished executing this frame's main command buffer
+    VkFence frameFence;
+    VkCommandPool commandPool;
+    VkCommandBuffer commandBuffer;
+    /// Signalled by the swapchain once the acquired image is ready to be rendered to
+    VkSemaphore awaitPresentCompleteSemaphore;
+    /// Signalled once rendering is done, awaited by present
+    VkSemaphore awaitRenderCompleteSemaphore;
+};
 
-VkSemaphore AstralCanvasVk_GetAwaitRenderCompleteSemaphore();
-void AstralCanvasVk_SetAwaitRenderCompleteSemaphore(VkSemaphore semaphore);
+/// Must be called before the backend is initialized. Clamped between ASTRALVULKAN_MIN_FRAMES_IN_FLIGHT and ASTRALVULKAN_MAX_FRAMES_IN_FLIGHT
+void AstralCanvasVk_SetFramesInFlight(u32 count);
+u32 AstralCanvasVk_GetFramesInFlight();
 
-VkCommandPool AstralCanvasVk_GetMainCmdPool();
-void AstralCanvasVk_SetMainCmdPool(VkCommandPool commandBuffer);
+u32 AstralCanvasVk_GetCurrentFrame();
+void AstralCanvasVk_SetCurrentFrame(u32 frame);
+/// Moves on to the next frame slot once the current frame has been submitted
+void AstralCanvasVk_AdvanceFrame();
+/// Counts every frame submitted since initialization, unlike the current frame it never wraps around
+u64 AstralCanvasVk_GetFrameNumber();
 
+AstralCanvasVkFrameData *AstralCanvasVk_GetFrameData(u32 frame);
+AstralCanvasVkFrameData *AstralCanvasVk_GetCurrentFrameData();
+
+VkSemaphore AstralCanvasVk_GetAwaitPresentCompleteSemaphore();
+VkSemaphore AstralCanvasVk_GetAwaitRenderCompleteSemaphore();
+VkCommandPool AstralCanvasVk_GetMainCmdPool();
+/// Returns the command buffer of the frame currently being recorded
 VkCommandBuffer AstralCanvasVk_GetMainCmdBuffer();
-void AstralCanvasVk_SetMainCmdBuffer(VkCommandBuffer commandBuffer);
 
-VkDescriptorPool AstralCanvasVk_GetDescriptorPool();
-void AstralCanvasVk_SetDescriptorPool(VkDescriptorPool pool);
+/// Whether single pass render programs should be drawn with dynamic rendering instead of render pass and framebuffer objects
+void AstralCanvasVk_SetDynamicRenderingEnabled(bool value);
+/// True only if dynamic rendering was enabled and the device supports it
+bool AstralCanvasVk_UseDynamicRendering();
 #endif
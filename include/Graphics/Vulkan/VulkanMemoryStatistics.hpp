@@ -0,0 +1,20 @@
+#pragma once
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/MemoryStatistics.hpp"
+#include "Graphics/MemoryAllocation.hpp"
+
+void AstralCanvasVk_CreateMemoryStatistics();
+void AstralCanvasVk_DestroyMemoryStatistics();
+
+/// Counts an allocation made for the given kind of resource. Safe to call from any thread
+void AstralCanvasVk_TrackAllocation(AstralCanvas::GPUMemoryKind kind, AstralCanvas::MemoryAllocation *memory);
+/// Must be called with the same kind the allocation was tracked with, before the memory is freed
+void AstralCanvasVk_UntrackAllocation(AstralCanvas::GPUMemoryKind kind, AstralCanvas::MemoryAllocation *memory);
+
+void AstralCanvasVk_GetMemoryStatistics(AstralCanvas::GPUMemoryStatistics *result);
+void AstralCanvasVk_ResetMemoryPeaks();
+void AstralCanvasVk_SetMemorySoftBudget(float budgetFraction, AstralCanvas::GPUMemoryBudgetCallback callback);
+/// Refreshes the allocator's budgets for the new frame, updates heap peaks and runs the soft budget callback.
+/// Called once at the start of every frame
+void AstralCanvasVk_UpdateMemoryBudgets(u64 frameNumber);
+#endif
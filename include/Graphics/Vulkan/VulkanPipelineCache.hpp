@@ -0,0 +1,20 @@
+#pragma once
+
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanGPU.hpp"
+
+/// Where the pipeline cache is read from on initialization and written back to. Must be called before the backend
+/// is initialized. NULL, the default, keeps the cache in memory only
+void AstralCanvasVk_SetPipelineCachePath(const char *path);
+const char *AstralCanvasVk_GetPipelineCachePath();
+
+/// Creates the process wide pipeline cache, seeding it with the contents of the cache file if it was written by the
+/// same vendor, device and driver. Stale or corrupted files are ignored
+bool AstralCanvasVk_CreatePipelineCache(AstralVulkanGPU *gpu);
+/// Pass to every vkCreateGraphicsPipelines and vkCreateComputePipelines call. NULL before the backend is initialized
+VkPipelineCache AstralCanvasVk_GetPipelineCache();
+/// Writes the current contents of the pipeline cache to the cache file
+bool AstralCanvasVk_SavePipelineCache(AstralVulkanGPU *gpu);
+/// Saves and then destroys the pipeline cache
+void AstralCanvasVk_DestroyPipelineCache(AstralVulkanGPU *gpu);
+#endif
@@ -0,0 +1,29 @@
+#pragma once
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanGPU.hpp"
+#include "allocators.hpp"
+
+/// Every byte of state that affects the compiled pipeline, serialized by the caller. Two pipelines with equal
+/// keys are interchangeable
+struct AstralCanvasVkPipelineStateKey
+{
+    u8 *data;
+    usize size;
+    u32 hash;
+};
+
+bool AstralCanvasVk_CreatePipelineRegistry(IAllocator allocator);
+/// Destroys every pipeline and layout still held by the registry
+void AstralCanvasVk_DestroyPipelineRegistry(AstralVulkanGPU *gpu);
+
+/// Returns the layout shared by every pipeline using the given descriptor set layouts and push constant range, creating
+/// it on first use. setLayout may be NULL for shaders without any descriptors, pushConstantsSize 0 for shaders without
+/// push constants and bindlessSetLayout NULL for shaders that do not read from the bindless heap
+VkPipelineLayout AstralCanvasVk_AcquirePipelineLayout(AstralVulkanGPU *gpu, VkDescriptorSetLayout setLayout, u32 pushConstantsSize = 0, VkShaderStageFlags pushConstantsStages = 0, VkDescriptorSetLayout bindlessSetLayout = NULL);
+void AstralCanvasVk_ReleasePipelineLayout(AstralVulkanGPU *gpu, VkPipelineLayout layout);
+
+/// Returns an existing pipeline with the same state key, or compiles one from createInfo. Every acquire must be
+/// matched by a release
+VkPipeline AstralCanvasVk_AcquirePipeline(AstralVulkanGPU *gpu, AstralCanvasVkPipelineStateKey key, VkGraphicsPipelineCreateInfo *createInfo);
+void AstralCanvasVk_ReleasePipeline(AstralVulkanGPU *gpu, VkPipeline pipeline);
+#endif
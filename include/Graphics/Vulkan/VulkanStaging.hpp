@@ -0,0 +1,36 @@
+#pragma once
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanGPU.hpp"
+#include "Graphics/MemoryAllocation.hpp"
+
+#define ASTRALVULKAN_STAGING_RING_SIZE (32 * 1024 * 1024)
+#define ASTRALVULKAN_STAGING_ALIGNMENT 16
+
+/// A region of host visible memory that upload data can be written into before
+/// being copied to its destination by the pending staging batch
+struct AstralCanvasVkStagingRegion
+{
+    VkBuffer buffer;
+    usize offset;
+    usize size;
+    void *mappedData;
+};
+
+/// Creates the persistently mapped ring that all uploads are staged through
+bool AstralCanvasVk_CreateStagingRing(AstralVulkanGPU *gpu, usize size);
+/// Waits for all staged uploads to complete, then releases the ring
+void AstralCanvasVk_DestroyStagingRing(AstralVulkanGPU *gpu);
+
+/// Copies data into an aligned region of the staging ring and records a copy from it into the pending staging batch.
+/// Uploads larger than half the ring get a dedicated buffer that is released once the batch it was copied in retires
+void AstralCanvasVk_StageBufferUpload(AstralVulkanGPU *gpu, void *data, usize size, VkBuffer to, usize toOffset);
+/// Like StageBufferUpload, but copies into the first mip of the image, leaving it in shader read only layout
+void AstralCanvasVk_StageImageUpload(AstralVulkanGPU *gpu, void *data, usize size, VkImage to, u32 mipLevels, VkImageAspectFlags aspectFlags, u32 width, u32 height);
+
+/// Submits all copies recorded since the last flush as a single command buffer on the graphics queue.
+/// Returns 0 if there was nothing to submit
+AstralCanvasVkSubmitTicket AstralCanvasVk_FlushStaging(AstralVulkanGPU *gpu);
+/// Flushes the pending staging batch and blocks until every staged upload has completed. Must be called before
+/// submitting work outside of the frame command buffer that may read from or transition uploaded resources
+void AstralCanvasVk_AwaitStaging(AstralVulkanGPU *gpu);
+#endif
@@ -0,0 +1,30 @@
+#pragma once
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanGPU.hpp"
+#include "allocators.hpp"
+
+/// Size of each block of a frame's uniform arena. A frame that runs out chains another block rather than failing.
+/// Blocks can also be read as indirect draw buffers, so merged draw commands are sub-allocated from the same arena
+#define ASTRALVULKAN_UNIFORM_ARENA_BLOCK_SIZE (4 * 1024 * 1024)
+
+/// A region of persistently mapped uniform memory, bound by passing offset as the dynamic offset of the
+/// uniform's descriptor
+struct AstralCanvasVkUniformAllocation
+{
+    VkBuffer buffer;
+    u32 offset;
+    void *mappedData;
+};
+
+/// Creates the first arena block of every frame in flight
+bool AstralCanvasVk_CreateUniformArenas(AstralVulkanGPU *gpu, IAllocator allocator);
+void AstralCanvasVk_DestroyUniformArenas(AstralVulkanGPU *gpu);
+
+/// Rewinds the given frame's arena. Must only be called after that frame's fence has been waited on
+void AstralCanvasVk_ResetFrameUniformArena(u32 frame);
+/// Bump allocates size bytes from the current frame's arena, aligned to minUniformBufferOffsetAlignment. The memory
+/// stays valid until the current frame comes around again. Safe to call from any thread
+AstralCanvasVkUniformAllocation AstralCanvasVk_AllocateFrameUniform(AstralVulkanGPU *gpu, usize size);
+/// Same as AllocateFrameUniform, but aligned for indirect draw commands. The offset is passed to vkCmdDrawIndexedIndirect
+AstralCanvasVkUniformAllocation AstralCanvasVk_AllocateFrameIndirect(AstralVulkanGPU *gpu, usize size);
+#endif
@@ -1,6 +1,8 @@
 #include "Application.hpp"
 #include "Graphics/WGPU/WgpuEngine.hpp"
 #include "Graphics/Vulkan/VulkanEngine.hpp"
+#include "Graphics/Vulkan/VulkanInstanceData.hpp"
+#include "Graphics/Vulkan/VulkanPipelineCache.hpp"
 #include "Graphics/Metal/MetalEngine.h"
 #include "Graphics/Glad/glad.h"
 #include "GLFW/glfw3.h"
@@ -26,6 +28,9 @@ namespace AstralCanvas
     {
         Application result;
         result.framesPerSecond = framesPerSecond;
+        result.framesInFlight = ASTRALVULKAN_DEFAULT_FRAMES_IN_FLIGHT;
+        result.useDynamicRendering = false;
+        result.pipelineCachePath = NULL;
         result.allocator = allocator;
         result.windows = vector<Window>(allocator);
         result.appName = appName;
@@ -65,6 +70,9 @@ namespace AstralCanvas
                 collections::Array<const char *> requiredExtensions = collections::Array<const char *>(allocator, 1);
                 requiredExtensions.data[0] = VK_KHR_SWAPCHAIN_EXTENSION_NAME;
 
+                AstralCanvasVk_SetFramesInFlight(this->framesInFlight);
+                AstralCanvasVk_SetDynamicRenderingEnabled(this->useDynamicRendering);
+                AstralCanvasVk_SetPipelineCachePath(this->pipelineCachePath);
                 for (usize i = 0; i < this->windows.count; i++)
                 {
                     AstralCanvasVk_InitializeFor(this->allocator, validationLayersToUse, requiredExtensions, this->windows.Get(i));
@@ -106,8 +114,24 @@ namespace AstralCanvas
                 THROW_ERR("Unrecognised backend");
         }
         this->graphicsDevice.usedShaders = collections::hashset<AstralCanvas::Shader*>(this->allocator, &PointerHash<AstralCanvas::Shader>, &PointerEql<AstralCanvas::Shader>);
+        this->graphicsDevice.secondaryCommands = collections::vector<AstralCanvas::GraphicsSecondaryCommands>(this->allocator);
+        this->graphicsDevice.secondaryCommandBuffers = collections::vector<void *>(this->allocator);
+        this->graphicsDevice.mergedDraws = collections::vector<AstralCanvas::DrawIndexedIndirectCommand>(this->allocator);
+        this->graphicsDevice.secondaryCommandsMutex = threading::Mutex::init();
         return true;
     }
+    bool Application::SavePipelineCache()
+    {
+        switch (GetActiveBackend())
+        {
+#ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+                return AstralCanvasVk_SavePipelineCache(AstralCanvasVk_GetCurrentGPU());
+#endif
+            default:
+                return false;
+        }
+    }
     void Application::ResetDeltaTimer()
     {
         glfwSetTime(0.0);
@@ -212,17 +236,19 @@ namespace AstralCanvas
                         graphicsDevice.currentRenderPipeline = NULL;
                         graphicsDevice.currentRenderProgram = NULL;
                         graphicsDevice.currentRenderTarget = NULL;
+                        graphicsDevice.ResetBoundState();
                         for (usize i = 0; i < graphicsDevice.usedShaders.bucketsCount; i++)
                         {
                             if (graphicsDevice.usedShaders.buckets[i].initialized)
                             {
                                 for (usize j = 0; j < graphicsDevice.usedShaders.buckets[i].entries.count; j++)
                                 {
-                                    graphicsDevice.usedShaders.buckets[i].entries.ptr[j]->descriptorForThisDrawCall = 0;
+                                    graphicsDevice.usedShaders.buckets[i].entries.ptr[j]->ResetDescriptorSlots();
                                 }
                                 graphicsDevice.usedShaders.buckets[i].entries.Clear();
                             }
                         }
+                        graphicsDevice.usedShaders.Count = 0;
                         switch (AstralCanvas::GetActiveBackend())
                         {
                             #ifdef ASTRALCANVAS_VULKAN
@@ -270,6 +296,10 @@ namespace AstralCanvas
         }
 
         this->graphicsDevice.usedShaders.deinit();
+        this->graphicsDevice.secondaryCommands.deinit();
+        this->graphicsDevice.secondaryCommandBuffers.deinit();
+        this->graphicsDevice.mergedDraws.deinit();
+        this->graphicsDevice.secondaryCommandsMutex.deinit();
 
         //await rendering process shutdown
         switch (AstralCanvas::GetActiveBackend())
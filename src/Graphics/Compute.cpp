@@ -7,6 +7,10 @@
 #include "Graphics/Vulkan/VulkanInstanceData.hpp"
 #include "Graphics/Vulkan/VulkanEnumConverters.hpp"
 #include "Graphics/Vulkan/VulkanHelpers.hpp"
+#include "Graphics/Vulkan/VulkanPipelineCache.hpp"
+#include "Graphics/Vulkan/VulkanBindless.hpp"
+#include "Graphics/Vulkan/VulkanStaging.hpp"
+#include "Graphics/Vulkan/VulkanDestructionQueue.hpp"
 #endif
 
 #ifdef ASTRALCANVAS_OPENGL
@@ -47,8 +51,26 @@ namespace AstralCanvas
                     pipelineLayoutCreateInfo.pPushConstantRanges = NULL;
                     pipelineLayoutCreateInfo.flags = 0;
 
+                    VkPushConstantRange pushConstantRange{};
+                    if (shader->shaderVariables.pushConstantsSize > 0)
+                    {
+                        pushConstantRange.offset = 0;
+                        pushConstantRange.size = shader->shaderVariables.pushConstantsSize;
+                        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+                        pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+                        pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+                    }
+
                     pipelineLayoutCreateInfo.setLayoutCount = 0;
-                    if (shader->shaderPipelineLayout != NULL)
+                    VkDescriptorSetLayout setLayouts[2];
+                    if (shader->shaderVariables.usesBindlessHeap && AstralCanvasVk_GetBindlessSetLayout() != NULL)
+                    {
+                        setLayouts[0] = shader->shaderPipelineLayout != NULL ? (VkDescriptorSetLayout)shader->shaderPipelineLayout : AstralCanvasVk_GetEmptySetLayout();
+                        setLayouts[1] = AstralCanvasVk_GetBindlessSetLayout();
+                        pipelineLayoutCreateInfo.setLayoutCount = 2;
+                        pipelineLayoutCreateInfo.pSetLayouts = setLayouts;
+                    }
+                    else if (shader->shaderPipelineLayout != NULL)
                     {
                         pipelineLayoutCreateInfo.setLayoutCount = 1;
                         pipelineLayoutCreateInfo.pSetLayouts = (VkDescriptorSetLayout*)&shader->shaderPipelineLayout;
@@ -72,7 +94,7 @@ namespace AstralCanvas
                 pipelineCreateInfo.layout = layout;
 
                 VkPipeline pipeline;
-                if (vkCreateComputePipelines(AstralCanvasVk_GetCurrentGPU()->logicalDevice, NULL, 1, &pipelineCreateInfo, NULL, &pipeline) != VK_SUCCESS)
+                if (vkCreateComputePipelines(AstralCanvasVk_GetCurrentGPU()->logicalDevice, AstralCanvasVk_GetPipelineCache(), 1, &pipelineCreateInfo, NULL, &pipeline) != VK_SUCCESS)
                 {
                     string errMsg = string(GetCAllocator(), "Failed to create compute pipeline for shader");
                     THROW_ERR(errMsg.buffer);
@@ -117,8 +139,12 @@ namespace AstralCanvas
             #ifdef ASTRALCANVAS_VULKAN
             case Backend_Vulkan:
             {
-                shader->uniformsHasBeenSet = false;
-                shader->SyncUniformsWithGPU(NULL);
+                //dispatching again without setting anything reuses the variables still staged in the last slot
+                ShaderDrawState *drawState = &shader->drawState;
+                shader->SyncUniformsWithGPU(NULL, drawState);
+
+                //the dispatch runs on its own queue, so uploads it reads from must have landed first
+                AstralCanvasVk_AwaitStaging(AstralCanvasVk_GetCurrentGPU());
 
                 AstralCanvasVkCommandQueue* queueToUse = &AstralCanvasVk_GetCurrentGPU()->DedicatedComputeQueue;
                 VkCommandBuffer commandBuffer = AstralCanvasVk_CreateTransientCommandBuffer(AstralCanvasVk_GetCurrentGPU(), queueToUse, true);
@@ -129,14 +155,27 @@ namespace AstralCanvas
                     VK_PIPELINE_BIND_POINT_COMPUTE, 
                     (VkPipelineLayout)layout, 
                     0, 1, //descriptor set count
-                    (VkDescriptorSet*)&shader->descriptorSets.ptr[shader->descriptorForThisDrawCall],
-                    0, NULL); //dynamic offsets count
+                    (VkDescriptorSet*)&drawState->descriptorSet,
+                    drawState->dynamicOffsetCount, drawState->dynamicOffsets);
+                if (shader->shaderVariables.usesBindlessHeap && AstralCanvasVk_GetBindlessSet() != NULL)
+                {
+                    VkDescriptorSet bindlessSet = AstralCanvasVk_GetBindlessSet();
+                    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, (VkPipelineLayout)layout, ASTRALCANVAS_BINDLESS_SET, 1, &bindlessSet, 0, NULL);
+                }
 
                 vkCmdDispatch(commandBuffer, threadsX, threadsY, threadsZ);
 
+                //makes the results readable from mapped memory once the submission has been waited on
+                VkMemoryBarrier hostBarrier{};
+                hostBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+                hostBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+                hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+                vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &hostBarrier, 0, NULL, 0, NULL);
+
                 AstralCanvasVk_EndTransientCommandBuffer(AstralCanvasVk_GetCurrentGPU(), queueToUse, commandBuffer);
                 
-                shader->descriptorForThisDrawCall = 0;
+                //everything the dispatch reads was copied out when syncing, so its slot can be claimed again straight away
+                shader->ResetDescriptorSlots();
                 break;
             }
             #endif
@@ -164,8 +203,8 @@ namespace AstralCanvas
             #ifdef ASTRALCANVAS_VULKAN
             case Backend_Vulkan:
             {
-                vkDestroyPipelineLayout(AstralCanvasVk_GetCurrentGPU()->logicalDevice, (VkPipelineLayout)layout, NULL);
-                vkDestroyPipeline(AstralCanvasVk_GetCurrentGPU()->logicalDevice, (VkPipeline)handle, NULL);
+                AstralCanvasVk_QueueDestroyPipelineLayout((VkPipelineLayout)layout);
+                AstralCanvasVk_QueueDestroyPipeline((VkPipeline)handle);
                 break;
             }
             #endif
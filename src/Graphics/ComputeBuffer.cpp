@@ -4,6 +4,8 @@
 #ifdef ASTRALCANVAS_VULKAN
 #include "Graphics/Vulkan/VulkanHelpers.hpp"
 #include "Graphics/Vulkan/vk_mem_alloc.h"
+#include "Graphics/Vulkan/VulkanDestructionQueue.hpp"
+#include "Graphics/Vulkan/VulkanBarriers.hpp"
 #endif
 
 #ifdef ASTRALCANVAS_METAL
@@ -26,6 +28,8 @@ namespace AstralCanvas
         handle = NULL;
         elementCount = 0;
         elementSize = 0;
+        usageStageMask = 0;
+        usageAccessMask = 0;
 
         memoryAllocation.unused = 0;
     }
@@ -38,6 +42,8 @@ namespace AstralCanvas
         this->accessedAsIndirectDrawData = accessedAsIndirectDrawData;
         this->CPUCanRead = CPUCanRead;
         this->memoryAllocation.unused = 0;
+        this->usageStageMask = 0;
+        this->usageAccessMask = 0;
 
         this->Construct();
     }
@@ -52,14 +58,14 @@ namespace AstralCanvas
                 /*usize lengthOfBytes = elementsToSet * elementSize;
                 AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
                 VkBuffer stagingBuffer = AstralCanvasVk_CreateResourceBuffer(gpu, lengthOfBytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
-                MemoryAllocation stagingMemory = AstralCanvasVk_AllocateMemoryForBuffer(stagingBuffer, VMA_MEMORY_USAGE_CPU_TO_GPU, (VkMemoryPropertyFlagBits)(VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT));
+                MemoryAllocation stagingMemory = AstralCanvasVk_AllocateMemoryForBuffer(stagingBuffer, AstralCanvas::GPUMemoryKind_Staging, VMA_MEMORY_USAGE_CPU_TO_GPU, (VkMemoryPropertyFlagBits)(VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT));
 
                 memcpy(stagingMemory.vkAllocationInfo.pMappedData, bytes, lengthOfBytes);
 
                 AstralCanvasVk_CopyBufferToBuffer(gpu, stagingBuffer, (VkBuffer)this->handle, lengthOfBytes);
 
                 vkDestroyBuffer(gpu->logicalDevice, stagingBuffer, NULL);
-                vmaFreeMemory(AstralCanvasVk_GetCurrentVulkanAllocator(), stagingMemory.vkAllocation);*/
+                AstralCanvasVk_FreeMemory(AstralCanvas::GPUMemoryKind_Staging, &stagingMemory);*/
 
                 break;
             }
@@ -88,7 +94,7 @@ namespace AstralCanvas
                     usize lengthOfBytes = elementCount * elementSize;
                     AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
                     VkBuffer stagingBuffer = AstralCanvasVk_CreateResourceBuffer(gpu, lengthOfBytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT);
-                    MemoryAllocation stagingMemory = AstralCanvasVk_AllocateMemoryForBuffer(stagingBuffer, VMA_MEMORY_USAGE_GPU_TO_CPU, (VkMemoryPropertyFlagBits)(VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT));
+                    MemoryAllocation stagingMemory = AstralCanvasVk_AllocateMemoryForBuffer(stagingBuffer, AstralCanvas::GPUMemoryKind_Staging, VMA_MEMORY_USAGE_GPU_TO_CPU, (VkMemoryPropertyFlagBits)(VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT));
 
                     AstralCanvasVk_CopyBufferToBuffer(gpu, (VkBuffer)this->handle, stagingBuffer, lengthOfBytes);
 
@@ -96,7 +102,7 @@ namespace AstralCanvas
                     memcpy(result, stagingMemory.vkAllocationInfo.pMappedData, lengthOfBytes);
 
                     vkDestroyBuffer(gpu->logicalDevice, stagingBuffer, NULL);
-                    vmaFreeMemory(AstralCanvasVk_GetCurrentVulkanAllocator(), stagingMemory.vkAllocation);
+                    AstralCanvasVk_FreeMemory(AstralCanvas::GPUMemoryKind_Staging, &stagingMemory);
 
                     if (dataLength != NULL)
                     {
@@ -156,7 +162,7 @@ namespace AstralCanvas
                 }
                 this->handle = AstralCanvasVk_CreateResourceBuffer(AstralCanvasVk_GetCurrentGPU(), size, usageFlags);
 
-                this->memoryAllocation = AstralCanvasVk_AllocateMemoryForBuffer((VkBuffer)this->handle, VMA_MEMORY_USAGE_CPU_TO_GPU, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+                this->memoryAllocation = AstralCanvasVk_AllocateMemoryForBuffer((VkBuffer)this->handle, AstralCanvas::GPUMemoryKind_Compute, VMA_MEMORY_USAGE_CPU_TO_GPU, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
                 break;
             }
             #endif
@@ -188,11 +194,44 @@ namespace AstralCanvas
             {
                 AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
                 VkCommandBuffer transientCmdBuffer = AstralCanvasVk_CreateTransientCommandBuffer(gpu, &gpu->DedicatedTransferQueue, true);
+                //a buffer flagged more than once is only filled once, so that none of the fills has to wait on another
+                usize uniqueCount = 0;
+                for (usize i = 0; i < computeBuffersToClear.count; i++)
+                {
+                    bool flaggedBefore = false;
+                    for (usize j = 0; j < uniqueCount; j++)
+                    {
+                        if (computeBuffersToClear.ptr[j] == computeBuffersToClear.ptr[i])
+                        {
+                            flaggedBefore = true;
+                            break;
+                        }
+                    }
+                    if (!flaggedBefore)
+                    {
+                        computeBuffersToClear.ptr[uniqueCount] = computeBuffersToClear.ptr[i];
+                        uniqueCount += 1;
+                    }
+                }
+                computeBuffersToClear.count = uniqueCount;
+
+                AstralCanvasVkBarrierBatch barriers = AstralCanvasVkBarrierBatch(gpu, transientCmdBuffer);
+                for (usize i = 0; i < computeBuffersToClear.count; i++)
+                {
+                    barriers.AccessBuffer(computeBuffersToClear.ptr[i], VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+                }
+                barriers.Flush();
                 for (usize i = 0; i < computeBuffersToClear.count; i++)
                 {
                     vkCmdFillBuffer(transientCmdBuffer, (VkBuffer)computeBuffersToClear.ptr[i]->handle, 0, computeBuffersToClear.ptr[i]->elementCount * computeBuffersToClear.ptr[i]->elementSize, 0);
                 }
                 AstralCanvasVk_EndTransientCommandBuffer(gpu, &gpu->DedicatedTransferQueue, transientCmdBuffer);
+                //the fills have been waited on, so nothing later has to wait on them again
+                for (usize i = 0; i < computeBuffersToClear.count; i++)
+                {
+                    computeBuffersToClear.ptr[i]->usageStageMask = 0;
+                    computeBuffersToClear.ptr[i]->usageAccessMask = 0;
+                }
                 break;
             }
             #endif
@@ -215,11 +254,7 @@ namespace AstralCanvas
             #ifdef ASTRALCANVAS_VULKAN
             case Backend_Vulkan:
             {
-                AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
-
-                vkDestroyBuffer(gpu->logicalDevice, (VkBuffer)this->handle, NULL);
-
-                vmaFreeMemory(AstralCanvasVk_GetCurrentVulkanAllocator(), this->memoryAllocation.vkAllocation);
+                AstralCanvasVk_QueueDestroyBuffer((VkBuffer)this->handle, AstralCanvas::GPUMemoryKind_Compute, &this->memoryAllocation);
                 break;
             }
             #endif
@@ -0,0 +1,92 @@
+#include "Graphics/DynamicBufferRegions.hpp"
+#include "Graphics/CurrentBackend.hpp"
+#include <string.h>
+
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanInstanceData.hpp"
+#endif
+
+namespace AstralCanvas
+{
+    DynamicBufferRegions::DynamicBufferRegions()
+    {
+        this->regionSize = 0;
+        this->regionCount = 1;
+        this->currentRegion = 0;
+        this->writtenFrameNumber = 0;
+    }
+    DynamicBufferRegions::DynamicBufferRegions(usize regionSize)
+    {
+        this->regionSize = regionSize;
+        this->regionCount = 1;
+        this->currentRegion = 0;
+        this->writtenFrameNumber = 0;
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                this->regionCount = AstralCanvasVk_GetFramesInFlight();
+                break;
+            }
+            #endif
+            //OpenGL orphans the old storage when a buffer is rewritten, so a single region is enough there
+            default:
+                break;
+        }
+    }
+    bool DynamicBufferRegions::WillMoveToNextRegion()
+    {
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+                return this->writtenFrameNumber != AstralCanvasVk_GetFrameNumber();
+            #endif
+            default:
+                return false;
+        }
+    }
+    usize DynamicBufferRegions::BeginWrite()
+    {
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                //moving on at most once per frame means a region is only written again after every frame that could have
+                //bound it has waited on its fence
+                if (this->WillMoveToNextRegion())
+                {
+                    this->currentRegion = (this->currentRegion + 1) % this->regionCount;
+                    this->writtenFrameNumber = AstralCanvasVk_GetFrameNumber();
+                }
+                break;
+            }
+            #endif
+            default:
+                break;
+        }
+        return this->GetCurrentOffset();
+    }
+    usize DynamicBufferRegions::BeginPartialWrite(u8 *mappedData, usize writeOffset)
+    {
+        if (!this->WillMoveToNextRegion())
+        {
+            return this->GetCurrentOffset();
+        }
+        //host visible memory is usually uncached, so only carry the last region over when the write builds on it
+        if (writeOffset == 0)
+        {
+            return this->BeginWrite();
+        }
+        //the last region may still be read by a frame in flight, but the GPU never writes to it so reading it here is safe
+        usize previousOffset = this->GetCurrentOffset();
+        usize offset = this->BeginWrite();
+        if (offset != previousOffset)
+        {
+            memcpy(mappedData + offset, mappedData + previousOffset, this->regionSize);
+        }
+        return offset;
+    }
+}
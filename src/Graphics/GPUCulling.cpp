@@ -0,0 +1,257 @@
+#include "Graphics/GPUCulling.hpp"
+#include "Graphics/CurrentBackend.hpp"
+#include "ErrorHandling.hpp"
+#include <math.h>
+
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanInstanceData.hpp"
+#include "Graphics/Vulkan/VulkanBarriers.hpp"
+#endif
+
+namespace AstralCanvas
+{
+    /// Matches CullingData in the shader, which is laid out with std140
+    struct GPUCullingData
+    {
+        float planes[6][4];
+        u32 instanceCount;
+        u32 maxDraws;
+        u32 padding[2];
+    };
+
+    GPUCullingPass::GPUCullingPass()
+    {
+        this->shader = NULL;
+        this->pipeline = ComputePipeline();
+        this->maxDraws = 0;
+        for (u32 frame = 0; frame < ASTRALCANVAS_GPUCULLING_BUFFERED_FRAMES; frame++)
+        {
+            for (u32 i = 0; i < ASTRALCANVAS_GPUCULLING_MAX_CULLS_PER_FRAME; i++)
+            {
+                this->outputs[frame][i] = {};
+            }
+        }
+        this->currentOutput = NULL;
+        this->cullFrameNumber = 0;
+        this->cullsThisFrame = 0;
+        this->readBackDrawCount = false;
+        this->cullingDataHandle = {-1, ShaderResourceType_Uniform};
+        this->instancesHandle = {-1, ShaderResourceType_StructuredBuffer};
+        this->drawRecordsHandle = {-1, ShaderResourceType_StructuredBuffer};
+        this->drawCommandsHandle = {-1, ShaderResourceType_StructuredBuffer};
+        this->drawCountHandle = {-1, ShaderResourceType_StructuredBuffer};
+    }
+    GPUCullingPass::GPUCullingPass(Shader *cullingShader, u32 maxDraws) : GPUCullingPass()
+    {
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
+                //every command draws its instance through firstInstance, there is nothing to fall back to without it
+                if (!gpu->supportsDrawIndirectFirstInstance)
+                {
+                    THROW_ERR("GPU culling requires the drawIndirectFirstInstance feature");
+                    return;
+                }
+                this->readBackDrawCount = !gpu->supportsDrawIndirectCount;
+                break;
+            }
+            #endif
+            default:
+                break;
+        }
+        this->shader = cullingShader;
+        this->pipeline = ComputePipeline(cullingShader);
+        this->maxDraws = maxDraws;
+        //reflection names buffer blocks by their block type rather than their instance name
+        this->cullingDataHandle = cullingShader->GetVariableHandle("CullingData");
+        this->instancesHandle = cullingShader->GetVariableHandle("Instances");
+        this->drawRecordsHandle = cullingShader->GetVariableHandle("DrawRecords");
+        this->drawCommandsHandle = cullingShader->GetVariableHandle("DrawCommands");
+        this->drawCountHandle = cullingShader->GetVariableHandle("DrawCount");
+        if (this->cullingDataHandle.binding < 0 || this->instancesHandle.binding < 0 || this->drawRecordsHandle.binding < 0 || this->drawCommandsHandle.binding < 0 || this->drawCountHandle.binding < 0)
+        {
+            THROW_ERR("GPU culling shader is missing variables, was it compiled from GPUCulling.shader?");
+        }
+    }
+
+    inline void GPUCullingSetPlane(float *plane, float a, float b, float c, float d)
+    {
+        float length = sqrtf(a * a + b * b + c * c);
+        float inverse = length > 0.0f ? 1.0f / length : 0.0f;
+        plane[0] = a * inverse;
+        plane[1] = b * inverse;
+        plane[2] = c * inverse;
+        plane[3] = d * inverse;
+    }
+
+    /// Returns the output buffers for the next Cull, creating them if this is the first time they are used
+    GPUCullingOutput *GPUCullingPass_NextOutput(GPUCullingPass *pass)
+    {
+        u64 frameNumber = 0;
+        u32 framesInFlight = 1;
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                frameNumber = AstralCanvasVk_GetFrameNumber();
+                framesInFlight = AstralCanvasVk_GetFramesInFlight();
+                break;
+            }
+            #endif
+            default:
+                break;
+        }
+        if (frameNumber != pass->cullFrameNumber)
+        {
+            pass->cullFrameNumber = frameNumber;
+            pass->cullsThisFrame = 0;
+        }
+        if (pass->cullsThisFrame >= ASTRALCANVAS_GPUCULLING_MAX_CULLS_PER_FRAME)
+        {
+            if (GetActiveBackend() == Backend_Vulkan)
+            {
+                THROW_ERR("GPU culling pass was culled more than ASTRALCANVAS_GPUCULLING_MAX_CULLS_PER_FRAME times in one frame");
+                return NULL;
+            }
+            //other backends synchronize buffer reuse themselves, so outputs can simply be cycled through
+            pass->cullsThisFrame = 0;
+        }
+
+        GPUCullingOutput *output = &pass->outputs[frameNumber % framesInFlight][pass->cullsThisFrame];
+        pass->cullsThisFrame += 1;
+        if (output->drawCommands.handle == NULL)
+        {
+            output->drawCommands = ComputeBuffer(sizeof(DrawIndexedIndirectCommand), pass->maxDraws, false, true);
+            //the count is only ever copied back when it cannot be drawn from directly
+            output->drawCount = ComputeBuffer(sizeof(u32), 1, false, true, pass->readBackDrawCount);
+        }
+        output->visibleCount = 0;
+        return output;
+    }
+
+    GPUCullingOutput *GPUCullingPass::Cull(Graphics *graphics, ComputeBuffer *instances, u32 instanceCount, ComputeBuffer *drawRecords, Maths::Matrix4x4 viewProjection)
+    {
+        if (this->shader == NULL)
+        {
+            return NULL;
+        }
+        GPUCullingOutput *output = GPUCullingPass_NextOutput(this);
+        if (output == NULL)
+        {
+            return NULL;
+        }
+        this->currentOutput = output;
+
+        u32 zero = 0;
+        output->drawCount.SetData((u8 *)&zero, 1);
+        if (instanceCount == 0)
+        {
+            return output;
+        }
+
+        //vectors are transformed as rows, so clip space x, y, z and w are the dot products with each column
+        const Maths::Matrix4x4 &m = viewProjection;
+        GPUCullingData data;
+        GPUCullingSetPlane(data.planes[0], m.M14 + m.M11, m.M24 + m.M21, m.M34 + m.M31, m.M44 + m.M41);
+        GPUCullingSetPlane(data.planes[1], m.M14 - m.M11, m.M24 - m.M21, m.M34 - m.M31, m.M44 - m.M41);
+        GPUCullingSetPlane(data.planes[2], m.M14 + m.M12, m.M24 + m.M22, m.M34 + m.M32, m.M44 + m.M42);
+        GPUCullingSetPlane(data.planes[3], m.M14 - m.M12, m.M24 - m.M22, m.M34 - m.M32, m.M44 - m.M42);
+        //depth is 0 to 1
+        GPUCullingSetPlane(data.planes[4], m.M13, m.M23, m.M33, m.M43);
+        GPUCullingSetPlane(data.planes[5], m.M14 - m.M13, m.M24 - m.M23, m.M34 - m.M33, m.M44 - m.M43);
+        data.instanceCount = instanceCount;
+        data.maxDraws = this->maxDraws;
+        data.padding[0] = 0;
+        data.padding[1] = 0;
+
+        ShaderDrawState *drawState = graphics->GetShaderDrawState(shader);
+        shader->SetShaderVariable(cullingDataHandle, &data, sizeof(GPUCullingData), drawState);
+        shader->SetShaderVariableComputeBuffer(instancesHandle, instances, drawState);
+        shader->SetShaderVariableComputeBuffer(drawRecordsHandle, drawRecords, drawState);
+        shader->SetShaderVariableComputeBuffer(drawCommandsHandle, &output->drawCommands, drawState);
+        shader->SetShaderVariableComputeBuffer(drawCountHandle, &output->drawCount, drawState);
+
+        u32 groupCount = (instanceCount + ASTRALCANVAS_GPUCULLING_GROUP_SIZE - 1) / ASTRALCANVAS_GPUCULLING_GROUP_SIZE;
+        if (this->readBackDrawCount)
+        {
+            //the count has to be on the CPU before the draw is recorded, so this is the one case left waiting on the GPU
+            pipeline.DispatchNow(groupCount, 1, 1);
+            u32 *visibleCount = (u32 *)output->drawCount.GetData(GetCAllocator(), NULL);
+            if (visibleCount != NULL)
+            {
+                output->visibleCount = *visibleCount < this->maxDraws ? *visibleCount : this->maxDraws;
+                GetCAllocator().Free(visibleCount);
+            }
+            return output;
+        }
+
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
+                AstralCanvasVkBarrierBatch barriers = AstralCanvasVkBarrierBatch(gpu, AstralCanvasVk_GetMainCmdBuffer());
+                //the outputs may still be read by the draws of the last frame that used them
+                barriers.AccessBuffer(&output->drawCommands, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT);
+                barriers.AccessBuffer(&output->drawCount, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT);
+                barriers.Flush();
+
+                graphics->DispatchCompute(&pipeline, groupCount, 1, 1);
+
+                barriers.AccessBuffer(&output->drawCommands, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT);
+                barriers.AccessBuffer(&output->drawCount, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT);
+                barriers.Flush();
+                break;
+            }
+            #endif
+            default:
+                pipeline.DispatchNow(groupCount, 1, 1);
+                break;
+        }
+        return output;
+    }
+    void GPUCullingPass::Draw(Graphics *graphics)
+    {
+        Draw(graphics, this->currentOutput);
+    }
+    void GPUCullingPass::Draw(Graphics *graphics, GPUCullingOutput *output)
+    {
+        if (output == NULL)
+        {
+            return;
+        }
+        if (this->readBackDrawCount)
+        {
+            if (output->visibleCount > 0)
+            {
+                graphics->DrawIndexedPrimitivesIndirect(&output->drawCommands, 0, output->visibleCount);
+            }
+            return;
+        }
+        graphics->DrawIndexedPrimitivesIndirectCount(&output->drawCommands, 0, &output->drawCount, 0, maxDraws);
+    }
+    void GPUCullingPass::deinit()
+    {
+        for (u32 frame = 0; frame < ASTRALCANVAS_GPUCULLING_BUFFERED_FRAMES; frame++)
+        {
+            for (u32 i = 0; i < ASTRALCANVAS_GPUCULLING_MAX_CULLS_PER_FRAME; i++)
+            {
+                GPUCullingOutput *output = &outputs[frame][i];
+                if (output->drawCommands.handle != NULL)
+                {
+                    output->drawCommands.deinit();
+                    output->drawCount.deinit();
+                }
+            }
+        }
+        if (pipeline.handle != NULL)
+        {
+            pipeline.deinit();
+        }
+    }
+}
@@ -0,0 +1,201 @@
+#include "Graphics/GeometryArena.hpp"
+#include "Graphics/CurrentBackend.hpp"
+#include "ErrorHandling.hpp"
+
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanInstanceData.hpp"
+#endif
+
+namespace AstralCanvas
+{
+    GeometryArena::GeometryArena()
+    {
+        this->vertices = VertexBuffer();
+        this->indices = IndexBuffer();
+        this->freeVertices = collections::vector<GeometryArenaRange>();
+        this->freeIndices = collections::vector<GeometryArenaRange>();
+        this->pendingFrees = collections::vector<GeometryArenaPendingFree>();
+    }
+    GeometryArena::GeometryArena(IAllocator allocator, VertexDeclaration *vertexType, usize vertexCapacity, IndexBufferSize indexElementSize, usize indexCapacity)
+    {
+        this->vertices = VertexBuffer(vertexType, vertexCapacity);
+        this->indices = IndexBuffer(indexElementSize, indexCapacity);
+        this->freeVertices = collections::vector<GeometryArenaRange>(allocator);
+        this->freeIndices = collections::vector<GeometryArenaRange>(allocator);
+        this->pendingFrees = collections::vector<GeometryArenaPendingFree>(allocator);
+        this->freeVertices.Add({0, (u32)vertexCapacity});
+        this->freeIndices.Add({0, (u32)indexCapacity});
+    }
+
+    /// First fit. Returns false if no free range is large enough
+    bool GeometryArenaTake(collections::vector<GeometryArenaRange> *freeList, u32 count, u32 *offset)
+    {
+        for (usize i = 0; i < freeList->count; i++)
+        {
+            GeometryArenaRange *range = &freeList->ptr[i];
+            if (range->count >= count)
+            {
+                *offset = range->offset;
+                range->offset += count;
+                range->count -= count;
+                if (range->count == 0)
+                {
+                    freeList->RemoveAt_Pullback(i);
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+    void GeometryArenaGiveBack(collections::vector<GeometryArenaRange> *freeList, u32 offset, u32 count)
+    {
+        usize insertAt = 0;
+        while (insertAt < freeList->count && freeList->ptr[insertAt].offset < offset)
+        {
+            insertAt++;
+        }
+        freeList->Insert({offset, count}, insertAt);
+
+        //merge with the range after, then the range before
+        if (insertAt + 1 < freeList->count && offset + count == freeList->ptr[insertAt + 1].offset)
+        {
+            freeList->ptr[insertAt].count += freeList->ptr[insertAt + 1].count;
+            freeList->RemoveAt_Pullback(insertAt + 1);
+        }
+        if (insertAt > 0 && freeList->ptr[insertAt - 1].offset + freeList->ptr[insertAt - 1].count == offset)
+        {
+            freeList->ptr[insertAt - 1].count += freeList->ptr[insertAt].count;
+            freeList->RemoveAt_Pullback(insertAt);
+        }
+    }
+
+    /// Whether every draw recorded up to and including frameNumber has finished
+    bool GeometryArenaFrameRetired(u64 frameNumber)
+    {
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                //same rule as the destruction queue, frames more than framesInFlight behind the current one have retired
+                u64 currentFrame = AstralCanvasVk_GetFrameNumber();
+                u64 framesInFlight = AstralCanvasVk_GetFramesInFlight();
+                return currentFrame >= framesInFlight && frameNumber <= currentFrame - framesInFlight;
+            }
+            #endif
+            //OpenGL synchronizes buffer writes against draws still reading them itself
+            default:
+                return true;
+        }
+    }
+    u64 GeometryArenaCurrentFrame()
+    {
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+                return AstralCanvasVk_GetFrameNumber();
+            #endif
+            default:
+                return 0;
+        }
+    }
+
+    GeometryHandle GeometryArena::Allocate(void *vertexData, u32 vertexCount, u8 *indexData, u32 indexCount)
+    {
+        GeometryHandle result{};
+        if (vertexCount == 0)
+        {
+            return result;
+        }
+        this->RetireFrees();
+        u32 vertexOffset;
+        if (!GeometryArenaTake(&this->freeVertices, vertexCount, &vertexOffset))
+        {
+            LOG_WARNING("Geometry arena is out of vertex space");
+            return result;
+        }
+        u32 firstIndex = 0;
+        if (indexCount > 0 && !GeometryArenaTake(&this->freeIndices, indexCount, &firstIndex))
+        {
+            GeometryArenaGiveBack(&this->freeVertices, vertexOffset, vertexCount);
+            LOG_WARNING("Geometry arena is out of index space");
+            return result;
+        }
+
+        this->vertices.SetData(vertexData, vertexCount, vertexOffset);
+        if (indexCount > 0)
+        {
+            usize indexSize = this->indices.indexElementSize == IndexBufferSize_U16 ? 2 : 4;
+            this->indices.SetData(indexData, indexCount * indexSize, firstIndex);
+        }
+
+        result.vertexBuffer = &this->vertices;
+        result.indexBuffer = &this->indices;
+        result.vertexOffset = vertexOffset;
+        result.vertexCount = vertexCount;
+        result.firstIndex = firstIndex;
+        result.indexCount = indexCount;
+        return result;
+    }
+    void GeometryArena::Free(GeometryHandle handle)
+    {
+        if (handle.vertexCount == 0)
+        {
+            return;
+        }
+        GeometryArenaPendingFree pending;
+        pending.vertices = {handle.vertexOffset, handle.vertexCount};
+        pending.indices = {handle.firstIndex, handle.indexCount};
+        pending.releasedOnFrame = GeometryArenaCurrentFrame();
+        this->pendingFrees.Add(pending);
+    }
+    void GeometryArena::RetireFrees()
+    {
+        //pending frees are in release order, so stop at the first one that may still be drawn
+        usize retired = 0;
+        while (retired < this->pendingFrees.count && GeometryArenaFrameRetired(this->pendingFrees.ptr[retired].releasedOnFrame))
+        {
+            GeometryArenaPendingFree *pending = &this->pendingFrees.ptr[retired];
+            GeometryArenaGiveBack(&this->freeVertices, pending->vertices.offset, pending->vertices.count);
+            if (pending->indices.count > 0)
+            {
+                GeometryArenaGiveBack(&this->freeIndices, pending->indices.offset, pending->indices.count);
+            }
+            retired += 1;
+        }
+        if (retired > 0)
+        {
+            usize remaining = this->pendingFrees.count - retired;
+            for (usize i = 0; i < remaining; i++)
+            {
+                this->pendingFrees.ptr[i] = this->pendingFrees.ptr[i + retired];
+            }
+            this->pendingFrees.count = remaining;
+        }
+    }
+
+    void GeometryArena::Bind(Graphics *graphics, u32 bindingPoint)
+    {
+        graphics->SetVertexBuffer(&this->vertices, bindingPoint);
+        graphics->SetIndexBuffer(&this->indices);
+    }
+    void GeometryArena::Draw(Graphics *graphics, GeometryHandle handle, u32 instanceCount, u32 firstInstance)
+    {
+        graphics->DrawIndexedPrimitives(handle, instanceCount, firstInstance);
+    }
+    void GeometryArena::deinit()
+    {
+        if (this->vertices.handle != NULL)
+        {
+            this->vertices.deinit();
+        }
+        if (this->indices.handle != NULL)
+        {
+            this->indices.deinit();
+        }
+        this->freeVertices.deinit();
+        this->freeIndices.deinit();
+        this->pendingFrees.deinit();
+    }
+}
@@ -1,4 +1,6 @@
 #include "Graphics/Graphics.hpp"
+#include "Graphics/GeometryArena.hpp"
+#include "Graphics/Compute.hpp"
 #include "Graphics/CurrentBackend.hpp"
 #include "hash.hpp"
 #include "ErrorHandling.hpp"
@@ -6,6 +8,11 @@
 #ifdef ASTRALCANVAS_VULKAN
 #include "Graphics/Vulkan/VulkanInstanceData.hpp"
 #include "Graphics/Vulkan/VulkanHelpers.hpp"
+#include "Graphics/Vulkan/VulkanBarriers.hpp"
+#include "Graphics/Vulkan/VulkanEnumConverters.hpp"
+#include "Graphics/Vulkan/VulkanBindless.hpp"
+#include "Graphics/Vulkan/VulkanUniformArena.hpp"
+#include "Graphics/Vulkan/VulkanDestructionQueue.hpp"
 #endif
 
 #ifdef ASTRALCANVAS_METAL
@@ -16,6 +23,36 @@
 #include "Graphics/Glad/glad.h"
 #endif
 
+#ifdef ASTRALCANVAS_VULKAN
+inline VkCommandBuffer AstralCanvasVk_GetRecordingCmdBuffer(AstralCanvas::Graphics *graphics)
+{
+    if (graphics->recordingCommandBuffer != NULL)
+    {
+        return (VkCommandBuffer)graphics->recordingCommandBuffer;
+    }
+    return AstralCanvasVk_GetMainCmdBuffer();
+}
+/// Records drawCount consecutive commands from buffer, split across as many indirect calls as the device needs.
+/// Returns how many calls that took
+inline u32 AstralCanvasVk_CmdDrawIndexedIndirect(VkCommandBuffer cmdBuffer, VkBuffer buffer, usize offset, u32 drawCount)
+{
+    AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
+    //without multiDrawIndirect, each command needs its own indirect call
+    u32 maxDrawCount = gpu->supportsMultiDrawIndirect ? gpu->properties.limits.maxDrawIndirectCount : 1;
+    u32 calls = 0;
+    u32 drawn = 0;
+    while (drawn < drawCount)
+    {
+        u32 remaining = drawCount - drawn;
+        u32 count = remaining < maxDrawCount ? remaining : maxDrawCount;
+        vkCmdDrawIndexedIndirect(cmdBuffer, buffer, offset + sizeof(AstralCanvas::DrawIndexedIndirectCommand) * drawn, count, sizeof(AstralCanvas::DrawIndexedIndirectCommand));
+        drawn += count;
+        calls += 1;
+    }
+    return calls;
+}
+#endif
+
 namespace AstralCanvas
 {
     usize bindBufferNoOffsets = 0;
@@ -27,6 +64,41 @@ namespace AstralCanvas
         this->currentRenderPipeline = NULL;
         this->currentRenderProgram = NULL;
         this->currentRenderTarget = NULL;
+        this->recordingCommandBuffer = NULL;
+        this->executesSecondaryCommands = false;
+        this->secondaryCommandsMutex = threading::Mutex();
+        this->secondaryCommands = collections::vector<GraphicsSecondaryCommands>();
+        this->secondaryCommandBuffers = collections::vector<void *>();
+        this->shaderDrawStates = collections::vector<ShaderDrawState>();
+        this->mergedDraws = collections::vector<DrawIndexedIndirectCommand>();
+        this->mergeDraws = false;
+        this->attachmentClearColors = collections::Array<Color>();
+        this->ResetBoundState();
+        this->ResetSkippedCommands();
+    }
+    void Graphics::ResetBoundState()
+    {
+        this->boundState = {};
+    }
+    ShaderDrawState *Graphics::GetShaderDrawState(Shader *shader)
+    {
+        if (this->recordingCommandBuffer == NULL)
+        {
+            return &shader->drawState;
+        }
+        for (usize i = 0; i < this->shaderDrawStates.count; i++)
+        {
+            if (this->shaderDrawStates.ptr[i].shader == shader)
+            {
+                return &this->shaderDrawStates.ptr[i];
+            }
+        }
+        this->shaderDrawStates.Add(ShaderDrawState(this->shaderDrawStates.allocator, shader));
+        return &this->shaderDrawStates.ptr[this->shaderDrawStates.count - 1];
+    }
+    void Graphics::ResetSkippedCommands()
+    {
+        this->skippedCommands = {};
     }
     void Graphics::AwaitGraphicsIdle()
     {
@@ -39,6 +111,8 @@ namespace AstralCanvas
                 queue->queueMutex.EnterLock();
                 vkQueueWaitIdle(queue->queue);
                 queue->queueMutex.ExitLock();
+                //every frame has finished, so anything waiting on one can go now
+                AstralCanvasVk_FlushDestructions(AstralCanvasVk_GetCurrentGPU());
                 break;
             }
             #endif
@@ -58,9 +132,21 @@ namespace AstralCanvas
             #ifdef ASTRALCANVAS_VULKAN
             case Backend_Vulkan:
             {
-                VkCommandBuffer cmdBuffer = AstralCanvasVk_GetMainCmdBuffer();
+                VkDeviceSize offset = (VkDeviceSize)vb->regions.GetCurrentOffset();
+                if (bindingPoint < ASTRALCANVAS_MAX_VERTEX_BINDINGS)
+                {
+                    if (this->boundState.vertexBuffers[bindingPoint] == vb->handle && this->boundState.vertexBufferOffsets[bindingPoint] == offset)
+                    {
+                        this->skippedCommands.vertexBufferBinds += 1;
+                        break;
+                    }
+                    this->boundState.vertexBuffers[bindingPoint] = vb->handle;
+                    this->boundState.vertexBufferOffsets[bindingPoint] = offset;
+                }
+                this->FlushMergedDraws();
+                VkCommandBuffer cmdBuffer = AstralCanvasVk_GetRecordingCmdBuffer(this);
                 
-                vkCmdBindVertexBuffers(cmdBuffer, bindingPoint, 1, (VkBuffer*)&vb->handle, &bindBufferNoOffsets);
+                vkCmdBindVertexBuffers(cmdBuffer, bindingPoint, 1, (VkBuffer*)&vb->handle, &offset);
                 break;
             }
             #endif
@@ -90,7 +176,18 @@ namespace AstralCanvas
             #ifdef ASTRALCANVAS_VULKAN
             case Backend_Vulkan:
             {
-                VkCommandBuffer cmdBuffer = AstralCanvasVk_GetMainCmdBuffer();
+                if (bindingPoint < ASTRALCANVAS_MAX_VERTEX_BINDINGS)
+                {
+                    if (this->boundState.vertexBuffers[bindingPoint] == computeBuffer->handle)
+                    {
+                        this->skippedCommands.vertexBufferBinds += 1;
+                        break;
+                    }
+                    this->boundState.vertexBuffers[bindingPoint] = computeBuffer->handle;
+                    this->boundState.vertexBufferOffsets[bindingPoint] = 0;
+                }
+                this->FlushMergedDraws();
+                VkCommandBuffer cmdBuffer = AstralCanvasVk_GetRecordingCmdBuffer(this);
 
                 vkCmdBindVertexBuffers(cmdBuffer, bindingPoint, 1, (VkBuffer*)&computeBuffer->handle, &bindBufferNoOffsets);
                 break;
@@ -123,9 +220,21 @@ namespace AstralCanvas
             #ifdef ASTRALCANVAS_VULKAN
             case Backend_Vulkan:
             {
-                VkCommandBuffer cmdBuffer = AstralCanvasVk_GetMainCmdBuffer();
+                VkDeviceSize offset = (VkDeviceSize)instanceBuffer->regions.GetCurrentOffset();
+                if (bindingPoint < ASTRALCANVAS_MAX_VERTEX_BINDINGS)
+                {
+                    if (this->boundState.vertexBuffers[bindingPoint] == instanceBuffer->handle && this->boundState.vertexBufferOffsets[bindingPoint] == offset)
+                    {
+                        this->skippedCommands.vertexBufferBinds += 1;
+                        break;
+                    }
+                    this->boundState.vertexBuffers[bindingPoint] = instanceBuffer->handle;
+                    this->boundState.vertexBufferOffsets[bindingPoint] = offset;
+                }
+                this->FlushMergedDraws();
+                VkCommandBuffer cmdBuffer = AstralCanvasVk_GetRecordingCmdBuffer(this);
 
-                vkCmdBindVertexBuffers(cmdBuffer, bindingPoint, 1, (VkBuffer*)&instanceBuffer->handle, &bindBufferNoOffsets);
+                vkCmdBindVertexBuffers(cmdBuffer, bindingPoint, 1, (VkBuffer*)&instanceBuffer->handle, &offset);
                 break;
             }
             #endif
@@ -155,7 +264,16 @@ namespace AstralCanvas
             #ifdef ASTRALCANVAS_VULKAN
             case Backend_Vulkan:
             {
-                VkCommandBuffer cmdBuffer = AstralCanvasVk_GetMainCmdBuffer();
+                if (this->boundState.indexBuffer == indexBuffer->handle && this->boundState.indexElementSize == indexBuffer->indexElementSize)
+                {
+                    this->skippedCommands.indexBufferBinds += 1;
+                    break;
+                }
+                this->boundState.indexBuffer = indexBuffer->handle;
+                this->boundState.indexElementSize = indexBuffer->indexElementSize;
+
+                this->FlushMergedDraws();
+                VkCommandBuffer cmdBuffer = AstralCanvasVk_GetRecordingCmdBuffer(this);
 
                 vkCmdBindIndexBuffer(cmdBuffer, (VkBuffer)indexBuffer->handle, 0, indexBuffer->indexElementSize == IndexBufferSize_U16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32);
                 break;
@@ -182,6 +300,20 @@ namespace AstralCanvas
         }
         this->currentIndexBuffer = indexBuffer;
     }
+    void Graphics::SetVertexBuffer(GeometryHandle handle, u32 bindingPoint)
+    {
+        if (handle.vertexBuffer != NULL)
+        {
+            SetVertexBuffer(handle.vertexBuffer, bindingPoint);
+        }
+    }
+    void Graphics::SetIndexBuffer(GeometryHandle handle)
+    {
+        if (handle.indexBuffer != NULL)
+        {
+            SetIndexBuffer(handle.indexBuffer);
+        }
+    }
     void Graphics::SetRenderTarget(RenderTarget *target)
     {
         if (currentRenderProgram == NULL)
@@ -197,7 +329,16 @@ namespace AstralCanvas
             #ifdef ASTRALCANVAS_VULKAN
             case Backend_Vulkan:
             {
-                VkCommandBuffer cmdBuffer = AstralCanvasVk_GetMainCmdBuffer();
+                if (this->boundState.scissorSet && this->boundState.scissor == this->ClipArea)
+                {
+                    this->skippedCommands.scissors += 1;
+                    break;
+                }
+                this->boundState.scissorSet = true;
+                this->boundState.scissor = this->ClipArea;
+
+                this->FlushMergedDraws();
+                VkCommandBuffer cmdBuffer = AstralCanvasVk_GetRecordingCmdBuffer(this);
 
                 VkRect2D clip;
                 clip.extent.width = this->ClipArea.Width;
@@ -231,10 +372,18 @@ namespace AstralCanvas
                 break;
         }
     }
-    void Graphics::StartRenderProgram(RenderProgram *program, const Color clearColor)
+    void Graphics::StartRenderProgram(RenderProgram *program, collections::Array<Color> attachmentClearColors, bool useGraphicsContexts)
+    {
+        //reset again by EndRenderProgram
+        this->attachmentClearColors = attachmentClearColors;
+        this->StartRenderProgram(program, attachmentClearColors.length > 0 ? attachmentClearColors.data[0] : Color(), useGraphicsContexts);
+    }
+    void Graphics::StartRenderProgram(RenderProgram *program, const Color clearColor, bool useGraphicsContexts)
     {
         this->currentRenderProgram = program;
         this->clearColor = clearColor;
+        this->executesSecondaryCommands = useGraphicsContexts;
+        this->ResetBoundState();
         switch (GetActiveBackend())
         {
             #ifdef ASTRALCANVAS_VULKAN
@@ -247,36 +396,96 @@ namespace AstralCanvas
                     renderTarget = &swapchain->renderTargets.data[swapchain->currentImageIndex];
                 }
 
-                AstralCanvasVkTextureToTransition *textures = (AstralCanvasVkTextureToTransition*)malloc(sizeof(AstralCanvasVkTextureToTransition) * renderTarget->textures.length);
+                VkCommandBuffer cmdBuffer = AstralCanvasVk_GetMainCmdBuffer();
+                AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
+
+                //recorded into the frame's command buffer ahead of the render pass
+                //rather than submitted and waited on separately
+                AstralCanvasVkBarrierBatch barriers = AstralCanvasVkBarrierBatch(gpu, cmdBuffer);
                 for (usize i = 0; i < renderTarget->textures.length; i++)
                 {
-                    textures[i].texture = &renderTarget->textures.data[i];
-                    if (renderTarget->textures.data[i].imageFormat > ImageFormat_DepthNone)
+                    Texture2D *texture = &renderTarget->textures.data[i];
+                    if (texture->imageFormat > ImageFormat_DepthNone)
                     {
-                        if (renderTarget->textures.data[i].imageFormat == ImageFormat_Depth24Stencil8
-                        || renderTarget->textures.data[i].imageFormat == ImageFormat_Depth16Stencil8)
+                        VkImageAspectFlags aspectFlags = VK_IMAGE_ASPECT_DEPTH_BIT;
+                        if (texture->imageFormat == ImageFormat_Depth24Stencil8 || texture->imageFormat == ImageFormat_Depth16Stencil8)
                         {
-                            textures[i].aspectFlags = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+                            aspectFlags |= VK_IMAGE_ASPECT_STENCIL_BIT;
                         }
-                        else
-                        {
-                            textures[i].aspectFlags = VK_IMAGE_ASPECT_DEPTH_BIT;
-                        }
-                        textures[i].newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+                        barriers.TransitionTexture(texture, aspectFlags, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
                     }
                     else
                     {
-                        textures[i].aspectFlags = VK_IMAGE_ASPECT_COLOR_BIT;
-                        textures[i].newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+                        barriers.TransitionTexture(texture, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
                     }
                 }
-                AstralCanvasVk_TransitionTextureLayouts(AstralCanvasVk_GetCurrentGPU(), textures, renderTarget->textures.length);
-                free(textures);
-
-                VkCommandBuffer cmdBuffer = AstralCanvasVk_GetMainCmdBuffer();
+                barriers.Flush();
 
                 renderTarget->Construct(this->currentRenderProgram);
 
+                if (program->usesDynamicRendering)
+                {
+                    RenderPass *pass = &program->renderPasses.ptr[0];
+                    VkRenderingAttachmentInfo colorAttachments[ASTRALVULKAN_MAX_COLOR_ATTACHMENTS];
+                    VkRenderingAttachmentInfo depthAttachment{};
+
+                    VkRenderingInfo renderingInfo{};
+                    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+                    renderingInfo.flags = useGraphicsContexts ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT : 0;
+                    renderingInfo.renderArea.offset.x = 0;
+                    renderingInfo.renderArea.offset.y = 0;
+                    renderingInfo.renderArea.extent.width = renderTarget->width;
+                    renderingInfo.renderArea.extent.height = renderTarget->height;
+                    renderingInfo.layerCount = 1;
+                    u32 colorCount = (u32)pass->colorAttachmentIndices.length;
+                    if (colorCount > ASTRALVULKAN_MAX_COLOR_ATTACHMENTS)
+                    {
+                        THROW_ERR("Render pass writes to too many color attachments");
+                        colorCount = ASTRALVULKAN_MAX_COLOR_ATTACHMENTS;
+                    }
+                    renderingInfo.colorAttachmentCount = colorCount;
+                    renderingInfo.pColorAttachments = colorAttachments;
+
+                    for (u32 i = 0; i < colorCount; i++)
+                    {
+                        i32 index = pass->colorAttachmentIndices.data[i];
+                        RenderProgramImageAttachment attachment = program->attachments.ptr[index];
+
+                        colorAttachments[i] = {};
+                        colorAttachments[i].sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+                        colorAttachments[i].imageView = (VkImageView)renderTarget->textures.data[index].imageView;
+                        colorAttachments[i].imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+                        colorAttachments[i].loadOp = attachment.clearColor ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+                        colorAttachments[i].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+                        Color attachmentClearColor = (usize)index < this->attachmentClearColors.length ? this->attachmentClearColors.data[index] : clearColor;
+                        colorAttachments[i].clearValue.color.float32[0] = attachmentClearColor.R * ONE_OVER_255;
+                        colorAttachments[i].clearValue.color.float32[1] = attachmentClearColor.G * ONE_OVER_255;
+                        colorAttachments[i].clearValue.color.float32[2] = attachmentClearColor.B * ONE_OVER_255;
+                        colorAttachments[i].clearValue.color.float32[3] = attachmentClearColor.A * ONE_OVER_255;
+                    }
+                    if (pass->depthAttachmentIndex > -1)
+                    {
+                        RenderProgramImageAttachment attachment = program->attachments.ptr[pass->depthAttachmentIndex];
+
+                        depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+                        depthAttachment.imageView = (VkImageView)renderTarget->textures.data[pass->depthAttachmentIndex].imageView;
+                        depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+                        depthAttachment.loadOp = attachment.clearDepth ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+                        depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+                        depthAttachment.clearValue.depthStencil.depth = 1.0f;
+                        depthAttachment.clearValue.depthStencil.stencil = 255;
+
+                        renderingInfo.pDepthAttachment = &depthAttachment;
+                        if (attachment.imageFormat == ImageFormat_Depth16Stencil8 || attachment.imageFormat == ImageFormat_Depth24Stencil8)
+                        {
+                            renderingInfo.pStencilAttachment = &depthAttachment;
+                        }
+                    }
+
+                    vkCmdBeginRendering(cmdBuffer, &renderingInfo);
+                    break;
+                }
+
                 VkRenderPassBeginInfo info{};
                 info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
                 info.framebuffer = (VkFramebuffer)renderTarget->renderTargetHandle;
@@ -295,10 +504,11 @@ namespace AstralCanvas
 
                     if (attachment.clearColor && attachment.imageFormat < ImageFormat_DepthNone)
                     {
-                        clearValues[i].color.float32[0] = clearColor.R * ONE_OVER_255;
-                        clearValues[i].color.float32[1] = clearColor.G * ONE_OVER_255;
-                        clearValues[i].color.float32[2] = clearColor.B * ONE_OVER_255;
-                        clearValues[i].color.float32[3] = clearColor.A * ONE_OVER_255;
+                        Color attachmentClearColor = i < this->attachmentClearColors.length ? this->attachmentClearColors.data[i] : clearColor;
+                        clearValues[i].color.float32[0] = attachmentClearColor.R * ONE_OVER_255;
+                        clearValues[i].color.float32[1] = attachmentClearColor.G * ONE_OVER_255;
+                        clearValues[i].color.float32[2] = attachmentClearColor.B * ONE_OVER_255;
+                        clearValues[i].color.float32[3] = attachmentClearColor.A * ONE_OVER_255;
                     }
                     else if (attachment.clearDepth && attachment.imageFormat > ImageFormat_DepthNone)
                     {
@@ -312,7 +522,7 @@ namespace AstralCanvas
                 info.renderArea.extent.width = renderTarget->width;
                 info.renderArea.extent.height = renderTarget->height;
 
-                vkCmdBeginRenderPass(cmdBuffer, &info, VK_SUBPASS_CONTENTS_INLINE);
+                vkCmdBeginRenderPass(cmdBuffer, &info, useGraphicsContexts ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
                 break;
             }
             #endif
@@ -337,15 +547,23 @@ namespace AstralCanvas
     }
     void Graphics::NextRenderPass()
     {
+        FlushMergedDraws();
+        ExecuteSecondaryCommands();
         currentRenderPass += 1;
+        //pipelines are only compatible with the subpass they were created for
+        this->ResetBoundState();
         switch (GetActiveBackend())
         {
             #ifdef ASTRALCANVAS_VULKAN
             case Backend_Vulkan:
             {
+                if (this->currentRenderProgram->usesDynamicRendering)
+                {
+                    THROW_ERR("Render programs drawn with dynamic rendering only have one render pass");
+                }
                 VkCommandBuffer cmdBuffer = AstralCanvasVk_GetMainCmdBuffer();
                 
-                vkCmdNextSubpass(cmdBuffer, VK_SUBPASS_CONTENTS_INLINE);
+                vkCmdNextSubpass(cmdBuffer, this->executesSecondaryCommands ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
                 break;
             }
             #endif
@@ -370,6 +588,8 @@ namespace AstralCanvas
     {
         if (this->currentRenderProgram != NULL)
         {
+            FlushMergedDraws();
+            ExecuteSecondaryCommands();
             switch (GetActiveBackend())
             {
                 #ifdef ASTRALCANVAS_VULKAN
@@ -377,14 +597,40 @@ namespace AstralCanvas
                 {
                     VkCommandBuffer cmdBuffer = AstralCanvasVk_GetMainCmdBuffer();
 
-                    vkCmdEndRenderPass(cmdBuffer);
-
                     RenderTarget *renderTarget = currentRenderTarget;
                     if (renderTarget == NULL)
                     {
                         AstralVulkanSwapchain *swapchain = (AstralVulkanSwapchain *)this->currentWindow->swapchain;
                         renderTarget = &swapchain->renderTargets.data[swapchain->currentImageIndex];
                     }
+
+                    if (currentRenderProgram->usesDynamicRendering)
+                    {
+                        vkCmdEndRendering(cmdBuffer);
+
+                        //without a render pass there are no final layouts, so transition to them here
+                        AstralCanvasVkBarrierBatch barriers = AstralCanvasVkBarrierBatch(AstralCanvasVk_GetCurrentGPU(), cmdBuffer);
+                        for (usize i = 0; i < currentRenderProgram->attachments.count; i++)
+                        {
+                            RenderProgramImageAttachment attachmentData = currentRenderProgram->attachments.ptr[i];
+                            if (attachmentData.imageFormat > ImageFormat_DepthNone)
+                            {
+                                continue;
+                            }
+                            if (attachmentData.outputType == RenderPassOutput_ToRenderTarget)
+                            {
+                                barriers.TransitionTexture(&renderTarget->textures.data[i], VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+                            }
+                            else if (attachmentData.outputType == RenderPassOutput_ToWindow)
+                            {
+                                barriers.TransitionTexture(&renderTarget->textures.data[i], VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+                            }
+                        }
+                        barriers.Flush();
+                        break;
+                    }
+
+                    vkCmdEndRenderPass(cmdBuffer);
                     if (renderTarget != NULL)
                     {
                         for (usize i = 0; i < currentRenderProgram->attachments.count; i++)
@@ -426,6 +672,89 @@ namespace AstralCanvas
         }
         this->currentRenderPass = 0;
         this->currentRenderProgram = NULL;
+        this->attachmentClearColors = collections::Array<Color>();
+        this->executesSecondaryCommands = false;
+    }
+    void Graphics::SubmitSecondaryCommands(void *commandBuffer, u32 order, collections::hashset<Shader*> *contextUsedShaders)
+    {
+        GraphicsSecondaryCommands commands;
+        commands.commandBuffer = commandBuffer;
+        commands.order = order;
+        commands.renderPass = this->currentRenderPass;
+
+        this->secondaryCommandsMutex.EnterLock();
+        this->secondaryCommands.Add(commands);
+
+        //so that the shaders' per frame state gets reset along with the ones used on this Graphics
+        for (usize i = 0; i < contextUsedShaders->bucketsCount; i++)
+        {
+            if (contextUsedShaders->buckets[i].initialized)
+            {
+                for (usize j = 0; j < contextUsedShaders->buckets[i].entries.count; j++)
+                {
+                    this->usedShaders.Add(contextUsedShaders->buckets[i].entries.ptr[j]);
+                }
+                contextUsedShaders->buckets[i].entries.Clear();
+            }
+        }
+        contextUsedShaders->Count = 0;
+        this->secondaryCommandsMutex.ExitLock();
+    }
+    void Graphics::ExecuteSecondaryCommands()
+    {
+        if (!this->executesSecondaryCommands)
+        {
+            return;
+        }
+        this->secondaryCommandsMutex.EnterLock();
+        if (this->secondaryCommands.count == 0)
+        {
+            this->secondaryCommandsMutex.ExitLock();
+            return;
+        }
+
+        //insertion sort, keeps contexts that share an order in the order they were submitted
+        for (usize i = 1; i < this->secondaryCommands.count; i++)
+        {
+            GraphicsSecondaryCommands commands = this->secondaryCommands.ptr[i];
+            usize j = i;
+            while (j > 0 && this->secondaryCommands.ptr[j - 1].order > commands.order)
+            {
+                this->secondaryCommands.ptr[j] = this->secondaryCommands.ptr[j - 1];
+                j -= 1;
+            }
+            this->secondaryCommands.ptr[j] = commands;
+        }
+
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                this->secondaryCommandBuffers.Clear();
+                for (usize i = 0; i < this->secondaryCommands.count; i++)
+                {
+                    if (this->secondaryCommands.ptr[i].renderPass != this->currentRenderPass)
+                    {
+                        LOG_WARNING("Discarding GraphicsContext commands that were recorded for a different render pass");
+                        continue;
+                    }
+                    this->secondaryCommandBuffers.Add(this->secondaryCommands.ptr[i].commandBuffer);
+                }
+                if (this->secondaryCommandBuffers.count > 0)
+                {
+                    vkCmdExecuteCommands(AstralCanvasVk_GetMainCmdBuffer(), (u32)this->secondaryCommandBuffers.count, (VkCommandBuffer*)this->secondaryCommandBuffers.ptr);
+                    //the state bound by the executed buffers is undefined afterwards
+                    this->ResetBoundState();
+                }
+                break;
+            }
+            #endif
+            default:
+                break;
+        }
+        this->secondaryCommands.Clear();
+        this->secondaryCommandsMutex.ExitLock();
     }
     void Graphics::UseRenderPipeline(RenderPipeline *pipeline)
     {
@@ -436,28 +765,67 @@ namespace AstralCanvas
                 #ifdef ASTRALCANVAS_VULKAN
                 case Backend_Vulkan:
                 {
-                    VkCommandBuffer cmdBuffer = AstralCanvasVk_GetMainCmdBuffer();
+                    VkCommandBuffer cmdBuffer = AstralCanvasVk_GetRecordingCmdBuffer(this);
 
                     void *handle = pipeline->GetOrCreateFor(this->currentRenderProgram, currentRenderPass);
                     
-                    vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, (VkPipeline)handle);
-
-                    VkViewport viewport{};
-                    viewport.minDepth = 0.0f;
-                    viewport.maxDepth = 1.0f;
-                    viewport.x = (float)this->Viewport.X;
-                    viewport.y = (float)this->Viewport.Y;
-                    viewport.width = (float)this->Viewport.Width;
-                    viewport.height = (float)this->Viewport.Height;
-
-                    vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
-
-                    VkRect2D clip;
-                    clip.extent.width = this->ClipArea.Width;
-                    clip.extent.height = this->ClipArea.Height;
-                    clip.offset.x = this->ClipArea.X;
-                    clip.offset.y = this->ClipArea.Y;
-                    vkCmdSetScissor(cmdBuffer, 0, 1, &clip);
+                    if (this->boundState.pipeline != handle)
+                    {
+                        this->FlushMergedDraws();
+                        vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, (VkPipeline)handle);
+                        this->boundState.pipeline = handle;
+                    }
+                    else
+                    {
+                        this->skippedCommands.pipelineBinds += 1;
+                    }
+
+                    //the heap never changes, so it only needs binding again when the layout does
+                    if (pipeline->shader->shaderVariables.usesBindlessHeap && AstralCanvasVk_GetBindlessSet() != NULL && this->boundState.bindlessLayout != pipeline->layout)
+                    {
+                        this->FlushMergedDraws();
+                        VkDescriptorSet bindlessSet = AstralCanvasVk_GetBindlessSet();
+                        vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, (VkPipelineLayout)pipeline->layout, ASTRALCANVAS_BINDLESS_SET, 1, &bindlessSet, 0, NULL);
+                        this->boundState.bindlessLayout = pipeline->layout;
+                    }
+
+                    //viewport and scissor are dynamic state, so they survive pipeline binds
+                    if (!this->boundState.viewportSet || this->boundState.viewport != this->Viewport)
+                    {
+                        VkViewport viewport{};
+                        viewport.minDepth = 0.0f;
+                        viewport.maxDepth = 1.0f;
+                        viewport.x = (float)this->Viewport.X;
+                        viewport.y = (float)this->Viewport.Y;
+                        viewport.width = (float)this->Viewport.Width;
+                        viewport.height = (float)this->Viewport.Height;
+
+                        this->FlushMergedDraws();
+                        vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
+                        this->boundState.viewportSet = true;
+                        this->boundState.viewport = this->Viewport;
+                    }
+                    else
+                    {
+                        this->skippedCommands.viewports += 1;
+                    }
+
+                    if (!this->boundState.scissorSet || this->boundState.scissor != this->ClipArea)
+                    {
+                        VkRect2D clip;
+                        clip.extent.width = this->ClipArea.Width;
+                        clip.extent.height = this->ClipArea.Height;
+                        clip.offset.x = this->ClipArea.X;
+                        clip.offset.y = this->ClipArea.Y;
+                        this->FlushMergedDraws();
+                        vkCmdSetScissor(cmdBuffer, 0, 1, &clip);
+                        this->boundState.scissorSet = true;
+                        this->boundState.scissor = this->ClipArea;
+                    }
+                    else
+                    {
+                        this->skippedCommands.scissors += 1;
+                    }
                     break;
                 }
                 #endif
@@ -487,64 +855,163 @@ namespace AstralCanvas
     {
         if (currentRenderPipeline != NULL)
         {
-            currentRenderPipeline->shader->SetShaderVariableComputeBuffer(variableName, computeBuffer);
+            SetShaderVariableComputeBuffer(currentRenderPipeline->shader->GetVariableHandle(variableName), computeBuffer);
+        }
+    }
+    void Graphics::SetPushConstants(void *data, u32 size, u32 offset)
+    {
+        if (currentRenderPipeline == NULL)
+        {
+            return;
+        }
+        ShaderVariables *variables = &currentRenderPipeline->shader->shaderVariables;
+        if (offset + size > variables->pushConstantsSize)
+        {
+            THROW_ERR("Push constants written past the end of the shader's push constant block");
+            return;
+        }
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                this->FlushMergedDraws();
+                vkCmdPushConstants(
+                    AstralCanvasVk_GetRecordingCmdBuffer(this),
+                    (VkPipelineLayout)currentRenderPipeline->layout,
+                    AstralCanvasVk_FromAccessedBy(variables->pushConstantsAccessedBy),
+                    offset, size, data);
+                break;
+            }
+            #endif
+            default:
+                break;
         }
     }
     void Graphics::SetShaderVariable(const char* variableName, void* ptr, usize size)
     {
         if (currentRenderPipeline != NULL)
         {
-            currentRenderPipeline->shader->SetShaderVariable(variableName, ptr, size);
+            SetShaderVariable(currentRenderPipeline->shader->GetVariableHandle(variableName), ptr, size);
         }
     }
     void Graphics::SetShaderVariableTextures(const char* variableName, Texture2D **textures, usize count)
     {
         if (currentRenderPipeline != NULL)
         {
-            currentRenderPipeline->shader->SetShaderVariableTextures(variableName, textures, count);
+            SetShaderVariableTextures(currentRenderPipeline->shader->GetVariableHandle(variableName), textures, count);
         }
     }
     void Graphics::SetShaderVariableTexture(const char* variableName, Texture2D *texture)
     {
         if (currentRenderPipeline != NULL)
         {
-            currentRenderPipeline->shader->SetShaderVariableTexture(variableName, texture);
+            SetShaderVariableTexture(currentRenderPipeline->shader->GetVariableHandle(variableName), texture);
         }
     }
     void Graphics::SetShaderVariableSamplers(const char* variableName, SamplerState **samplers, usize count)
     {
         if (currentRenderPipeline != NULL)
         {
-            currentRenderPipeline->shader->SetShaderVariableSamplers(variableName, samplers, count);
+            SetShaderVariableSamplers(currentRenderPipeline->shader->GetVariableHandle(variableName), samplers, count);
         }
     }
     void Graphics::SetShaderVariableSampler(const char* variableName, SamplerState *sampler)
     {
         if (currentRenderPipeline != NULL)
         {
-            currentRenderPipeline->shader->SetShaderVariableSampler(variableName, sampler);
+            SetShaderVariableSampler(currentRenderPipeline->shader->GetVariableHandle(variableName), sampler);
+        }
+    }
+    void Graphics::SetShaderVariableComputeBuffer(ShaderVariableHandle handle, ComputeBuffer *computeBuffer)
+    {
+        if (currentRenderPipeline != NULL)
+        {
+            Shader *shader = currentRenderPipeline->shader;
+            shader->SetShaderVariableComputeBuffer(handle, computeBuffer, this->GetShaderDrawState(shader));
+        }
+    }
+    void Graphics::SetShaderVariable(ShaderVariableHandle handle, void* ptr, usize size)
+    {
+        if (currentRenderPipeline != NULL)
+        {
+            Shader *shader = currentRenderPipeline->shader;
+            shader->SetShaderVariable(handle, ptr, size, this->GetShaderDrawState(shader));
+        }
+    }
+    void Graphics::SetShaderVariableTextures(ShaderVariableHandle handle, Texture2D **textures, usize count)
+    {
+        if (currentRenderPipeline != NULL)
+        {
+            Shader *shader = currentRenderPipeline->shader;
+            shader->SetShaderVariableTextures(handle, textures, count, this->GetShaderDrawState(shader));
+        }
+    }
+    void Graphics::SetShaderVariableTexture(ShaderVariableHandle handle, Texture2D *texture)
+    {
+        if (currentRenderPipeline != NULL)
+        {
+            Shader *shader = currentRenderPipeline->shader;
+            shader->SetShaderVariableTexture(handle, texture, this->GetShaderDrawState(shader));
+        }
+    }
+    void Graphics::SetShaderVariableSamplers(ShaderVariableHandle handle, SamplerState **samplers, usize count)
+    {
+        if (currentRenderPipeline != NULL)
+        {
+            Shader *shader = currentRenderPipeline->shader;
+            shader->SetShaderVariableSamplers(handle, samplers, count, this->GetShaderDrawState(shader));
+        }
+    }
+    void Graphics::SetShaderVariableSampler(ShaderVariableHandle handle, SamplerState *sampler)
+    {
+        if (currentRenderPipeline != NULL)
+        {
+            Shader *shader = currentRenderPipeline->shader;
+            shader->SetShaderVariableSampler(handle, sampler, this->GetShaderDrawState(shader));
         }
     }
     
     void Graphics::SendUpdatedUniforms()
     {
-        if (currentRenderPipeline->shader->uniformsHasBeenSet)
+        Shader *shader = currentRenderPipeline->shader;
+        ShaderDrawState *drawState = this->GetShaderDrawState(shader);
+        if (drawState->uniformsHasBeenSet)
         {
-            currentRenderPipeline->shader->uniformsHasBeenSet = false;
-
-            currentRenderPipeline->shader->SyncUniformsWithGPU(this->currentCommandEncoderInstance);
+            shader->SyncUniformsWithGPU(this->currentCommandEncoderInstance, drawState);
+            //the next variable set claims a new slot, so this draw's stays as it was synced
+            drawState->uniformsHasBeenSet = false;
             switch (GetActiveBackend())
             {
                 #ifdef ASTRALCANVAS_VULKAN
                 case Backend_Vulkan:
                 {
+                    void *descriptorSet = drawState->descriptorSet;
+                    if (this->boundState.descriptorSet == descriptorSet && this->boundState.pipelineLayout == currentRenderPipeline->layout
+                        && this->boundState.dynamicOffsetCount == drawState->dynamicOffsetCount
+                        && memcmp(this->boundState.dynamicOffsets, drawState->dynamicOffsets, sizeof(u32) * drawState->dynamicOffsetCount) == 0)
+                    {
+                        this->skippedCommands.descriptorSetBinds += 1;
+                        break;
+                    }
+                    this->boundState.descriptorSet = descriptorSet;
+                    this->boundState.pipelineLayout = currentRenderPipeline->layout;
+                    this->boundState.dynamicOffsetCount = drawState->dynamicOffsetCount;
+                    memcpy(this->boundState.dynamicOffsets, drawState->dynamicOffsets, sizeof(u32) * drawState->dynamicOffsetCount);
+                    //binding with a layout incompatible with the one the heap was bound with disturbs the heap's set
+                    if (this->boundState.bindlessLayout != currentRenderPipeline->layout)
+                    {
+                        this->boundState.bindlessLayout = NULL;
+                    }
+
+                    this->FlushMergedDraws();
                     vkCmdBindDescriptorSets(
-                        AstralCanvasVk_GetMainCmdBuffer(), 
+                        AstralCanvasVk_GetRecordingCmdBuffer(this), 
                         VK_PIPELINE_BIND_POINT_GRAPHICS, 
                         (VkPipelineLayout)currentRenderPipeline->layout, 
                         0, 1, //descriptor set count
-                        (VkDescriptorSet*)&currentRenderPipeline->shader->descriptorSets.ptr[currentRenderPipeline->shader->descriptorForThisDrawCall],
-                        0, NULL); //dynamic offsets count
+                        (VkDescriptorSet*)&descriptorSet,
+                        drawState->dynamicOffsetCount, drawState->dynamicOffsets);
                     break;
                 }
                 #endif
@@ -559,24 +1026,74 @@ namespace AstralCanvas
                 default:
                     break;
             }
-            currentRenderPipeline->shader->descriptorForThisDrawCall += 1;
         }
 
     }
 
+    void Graphics::SetDrawMerging(bool enabled)
+    {
+        if (!enabled)
+        {
+            FlushMergedDraws();
+        }
+        this->mergeDraws = enabled;
+    }
+    void Graphics::FlushMergedDraws()
+    {
+        if (this->mergedDraws.count == 0)
+        {
+            return;
+        }
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                VkCommandBuffer cmdBuffer = AstralCanvasVk_GetRecordingCmdBuffer(this);
+                AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
+
+                AstralCanvasVkUniformAllocation allocation{};
+                if (this->mergedDraws.count > 1 && gpu->supportsMultiDrawIndirect && gpu->supportsDrawIndirectFirstInstance)
+                {
+                    allocation = AstralCanvasVk_AllocateFrameIndirect(gpu, sizeof(DrawIndexedIndirectCommand) * this->mergedDraws.count);
+                }
+                if (allocation.mappedData == NULL)
+                {
+                    //a lone draw gains nothing from going through a buffer, and without multiDrawIndirect each draw
+                    //would need its own indirect call anyway
+                    for (usize i = 0; i < this->mergedDraws.count; i++)
+                    {
+                        DrawIndexedIndirectCommand *command = &this->mergedDraws.ptr[i];
+                        vkCmdDrawIndexed(cmdBuffer, command->indexCount, command->instanceCount, command->firstIndex, command->vertexOffset, command->firstInstance);
+                    }
+                    break;
+                }
+                memcpy(allocation.mappedData, this->mergedDraws.ptr, sizeof(DrawIndexedIndirectCommand) * this->mergedDraws.count);
+
+                u32 calls = AstralCanvasVk_CmdDrawIndexedIndirect(cmdBuffer, allocation.buffer, allocation.offset, (u32)this->mergedDraws.count);
+                this->skippedCommands.mergedDraws += (u32)this->mergedDraws.count - calls;
+                break;
+            }
+            #endif
+            default:
+                break;
+        }
+        this->mergedDraws.Clear();
+    }
     void Graphics::DrawIndexedPrimitivesIndirect(ComputeBuffer* drawDataBuffer, usize drawDataBufferOffset, u32 drawCount)
     {
         if (this->currentRenderPipeline != NULL && this->currentRenderProgram != NULL)
         {
+            FlushMergedDraws();
             SendUpdatedUniforms();
             switch (GetActiveBackend())
             {
                 #ifdef ASTRALCANVAS_VULKAN
                 case Backend_Vulkan:
                 {
-                    VkCommandBuffer cmdBuffer = AstralCanvasVk_GetMainCmdBuffer();
+                    VkCommandBuffer cmdBuffer = AstralCanvasVk_GetRecordingCmdBuffer(this);
 
-                    vkCmdDrawIndexedIndirect(cmdBuffer, (VkBuffer)drawDataBuffer->handle, drawDataBufferOffset, drawCount, sizeof(DrawIndexedIndirectCommand));
+                    AstralCanvasVk_CmdDrawIndexedIndirect(cmdBuffer, (VkBuffer)drawDataBuffer->handle, drawDataBufferOffset, drawCount);
                     //vkCmdDrawIndexed(cmdBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
                     break;
                 }
@@ -611,13 +1128,19 @@ namespace AstralCanvas
     {
         if (this->currentRenderPipeline != NULL && this->currentRenderProgram != NULL)
         {
+            FlushMergedDraws();
             SendUpdatedUniforms();
             switch (GetActiveBackend())
             {
                 #ifdef ASTRALCANVAS_VULKAN
                 case Backend_Vulkan:
                 {
-                    VkCommandBuffer cmdBuffer = AstralCanvasVk_GetMainCmdBuffer();
+                    if (!AstralCanvasVk_GetCurrentGPU()->supportsDrawIndirectCount)
+                    {
+                        THROW_ERR("DrawIndexedPrimitivesIndirectCount requires the drawIndirectCount feature");
+                        break;
+                    }
+                    VkCommandBuffer cmdBuffer = AstralCanvasVk_GetRecordingCmdBuffer(this);
 
                     vkCmdDrawIndexedIndirectCount(cmdBuffer, (VkBuffer)drawDataBuffer->handle, drawDataBufferOffset, (VkBuffer)drawCountBuffer->handle, drawCountBufferOffset, maxDrawCount, sizeof(DrawIndexedIndirectCommand));
                     //vkCmdDrawIndexed(cmdBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
@@ -660,7 +1183,32 @@ namespace AstralCanvas
                 #ifdef ASTRALCANVAS_VULKAN
                 case Backend_Vulkan:
                 {
-                    VkCommandBuffer cmdBuffer = AstralCanvasVk_GetMainCmdBuffer();
+                    if (this->mergeDraws)
+                    {
+                        //draws covering adjacent index ranges collapse into one command. Joining strips or fans would
+                        //draw extra primitives across the seam, so those only share the indirect call
+                        PrimitiveType primitiveType = this->currentRenderPipeline->primitiveType;
+                        bool listTopology = primitiveType == PrimitiveType_TriangleList || primitiveType == PrimitiveType_LineList;
+                        if (listTopology && this->mergedDraws.count > 0)
+                        {
+                            DrawIndexedIndirectCommand *last = &this->mergedDraws.ptr[this->mergedDraws.count - 1];
+                            if (last->firstIndex + last->indexCount == firstIndex && last->vertexOffset == (i32)vertexOffset && last->instanceCount == instanceCount && last->firstInstance == firstInstance)
+                            {
+                                last->indexCount += indexCount;
+                                this->skippedCommands.mergedDraws += 1;
+                                break;
+                            }
+                        }
+                        DrawIndexedIndirectCommand command;
+                        command.indexCount = indexCount;
+                        command.instanceCount = instanceCount;
+                        command.firstIndex = firstIndex;
+                        command.vertexOffset = (i32)vertexOffset;
+                        command.firstInstance = firstInstance;
+                        this->mergedDraws.Add(command);
+                        break;
+                    }
+                    VkCommandBuffer cmdBuffer = AstralCanvasVk_GetRecordingCmdBuffer(this);
 
                     vkCmdDrawIndexed(cmdBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
                     break;
@@ -686,4 +1234,61 @@ namespace AstralCanvas
             //this->currentRenderPipeline = NULL;
         }
     }
+    void Graphics::DrawIndexedPrimitives(GeometryHandle handle, u32 instanceCount, u32 firstInstance)
+    {
+        if (handle.vertexCount == 0 || handle.indexCount == 0)
+        {
+            return;
+        }
+        DrawIndexedPrimitives(handle.indexCount, instanceCount, handle.firstIndex, handle.vertexOffset, firstInstance);
+    }
+    void Graphics::DispatchCompute(ComputePipeline *pipeline, u32 threadsX, u32 threadsY, u32 threadsZ)
+    {
+        if (this->currentRenderProgram != NULL)
+        {
+            THROW_ERR("DispatchCompute cannot be called inside a render program");
+            return;
+        }
+        Shader *shader = pipeline->shader;
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                VkCommandBuffer cmdBuffer = AstralCanvasVk_GetRecordingCmdBuffer(this);
+
+                //dispatching again without setting anything reuses the variables still staged in the last slot
+                ShaderDrawState *drawState = this->GetShaderDrawState(shader);
+                if (drawState->uniformsHasBeenSet)
+                {
+                    shader->SyncUniformsWithGPU(this->currentCommandEncoderInstance, drawState);
+                    drawState->uniformsHasBeenSet = false;
+                }
+
+                //the compute bind point is separate from the graphics one, so none of the bound state is disturbed
+                vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, (VkPipeline)pipeline->handle);
+                vkCmdBindDescriptorSets(
+                    cmdBuffer,
+                    VK_PIPELINE_BIND_POINT_COMPUTE,
+                    (VkPipelineLayout)pipeline->layout,
+                    0, 1, //descriptor set count
+                    (VkDescriptorSet*)&drawState->descriptorSet,
+                    drawState->dynamicOffsetCount, drawState->dynamicOffsets);
+                if (shader->shaderVariables.usesBindlessHeap && AstralCanvasVk_GetBindlessSet() != NULL)
+                {
+                    VkDescriptorSet bindlessSet = AstralCanvasVk_GetBindlessSet();
+                    vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, (VkPipelineLayout)pipeline->layout, ASTRALCANVAS_BINDLESS_SET, 1, &bindlessSet, 0, NULL);
+                }
+
+                vkCmdDispatch(cmdBuffer, threadsX, threadsY, threadsZ);
+                break;
+            }
+            #endif
+            default:
+                THROW_ERR("Unimplemented backend: Graphics DispatchCompute");
+                return;
+        }
+        //the slots it synced are released along with the draws' at the end of the frame
+        this->usedShaders.Add(shader);
+    }
 }
@@ -0,0 +1,247 @@
+#include "Graphics/GraphicsContext.hpp"
+#include "Graphics/CurrentBackend.hpp"
+#include "hash.hpp"
+#include "ErrorHandling.hpp"
+
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanInstanceData.hpp"
+#include "Graphics/Vulkan/VulkanHelpers.hpp"
+#include "Graphics/Vulkan/VulkanDestructionQueue.hpp"
+#endif
+
+namespace AstralCanvas
+{
+    GraphicsContext::GraphicsContext()
+    {
+        this->allocator = IAllocator();
+        this->graphics = Graphics();
+        this->parent = NULL;
+        this->order = 0;
+        for (u32 i = 0; i < ASTRALVULKAN_MAX_FRAMES_IN_FLIGHT; i++)
+        {
+            this->commandPools[i] = NULL;
+            this->commandBuffers[i] = collections::vector<void *>();
+            this->usedCommandBuffers[i] = 0;
+            this->poolFrameNumbers[i] = 0;
+        }
+    }
+    GraphicsContext::GraphicsContext(IAllocator allocator)
+    {
+        this->allocator = allocator;
+        this->graphics = Graphics();
+        this->graphics.usedShaders = collections::hashset<Shader*>(allocator, &PointerHash<Shader>, &PointerEql<Shader>);
+        this->graphics.mergedDraws = collections::vector<DrawIndexedIndirectCommand>(allocator);
+        this->graphics.shaderDrawStates = collections::vector<ShaderDrawState>(allocator);
+        this->parent = NULL;
+        this->order = 0;
+        for (u32 i = 0; i < ASTRALVULKAN_MAX_FRAMES_IN_FLIGHT; i++)
+        {
+            this->commandPools[i] = NULL;
+            this->commandBuffers[i] = collections::vector<void *>(allocator);
+            this->usedCommandBuffers[i] = 0;
+            this->poolFrameNumbers[i] = 0;
+        }
+
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                VkCommandPoolCreateInfo poolCreateInfo{};
+                poolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+                //buffers are only ever reset all at once through the pool
+                poolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+                poolCreateInfo.queueFamilyIndex = AstralCanvasVk_GetCurrentGPU()->queueInfo.dedicatedGraphicsQueueIndex;
+
+                for (u32 i = 0; i < AstralCanvasVk_GetFramesInFlight(); i++)
+                {
+                    VkCommandPool pool;
+                    if (vkCreateCommandPool(AstralCanvasVk_GetCurrentGPU()->logicalDevice, &poolCreateInfo, NULL, &pool) != VK_SUCCESS)
+                    {
+                        THROW_ERR("Failed to create graphics context command pool");
+                    }
+                    this->commandPools[i] = pool;
+                }
+                break;
+            }
+            #endif
+            default:
+                THROW_ERR("Unimplemented backend: GraphicsContext");
+                break;
+        }
+    }
+    bool GraphicsContext::Begin(Graphics *parent, u32 order)
+    {
+        if (parent->currentRenderProgram == NULL || !parent->executesSecondaryCommands)
+        {
+            LOG_WARNING("GraphicsContext can only begin while the parent is in a render program started with useGraphicsContexts");
+            return false;
+        }
+        this->parent = parent;
+        this->order = order;
+
+        this->graphics.currentWindow = parent->currentWindow;
+        this->graphics.currentRenderProgram = parent->currentRenderProgram;
+        this->graphics.currentRenderPass = parent->currentRenderPass;
+        this->graphics.currentRenderTarget = parent->currentRenderTarget;
+        this->graphics.currentRenderPipeline = NULL;
+        this->graphics.currentIndexBuffer = NULL;
+        this->graphics.clearColor = parent->clearColor;
+        this->graphics.Viewport = parent->Viewport;
+        this->graphics.ClipArea = parent->ClipArea;
+        //every Begin records into a fresh secondary command buffer
+        this->graphics.ResetBoundState();
+        //slots claimed in an earlier frame may have been handed out again since
+        for (usize i = 0; i < this->graphics.shaderDrawStates.count; i++)
+        {
+            this->graphics.shaderDrawStates.ptr[i].uniformsHasBeenSet = false;
+        }
+
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                VkDevice device = AstralCanvasVk_GetCurrentGPU()->logicalDevice;
+                u32 frame = AstralCanvasVk_GetCurrentFrame();
+                u64 frameNumber = AstralCanvasVk_GetFrameNumber();
+
+                //the parent's BeginDraw already waited on this frame's fence, so nothing recorded
+                //into the pool the last time this slot came around can still be executing
+                if (this->poolFrameNumbers[frame] != frameNumber)
+                {
+                    vkResetCommandPool(device, (VkCommandPool)this->commandPools[frame], 0);
+                    this->usedCommandBuffers[frame] = 0;
+                    this->poolFrameNumbers[frame] = frameNumber;
+                }
+
+                VkCommandBuffer cmdBuffer;
+                if (this->usedCommandBuffers[frame] < this->commandBuffers[frame].count)
+                {
+                    cmdBuffer = (VkCommandBuffer)this->commandBuffers[frame].ptr[this->usedCommandBuffers[frame]];
+                }
+                else
+                {
+                    VkCommandBufferAllocateInfo allocInfo{};
+                    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+                    allocInfo.commandPool = (VkCommandPool)this->commandPools[frame];
+                    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+                    allocInfo.commandBufferCount = 1;
+                    if (vkAllocateCommandBuffers(device, &allocInfo, &cmdBuffer) != VK_SUCCESS)
+                    {
+                        LOG_WARNING("Failed to allocate secondary command buffer");
+                        return false;
+                    }
+                    this->commandBuffers[frame].Add(cmdBuffer);
+                }
+                this->usedCommandBuffers[frame] += 1;
+
+                RenderTarget *renderTarget = parent->currentRenderTarget;
+                if (renderTarget == NULL)
+                {
+                    AstralVulkanSwapchain *swapchain = (AstralVulkanSwapchain *)parent->currentWindow->swapchain;
+                    renderTarget = &swapchain->renderTargets.data[swapchain->currentImageIndex];
+                }
+
+                VkCommandBufferInheritanceInfo inheritanceInfo{};
+                inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+                inheritanceInfo.renderPass = (VkRenderPass)parent->currentRenderProgram->handle;
+                inheritanceInfo.subpass = parent->currentRenderPass;
+                inheritanceInfo.framebuffer = (VkFramebuffer)renderTarget->renderTargetHandle;
+
+                //programs drawn with dynamic rendering have no render pass to inherit, only attachment formats
+                VkFormat colorFormats[ASTRALVULKAN_MAX_COLOR_ATTACHMENTS];
+                VkCommandBufferInheritanceRenderingInfo renderingInheritanceInfo{};
+                if (parent->currentRenderProgram->usesDynamicRendering)
+                {
+                    renderingInheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+                    renderingInheritanceInfo.colorAttachmentCount = AstralCanvasVk_GetPassAttachmentFormats(parent->currentRenderProgram, 0, colorFormats, &renderingInheritanceInfo.depthAttachmentFormat, &renderingInheritanceInfo.stencilAttachmentFormat);
+                    renderingInheritanceInfo.pColorAttachmentFormats = colorFormats;
+                    renderingInheritanceInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+                    inheritanceInfo.pNext = &renderingInheritanceInfo;
+                    inheritanceInfo.renderPass = NULL;
+                    inheritanceInfo.subpass = 0;
+                    inheritanceInfo.framebuffer = NULL;
+                }
+
+                VkCommandBufferBeginInfo beginInfo{};
+                beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+                beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+                beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+                if (vkBeginCommandBuffer(cmdBuffer, &beginInfo) != VK_SUCCESS)
+                {
+                    LOG_WARNING("Failed to begin secondary command buffer");
+                    return false;
+                }
+                this->graphics.recordingCommandBuffer = cmdBuffer;
+                break;
+            }
+            #endif
+            default:
+                THROW_ERR("Unimplemented backend: GraphicsContext Begin");
+                break;
+        }
+        return true;
+    }
+    void GraphicsContext::End()
+    {
+        if (this->graphics.recordingCommandBuffer == NULL)
+        {
+            return;
+        }
+        this->graphics.FlushMergedDraws();
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                vkEndCommandBuffer((VkCommandBuffer)this->graphics.recordingCommandBuffer);
+                break;
+            }
+            #endif
+            default:
+                break;
+        }
+        this->parent->SubmitSecondaryCommands(this->graphics.recordingCommandBuffer, this->order, &this->graphics.usedShaders);
+        this->graphics.recordingCommandBuffer = NULL;
+        this->graphics.currentRenderProgram = NULL;
+        this->graphics.currentRenderPipeline = NULL;
+        this->parent = NULL;
+    }
+    void GraphicsContext::deinit()
+    {
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                for (u32 i = 0; i < ASTRALVULKAN_MAX_FRAMES_IN_FLIGHT; i++)
+                {
+                    if (this->commandPools[i] != NULL)
+                    {
+                        //frees all command buffers allocated from the pool along with it, once the frames executing them retire
+                        AstralCanvasVk_QueueDestroyCommandPool((VkCommandPool)this->commandPools[i]);
+                        this->commandPools[i] = NULL;
+                    }
+                }
+                break;
+            }
+            #endif
+            default:
+                break;
+        }
+        for (u32 i = 0; i < ASTRALVULKAN_MAX_FRAMES_IN_FLIGHT; i++)
+        {
+            this->commandBuffers[i].deinit();
+        }
+        this->graphics.usedShaders.deinit();
+        this->graphics.mergedDraws.deinit();
+        for (usize i = 0; i < this->graphics.shaderDrawStates.count; i++)
+        {
+            this->graphics.shaderDrawStates.ptr[i].deinit();
+        }
+        this->graphics.shaderDrawStates.deinit();
+    }
+}
@@ -1,9 +1,12 @@
 #include "Graphics/IndexBuffer.hpp"
 #include "Graphics/CurrentBackend.hpp"
+#include "ErrorHandling.hpp"
 
 #ifdef ASTRALCANVAS_VULKAN
 #include "Graphics/Vulkan/VulkanHelpers.hpp"
+#include "Graphics/Vulkan/VulkanStaging.hpp"
 #include "Graphics/Vulkan/vk_mem_alloc.h"
+#include "Graphics/Vulkan/VulkanDestructionQueue.hpp"
 #endif
 
 #ifdef ASTRALCANVAS_METAL
@@ -48,7 +51,7 @@ namespace AstralCanvas
                     size *= 4;
 
                 this->handle = AstralCanvasVk_CreateResourceBuffer(AstralCanvasVk_GetCurrentGPU(), size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
-                this->memoryAllocation = AstralCanvasVk_AllocateMemoryForBuffer((VkBuffer)this->handle, VMA_MEMORY_USAGE_GPU_ONLY, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+                this->memoryAllocation = AstralCanvasVk_AllocateMemoryForBuffer((VkBuffer)this->handle, AstralCanvas::GPUMemoryKind_Index, VMA_MEMORY_USAGE_GPU_ONLY, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
                 break;
             }
             #endif
@@ -72,16 +75,7 @@ namespace AstralCanvas
             #ifdef ASTRALCANVAS_VULKAN
             case Backend_Vulkan:
             {
-                AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
-                VkBuffer stagingBuffer = AstralCanvasVk_CreateResourceBuffer(gpu, lengthOfBytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
-                MemoryAllocation stagingMemory = AstralCanvasVk_AllocateMemoryForBuffer(stagingBuffer, VMA_MEMORY_USAGE_CPU_TO_GPU, (VkMemoryPropertyFlagBits)(VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT));
-
-                memcpy(stagingMemory.vkAllocationInfo.pMappedData, bytes, lengthOfBytes);
-
-                AstralCanvasVk_CopyBufferToBuffer(gpu, stagingBuffer, (VkBuffer)this->handle, lengthOfBytes);
-
-                vkDestroyBuffer(gpu->logicalDevice, stagingBuffer, NULL);
-                vmaFreeMemory(AstralCanvasVk_GetCurrentVulkanAllocator(), stagingMemory.vkAllocation);
+                AstralCanvasVk_StageBufferUpload(AstralCanvasVk_GetCurrentGPU(), bytes, lengthOfBytes, (VkBuffer)this->handle, 0);
 
                 break;
             }
@@ -104,18 +98,50 @@ namespace AstralCanvas
                 break;
         }
     }
-    void IndexBuffer::deinit()
+    void IndexBuffer::SetData(u8* bytes, usize lengthOfBytes, usize startIndex)
     {
+        usize offset = startIndex * (this->indexElementSize == IndexBufferSize_U16 ? 2 : 4);
         switch (GetActiveBackend())
         {
             #ifdef ASTRALCANVAS_VULKAN
             case Backend_Vulkan:
             {
-                AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
-
-                vkDestroyBuffer(gpu->logicalDevice, (VkBuffer)this->handle, NULL);
+                AstralCanvasVk_StageBufferUpload(AstralCanvasVk_GetCurrentGPU(), bytes, lengthOfBytes, (VkBuffer)this->handle, offset);
 
-                vmaFreeMemory(AstralCanvasVk_GetCurrentVulkanAllocator(), this->memoryAllocation.vkAllocation);
+                break;
+            }
+            #endif
+            #ifdef ASTRALCANVAS_METAL
+            case Backend_Metal:
+            {
+                if (startIndex != 0)
+                {
+                    THROW_ERR("Unimplemented backend: IndexBuffer SetData at an offset");
+                    break;
+                }
+                AstralCanvasMetal_CreateIndexBuffer(this, bytes, lengthOfBytes);
+                break;
+            }
+            #endif
+            #ifdef ASTRALCANVAS_OPENGL
+            case Backend_OpenGL:
+            {
+                glNamedBufferSubData((u32)this->handle, offset, lengthOfBytes, bytes);
+            }
+            break;
+            #endif
+            default:
+                break;
+        }
+    }
+    void IndexBuffer::deinit()
+    {
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                AstralCanvasVk_QueueDestroyBuffer((VkBuffer)this->handle, AstralCanvas::GPUMemoryKind_Index, &this->memoryAllocation);
                 break;
             }
             #endif
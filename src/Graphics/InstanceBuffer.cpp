@@ -3,7 +3,9 @@
 
 #ifdef ASTRALCANVAS_VULKAN
 #include "Graphics/Vulkan/VulkanHelpers.hpp"
+#include "Graphics/Vulkan/VulkanStaging.hpp"
 #include "Graphics/Vulkan/vk_mem_alloc.h"
+#include "Graphics/Vulkan/VulkanDestructionQueue.hpp"
 #endif
 
 #ifdef ASTRALCANVAS_METAL
@@ -22,14 +24,18 @@ namespace AstralCanvas
         this->memoryAllocation.unused = 0;
         this->instanceCount = 0;
         this->instanceSize = 0;
+        this->isDynamic = false;
+        this->regions = DynamicBufferRegions();
     }
-    InstanceBuffer::InstanceBuffer(usize instanceSize, usize instanceCount, bool canRead)
+    InstanceBuffer::InstanceBuffer(usize instanceSize, usize instanceCount, bool canRead, bool isDynamic)
     {
         this->canRead = canRead;
         this->instanceSize = instanceSize;
         this->instanceCount = instanceCount;
         this->handle = NULL;
         this->memoryAllocation.unused = 0;
+        this->isDynamic = isDynamic;
+        this->regions = DynamicBufferRegions();
 
         this->Construct();
     }
@@ -45,9 +51,22 @@ namespace AstralCanvas
                 {
                     bufferUsage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
                 }
-                this->handle = AstralCanvasVk_CreateResourceBuffer(AstralCanvasVk_GetCurrentGPU(), this->instanceCount * this->instanceSize, bufferUsage);
+                usize bufferSize = this->instanceCount * this->instanceSize;
+                if (this->isDynamic)
+                {
+                    this->regions = DynamicBufferRegions(bufferSize);
+                    bufferSize = this->regions.GetTotalSize();
+                }
+                this->handle = AstralCanvasVk_CreateResourceBuffer(AstralCanvasVk_GetCurrentGPU(), bufferSize, bufferUsage);
 
-                this->memoryAllocation = AstralCanvasVk_AllocateMemoryForBuffer((VkBuffer)this->handle, VMA_MEMORY_USAGE_CPU_TO_GPU, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+                if (this->isDynamic)
+                {
+                    this->memoryAllocation = AstralCanvasVk_AllocateMemoryForBuffer((VkBuffer)this->handle, AstralCanvas::GPUMemoryKind_Vertex, VMA_MEMORY_USAGE_CPU_TO_GPU, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+                }
+                else
+                {
+                    this->memoryAllocation = AstralCanvasVk_AllocateMemoryForBuffer((VkBuffer)this->handle, AstralCanvas::GPUMemoryKind_Vertex, VMA_MEMORY_USAGE_GPU_ONLY, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, false);
+                }
                 break;
             }
             #endif
@@ -78,7 +97,16 @@ namespace AstralCanvas
             #ifdef ASTRALCANVAS_VULKAN
             case Backend_Vulkan:
             {
-                memcpy(this->memoryAllocation.vkAllocationInfo.pMappedData, instancesData, count * this->instanceSize);
+                if (this->isDynamic)
+                {
+                    usize regionOffset = this->regions.BeginWrite();
+                    memcpy((u8 *)this->memoryAllocation.vkAllocationInfo.pMappedData + regionOffset, instancesData, count * this->instanceSize);
+                }
+                else
+                {
+                    //staged rather than written in place, as frames still in flight may be reading the previous contents
+                    AstralCanvasVk_StageBufferUpload(AstralCanvasVk_GetCurrentGPU(), instancesData, count * this->instanceSize, (VkBuffer)this->handle, 0);
+                }
 
                 break;
             }
@@ -108,11 +136,7 @@ namespace AstralCanvas
             #ifdef ASTRALCANVAS_VULKAN
             case Backend_Vulkan:
             {
-                AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
-
-                vkDestroyBuffer(gpu->logicalDevice, (VkBuffer)this->handle, NULL);
-
-                vmaFreeMemory(AstralCanvasVk_GetCurrentVulkanAllocator(), this->memoryAllocation.vkAllocation);
+                AstralCanvasVk_QueueDestroyBuffer((VkBuffer)this->handle, AstralCanvas::GPUMemoryKind_Vertex, &this->memoryAllocation);
                 break;
             }
             #endif
@@ -0,0 +1,57 @@
+#include "Graphics/MemoryStatistics.hpp"
+#include "Graphics/CurrentBackend.hpp"
+#include <string.h>
+
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanMemoryStatistics.hpp"
+#endif
+
+namespace AstralCanvas
+{
+    bool GetGPUMemoryStatistics(GPUMemoryStatistics *result)
+    {
+        memset(result, 0, sizeof(GPUMemoryStatistics));
+        switch (GetActiveBackend())
+        {
+#ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                AstralCanvasVk_GetMemoryStatistics(result);
+                return true;
+            }
+#endif
+            default:
+                return false;
+        }
+    }
+    void ResetGPUMemoryPeaks()
+    {
+        switch (GetActiveBackend())
+        {
+#ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                AstralCanvasVk_ResetMemoryPeaks();
+                break;
+            }
+#endif
+            default:
+                break;
+        }
+    }
+    void SetGPUMemorySoftBudget(float budgetFraction, GPUMemoryBudgetCallback callback)
+    {
+        switch (GetActiveBackend())
+        {
+#ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                AstralCanvasVk_SetMemorySoftBudget(budgetFraction, callback);
+                break;
+            }
+#endif
+            default:
+                break;
+        }
+    }
+}
@@ -465,7 +465,7 @@ void AstralCanvasMetal_AddUniformDescriptorSets(AstralCanvas::Shader *shader)
     
     AstralCanvas::ShaderVariables shaderVariables = shader->shaderVariables;
     //Metal doesnt have descriptor set objects like Vulkan, so just add NULL to fill the buffer up
-    shader->descriptorSets.Add(NULL);
+    shader->descriptorSlotCount += 1;
     for (usize i = 0; i < shaderVariables.uniforms.capacity; i++)
     {
         AstralCanvas::ShaderResource *resource = &shaderVariables.uniforms.ptr[i];
@@ -502,7 +502,7 @@ void AstralCanvasMetal_AddUniformDescriptorSets(AstralCanvas::Shader *shader)
         }
     }
 }
-void AstralCanvasMetal_SyncUniformsWithGPU(void *commandEncoder, AstralCanvas::Shader *shader)
+void AstralCanvasMetal_SyncUniformsWithGPU(void *commandEncoder, AstralCanvas::Shader *shader, usize descriptorSlot)
 {
     id<MTLRenderCommandEncoder> encoder = (id<MTLRenderCommandEncoder>)commandEncoder;
     for (usize i = 0; i < shader->shaderVariables.uniforms.capacity; i++)
@@ -510,7 +510,7 @@ void AstralCanvasMetal_SyncUniformsWithGPU(void *commandEncoder, AstralCanvas::S
         if (shader->shaderVariables.uniforms.ptr[i].variableName.buffer != NULL)
         {
             //should never throw out of range error since CheckDescriptorSetAvailability() is always called prior to this
-            AstralCanvas::ShaderStagingMutableState *toMutate = &shader->shaderVariables.uniforms.ptr[i].stagingData.ptr[shader->descriptorForThisDrawCall];
+            AstralCanvas::ShaderStagingMutableState *toMutate = &shader->shaderVariables.uniforms.ptr[i].stagingData.ptr[descriptorSlot];
             if (!toMutate->mutated)
             {
                 continue;
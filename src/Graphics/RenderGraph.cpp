@@ -0,0 +1,766 @@
+#include "Graphics/RenderGraph.hpp"
+#include "Graphics/CurrentBackend.hpp"
+#include "ErrorHandling.hpp"
+
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanInstanceData.hpp"
+#include "Graphics/Vulkan/VulkanHelpers.hpp"
+#include "Graphics/Vulkan/VulkanBarriers.hpp"
+#include "Graphics/Vulkan/VulkanEnumConverters.hpp"
+#include "Graphics/Vulkan/VulkanDestructionQueue.hpp"
+#endif
+
+namespace AstralCanvas
+{
+    RenderGraph::RenderGraph()
+    {
+        this->allocator = IAllocator{};
+        this->textures = collections::vector<RenderGraphTexture>();
+        this->passes = collections::vector<RenderGraphPass>();
+        this->memoryBlocks = collections::vector<RenderGraphMemoryBlock>();
+        this->executionOrder = collections::vector<u32>();
+        this->compiled = false;
+    }
+    RenderGraph::RenderGraph(IAllocator allocator)
+    {
+        this->allocator = allocator;
+        this->textures = collections::vector<RenderGraphTexture>(allocator);
+        this->passes = collections::vector<RenderGraphPass>(allocator);
+        this->memoryBlocks = collections::vector<RenderGraphMemoryBlock>(allocator);
+        this->executionOrder = collections::vector<u32>(allocator);
+        this->compiled = false;
+    }
+
+    RenderGraphResource RenderGraph::CreateTexture(u32 width, u32 height, ImageFormat imageFormat)
+    {
+        if (imageFormat == ImageFormat_BackbufferFormat)
+        {
+            //guaranteed to be B8G8R8A8 Unorm for now, same as Texture2D
+            imageFormat = ImageFormat_B8G8R8A8Unorm;
+        }
+        RenderGraphTexture texture = {};
+        texture.type = RenderGraphResource_Transient;
+        texture.width = width;
+        texture.height = height;
+        texture.imageFormat = imageFormat;
+        texture.isOutput = false;
+        texture.texture = NULL;
+        this->textures.Add(texture);
+        this->compiled = false;
+        return (RenderGraphResource)(this->textures.count - 1);
+    }
+    RenderGraphResource RenderGraph::ImportTexture(Texture2D *texture, bool isOutput)
+    {
+        RenderGraphTexture imported = {};
+        imported.type = RenderGraphResource_Imported;
+        imported.width = texture->width;
+        imported.height = texture->height;
+        imported.imageFormat = texture->imageFormat;
+        imported.isOutput = isOutput;
+        imported.texture = texture;
+        this->textures.Add(imported);
+        this->compiled = false;
+        return (RenderGraphResource)(this->textures.count - 1);
+    }
+    RenderGraphResource RenderGraph::ImportBackbuffer()
+    {
+        RenderGraphTexture backbuffer = {};
+        backbuffer.type = RenderGraphResource_Backbuffer;
+        backbuffer.imageFormat = ImageFormat_B8G8R8A8Unorm;
+        backbuffer.isOutput = true;
+        backbuffer.texture = NULL;
+        this->textures.Add(backbuffer);
+        this->compiled = false;
+        return (RenderGraphResource)(this->textures.count - 1);
+    }
+
+    u32 RenderGraph::AddPass(const char *name, RenderGraphPassFunction execute, void *userData)
+    {
+        RenderGraphPass pass = {};
+        pass.name = name;
+        pass.execute = execute;
+        pass.userData = userData;
+        pass.reads = collections::vector<RenderGraphResource>(this->allocator);
+        pass.colorWrites = collections::vector<RenderGraphResource>(this->allocator);
+        pass.colorClears = collections::vector<bool>(this->allocator);
+        pass.clearValues = collections::vector<Color>(this->allocator);
+        pass.depthWrite = -1;
+        pass.program = RenderProgram();
+        this->passes.Add(pass);
+        this->compiled = false;
+        return (u32)(this->passes.count - 1);
+    }
+    void RenderGraph::PassReads(u32 pass, RenderGraphResource resource)
+    {
+        this->passes.ptr[pass].reads.Add(resource);
+        this->compiled = false;
+    }
+    void RenderGraph::PassWrites(u32 pass, RenderGraphResource resource, bool clear, Color clearValue)
+    {
+        this->passes.ptr[pass].colorWrites.Add(resource);
+        this->passes.ptr[pass].colorClears.Add(clear);
+        this->passes.ptr[pass].clearValues.Add(clearValue);
+        this->compiled = false;
+    }
+    void RenderGraph::PassWritesDepth(u32 pass, RenderGraphResource resource, bool clear)
+    {
+        this->passes.ptr[pass].depthWrite = resource;
+        this->passes.ptr[pass].clearDepth = clear;
+        this->compiled = false;
+    }
+
+    inline bool RenderGraphPassWrites(RenderGraphPass *pass, RenderGraphResource resource)
+    {
+        if (pass->depthWrite == resource)
+        {
+            return true;
+        }
+        for (usize i = 0; i < pass->colorWrites.count; i++)
+        {
+            if (pass->colorWrites.ptr[i] == resource)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+    inline bool RenderGraphPassReads(RenderGraphPass *pass, RenderGraphResource resource)
+    {
+        for (usize i = 0; i < pass->reads.count; i++)
+        {
+            if (pass->reads.ptr[i] == resource)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool RenderGraph::Compile()
+    {
+        this->ReleaseCompiled();
+
+        usize passCount = this->passes.count;
+        usize textureCount = this->textures.count;
+        if (passCount == 0)
+        {
+            this->compiled = true;
+            return true;
+        }
+
+        //transient textures can only be pointed to once the vector has stopped growing
+        for (usize i = 0; i < textureCount; i++)
+        {
+            RenderGraphTexture *texture = &this->textures.ptr[i];
+            if (texture->type == RenderGraphResource_Transient)
+            {
+                texture->texture = &texture->transientTexture;
+            }
+            texture->firstUse = -1;
+            texture->lastUse = -1;
+            texture->memoryBlock = -1;
+            texture->aliasesPrevious = false;
+        }
+
+        //culling: a pass survives if it writes to something that is needed.
+        //Repeated until nothing changes as passes need not be declared in order
+        bool *needed = (bool *)this->allocator.Allocate(sizeof(bool) * textureCount);
+        for (usize i = 0; i < textureCount; i++)
+        {
+            needed[i] = this->textures.ptr[i].isOutput || this->textures.ptr[i].type == RenderGraphResource_Backbuffer;
+        }
+        for (usize i = 0; i < passCount; i++)
+        {
+            this->passes.ptr[i].culled = true;
+        }
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+            for (usize i = 0; i < passCount; i++)
+            {
+                RenderGraphPass *pass = &this->passes.ptr[i];
+                if (!pass->culled)
+                {
+                    continue;
+                }
+                bool contributes = pass->depthWrite > -1 && needed[pass->depthWrite];
+                for (usize j = 0; j < pass->colorWrites.count; j++)
+                {
+                    contributes = contributes || needed[pass->colorWrites.ptr[j]];
+                }
+                if (contributes)
+                {
+                    pass->culled = false;
+                    changed = true;
+                    for (usize j = 0; j < pass->reads.count; j++)
+                    {
+                        needed[pass->reads.ptr[j]] = true;
+                    }
+                }
+            }
+        }
+        this->allocator.Free(needed);
+
+        //ordering: writers of a texture run in the order they were declared. A reader runs after the writer declared
+        //before it, or the first writer if it was declared before all of them, and before the writer that follows that
+        //one, so that it never sees contents meant for a later pass. Among passes that are free to run, the earliest
+        //declared goes first
+        u32 *dependencyCounts = (u32 *)this->allocator.Allocate(sizeof(u32) * passCount);
+        //dependencies[i * passCount + j] is true if pass j must run before pass i
+        bool *dependencies = (bool *)this->allocator.Allocate(sizeof(bool) * passCount * passCount);
+        for (usize i = 0; i < passCount * passCount; i++)
+        {
+            dependencies[i] = false;
+        }
+        u32 *writers = (u32 *)this->allocator.Allocate(sizeof(u32) * passCount);
+        for (usize t = 0; t < textureCount; t++)
+        {
+            usize writerCount = 0;
+            for (usize i = 0; i < passCount; i++)
+            {
+                RenderGraphPass *pass = &this->passes.ptr[i];
+                if (!pass->culled && RenderGraphPassWrites(pass, (RenderGraphResource)t))
+                {
+                    if (RenderGraphPassReads(pass, (RenderGraphResource)t))
+                    {
+                        LOG_WARNING("Render graph pass reads from a texture it also writes to");
+                        this->allocator.Free(writers);
+                        this->allocator.Free(dependencyCounts);
+                        this->allocator.Free(dependencies);
+                        return false;
+                    }
+                    if (writerCount > 0)
+                    {
+                        dependencies[i * passCount + writers[writerCount - 1]] = true;
+                    }
+                    writers[writerCount] = (u32)i;
+                    writerCount += 1;
+                }
+            }
+            for (usize i = 0; i < passCount; i++)
+            {
+                RenderGraphPass *pass = &this->passes.ptr[i];
+                if (pass->culled || !RenderGraphPassReads(pass, (RenderGraphResource)t))
+                {
+                    continue;
+                }
+                if (writerCount == 0)
+                {
+                    if (this->textures.ptr[t].type == RenderGraphResource_Transient)
+                    {
+                        LOG_WARNING("Render graph pass reads from a transient texture that is never written to");
+                    }
+                    continue;
+                }
+                usize writer = 0;
+                while (writer + 1 < writerCount && writers[writer + 1] < (u32)i)
+                {
+                    writer += 1;
+                }
+                dependencies[i * passCount + writers[writer]] = true;
+                if (writer + 1 < writerCount)
+                {
+                    dependencies[writers[writer + 1] * passCount + i] = true;
+                }
+            }
+        }
+        this->allocator.Free(writers);
+        usize livePassCount = 0;
+        for (usize i = 0; i < passCount; i++)
+        {
+            dependencyCounts[i] = 0;
+            for (usize j = 0; j < passCount; j++)
+            {
+                if (dependencies[i * passCount + j])
+                {
+                    dependencyCounts[i] += 1;
+                }
+            }
+            if (!this->passes.ptr[i].culled)
+            {
+                livePassCount += 1;
+            }
+        }
+        while (this->executionOrder.count < livePassCount)
+        {
+            i32 next = -1;
+            for (usize i = 0; i < passCount; i++)
+            {
+                if (!this->passes.ptr[i].culled && dependencyCounts[i] == 0)
+                {
+                    next = (i32)i;
+                    break;
+                }
+            }
+            if (next == -1)
+            {
+                LOG_WARNING("Render graph contains a cycle");
+                this->allocator.Free(dependencyCounts);
+                this->allocator.Free(dependencies);
+                this->executionOrder.Clear();
+                return false;
+            }
+            this->executionOrder.Add((u32)next);
+            //never picked again
+            dependencyCounts[next] = 0xFFFFFFFF;
+            for (usize i = 0; i < passCount; i++)
+            {
+                if (dependencies[i * passCount + next])
+                {
+                    dependencyCounts[i] -= 1;
+                }
+            }
+        }
+        this->allocator.Free(dependencyCounts);
+        this->allocator.Free(dependencies);
+
+        //lifetimes, as positions in the execution order
+        for (usize i = 0; i < this->executionOrder.count; i++)
+        {
+            RenderGraphPass *pass = &this->passes.ptr[this->executionOrder.ptr[i]];
+            for (usize t = 0; t < textureCount; t++)
+            {
+                if (RenderGraphPassReads(pass, (RenderGraphResource)t) || RenderGraphPassWrites(pass, (RenderGraphResource)t))
+                {
+                    RenderGraphTexture *texture = &this->textures.ptr[t];
+                    if (texture->firstUse == -1)
+                    {
+                        texture->firstUse = (i32)i;
+                    }
+                    texture->lastUse = (i32)i;
+                }
+            }
+        }
+
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
+                VmaAllocator vma = AstralCanvasVk_GetCurrentVulkanAllocator();
+
+                //create the transient images first, their memory requirements decide which can share a block
+                VkMemoryRequirements *requirements = (VkMemoryRequirements *)this->allocator.Allocate(sizeof(VkMemoryRequirements) * textureCount);
+                for (usize t = 0; t < textureCount; t++)
+                {
+                    RenderGraphTexture *texture = &this->textures.ptr[t];
+                    if (texture->type != RenderGraphResource_Transient || texture->firstUse == -1)
+                    {
+                        continue;
+                    }
+                    VkImageCreateInfo createInfo = {};
+                    createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+                    createInfo.imageType = VK_IMAGE_TYPE_2D;
+                    createInfo.extent.width = texture->width;
+                    createInfo.extent.height = texture->height;
+                    createInfo.extent.depth = 1;
+                    createInfo.mipLevels = 1;
+                    createInfo.arrayLayers = 1;
+                    createInfo.format = AstralCanvasVk_FromImageFormat(texture->imageFormat);
+                    createInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+                    createInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                    if (texture->imageFormat > ImageFormat_DepthNone)
+                    {
+                        createInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+                    }
+                    else
+                    {
+                        createInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+                    }
+                    createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+                    createInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+
+                    VkImage image;
+                    if (vkCreateImage(gpu->logicalDevice, &createInfo, NULL, &image) != VK_SUCCESS)
+                    {
+                        THROW_ERR("Failed to create render graph texture");
+                    }
+                    vkGetImageMemoryRequirements(gpu->logicalDevice, image, &requirements[t]);
+                    texture->transientTexture = {};
+                    texture->transientTexture.imageHandle = image;
+                }
+
+                //greedily place each texture in the first block whose last user is done before it starts,
+                //growing the block if needed. Textures are visited by when they are first used
+                collections::vector<u64> blockAlignments = collections::vector<u64>(this->allocator);
+                for (usize i = 0; i < this->executionOrder.count; i++)
+                {
+                    for (usize t = 0; t < textureCount; t++)
+                    {
+                        RenderGraphTexture *texture = &this->textures.ptr[t];
+                        if (texture->type != RenderGraphResource_Transient || texture->firstUse != (i32)i)
+                        {
+                            continue;
+                        }
+                        for (usize b = 0; b < this->memoryBlocks.count; b++)
+                        {
+                            RenderGraphMemoryBlock *block = &this->memoryBlocks.ptr[b];
+                            if (block->lastUse < texture->firstUse && (block->memoryTypeBits & requirements[t].memoryTypeBits) != 0)
+                            {
+                                texture->memoryBlock = (i32)b;
+                                texture->aliasesPrevious = true;
+                                break;
+                            }
+                        }
+                        if (texture->memoryBlock == -1)
+                        {
+                            RenderGraphMemoryBlock block = {};
+                            block.size = 0;
+                            block.memoryTypeBits = 0xFFFFFFFF;
+                            this->memoryBlocks.Add(block);
+                            blockAlignments.Add(1);
+                            texture->memoryBlock = (i32)(this->memoryBlocks.count - 1);
+                        }
+                        RenderGraphMemoryBlock *block = &this->memoryBlocks.ptr[texture->memoryBlock];
+                        if (requirements[t].size > block->size)
+                        {
+                            block->size = requirements[t].size;
+                        }
+                        if (requirements[t].alignment > blockAlignments.ptr[texture->memoryBlock])
+                        {
+                            blockAlignments.ptr[texture->memoryBlock] = requirements[t].alignment;
+                        }
+                        block->memoryTypeBits &= requirements[t].memoryTypeBits;
+                        block->lastUse = texture->lastUse;
+                    }
+                }
+
+                for (usize b = 0; b < this->memoryBlocks.count; b++)
+                {
+                    RenderGraphMemoryBlock *block = &this->memoryBlocks.ptr[b];
+
+                    VkMemoryRequirements blockRequirements;
+                    blockRequirements.size = block->size;
+                    blockRequirements.alignment = blockAlignments.ptr[b];
+                    blockRequirements.memoryTypeBits = block->memoryTypeBits;
+
+                    VmaAllocationCreateInfo allocationCreateInfo = {};
+                    allocationCreateInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+                    allocationCreateInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+                    if (vmaAllocateMemory(vma, &blockRequirements, &allocationCreateInfo, &block->memory.vkAllocation, &block->memory.vkAllocationInfo) != VK_SUCCESS)
+                    {
+                        THROW_ERR("Failed to allocate render graph memory");
+                    }
+                    else
+                    {
+                        AstralCanvasVk_TrackAllocation(GPUMemoryKind_Texture, &block->memory);
+                    }
+                }
+                blockAlignments.deinit();
+
+                bool bound = true;
+                for (usize t = 0; t < textureCount && bound; t++)
+                {
+                    RenderGraphTexture *texture = &this->textures.ptr[t];
+                    if (texture->type != RenderGraphResource_Transient || texture->firstUse == -1)
+                    {
+                        continue;
+                    }
+                    VkImage image = (VkImage)texture->transientTexture.imageHandle;
+                    //the block's allocation may have failed above
+                    VmaAllocation blockAllocation = this->memoryBlocks.ptr[texture->memoryBlock].memory.vkAllocation;
+                    bound = blockAllocation != NULL && vmaBindImageMemory(vma, blockAllocation, image) == VK_SUCCESS;
+                }
+                this->allocator.Free(requirements);
+                if (!bound)
+                {
+                    LOG_WARNING("Failed to bind render graph texture memory");
+                    //nothing has been recorded with the images or memory yet, but they go through the queue like any other release
+                    for (usize t = 0; t < textureCount; t++)
+                    {
+                        RenderGraphTexture *texture = &this->textures.ptr[t];
+                        if (texture->type == RenderGraphResource_Transient && texture->firstUse > -1)
+                        {
+                            AstralCanvasVk_QueueDestroyImage((VkImage)texture->transientTexture.imageHandle, GPUMemoryKind_Texture, NULL);
+                            texture->transientTexture = {};
+                            texture->memoryBlock = -1;
+                        }
+                    }
+                    for (usize b = 0; b < this->memoryBlocks.count; b++)
+                    {
+                        AstralCanvasVk_QueueFreeMemory(GPUMemoryKind_Texture, &this->memoryBlocks.ptr[b].memory);
+                    }
+                    this->memoryBlocks.Clear();
+                    this->executionOrder.Clear();
+                    return false;
+                }
+                for (usize t = 0; t < textureCount; t++)
+                {
+                    RenderGraphTexture *texture = &this->textures.ptr[t];
+                    if (texture->type != RenderGraphResource_Transient || texture->firstUse == -1)
+                    {
+                        continue;
+                    }
+                    VkImage image = (VkImage)texture->transientTexture.imageHandle;
+                    texture->transientTexture = CreateTextureFromHandle(image, texture->width, texture->height, texture->imageFormat, true);
+                }
+                break;
+            }
+            #endif
+            default:
+                THROW_ERR("Unimplemented backend: RenderGraph Compile");
+                break;
+        }
+
+        //one single pass render program and render target per pass, attachments in the order of colorWrites then depth
+        for (usize i = 0; i < this->executionOrder.count; i++)
+        {
+            RenderGraphPass *pass = &this->passes.ptr[this->executionOrder.ptr[i]];
+            pass->writesBackbuffer = false;
+            pass->backbufferWrite = 0;
+            for (usize j = 0; j < pass->colorWrites.count; j++)
+            {
+                if (this->textures.ptr[pass->colorWrites.ptr[j]].type == RenderGraphResource_Backbuffer)
+                {
+                    pass->writesBackbuffer = true;
+                    pass->backbufferWrite = j;
+                }
+            }
+
+            pass->program = RenderProgram(this->allocator);
+            if (pass->writesBackbuffer)
+            {
+                if (pass->colorWrites.count > 1 || pass->depthWrite > -1)
+                {
+                    LOG_WARNING("Render graph passes that write to the backbuffer can only write to the backbuffer and the swapchain's depth buffer");
+                }
+                //must match the swapchain's render targets
+                i32 color = pass->program.AddAttachment(ImageFormat_BackbufferFormat, pass->colorClears.ptr[pass->backbufferWrite], false, RenderPassOutput_ToWindow);
+                i32 depth = pass->program.AddAttachment(ImageFormat_Depth32, false, pass->clearDepth, RenderPassOutput_ToNextPass);
+                pass->program.AddRenderPass(color, depth);
+                pass->program.Construct();
+                continue;
+            }
+
+            usize attachmentCount = pass->colorWrites.count + (pass->depthWrite > -1 ? 1 : 0);
+            collections::Array<i32> colorAttachments = collections::Array<i32>(this->allocator, pass->colorWrites.count);
+            collections::Array<Texture2D> targetTextures = collections::Array<Texture2D>(this->allocator, attachmentCount);
+            for (usize j = 0; j < pass->colorWrites.count; j++)
+            {
+                RenderGraphTexture *texture = &this->textures.ptr[pass->colorWrites.ptr[j]];
+                colorAttachments.data[j] = pass->program.AddAttachment(texture->imageFormat, pass->colorClears.ptr[j], false, RenderPassOutput_ToNextPass);
+                targetTextures.data[j] = *texture->texture;
+            }
+            i32 depthAttachment = -1;
+            if (pass->depthWrite > -1)
+            {
+                RenderGraphTexture *texture = &this->textures.ptr[pass->depthWrite];
+                depthAttachment = pass->program.AddAttachment(texture->imageFormat, false, pass->clearDepth, RenderPassOutput_ToNextPass);
+                targetTextures.data[attachmentCount - 1] = *texture->texture;
+            }
+            pass->program.AddRenderPass(colorAttachments, depthAttachment);
+            pass->program.Construct();
+
+            pass->target = RenderTarget(this->allocator, targetTextures.data[0].width, targetTextures.data[0].height, targetTextures);
+        }
+
+        this->compiled = true;
+        return true;
+    }
+
+    void RenderGraph::Execute(Graphics *graphics)
+    {
+        if (!this->compiled && !this->Compile())
+        {
+            return;
+        }
+        Maths::Rectangle windowViewport = graphics->Viewport;
+        Maths::Rectangle windowClipArea = graphics->ClipArea;
+
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
+                for (usize i = 0; i < this->executionOrder.count; i++)
+                {
+                    RenderGraphPass *pass = &this->passes.ptr[this->executionOrder.ptr[i]];
+
+                    AstralCanvasVkBarrierBatch barriers = AstralCanvasVkBarrierBatch(gpu, AstralCanvasVk_GetMainCmdBuffer());
+                    bool startsTransient = false;
+                    for (usize t = 0; t < this->textures.count; t++)
+                    {
+                        RenderGraphTexture *texture = &this->textures.ptr[t];
+                        if (texture->type == RenderGraphResource_Transient && texture->firstUse == (i32)i)
+                        {
+                            //previous contents are never needed, whether they were from the last frame or another texture
+                            texture->texture->imageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                            startsTransient = true;
+                        }
+                    }
+                    if (startsTransient)
+                    {
+                        //the previous user of the memory must be done with it before it is overwritten. That is either
+                        //another texture earlier in this frame, or the last pass using it in a previous frame that may still
+                        //be in flight. Both were submitted earlier on the same queue, so a barrier here covers them
+                        barriers.GlobalBarrier(
+                            VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                            VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+                    }
+                    for (usize j = 0; j < pass->reads.count; j++)
+                    {
+                        RenderGraphTexture *texture = &this->textures.ptr[pass->reads.ptr[j]];
+                        if (texture->texture == NULL)
+                        {
+                            continue;
+                        }
+                        VkImageAspectFlags aspectFlags = VK_IMAGE_ASPECT_COLOR_BIT;
+                        if (texture->imageFormat > ImageFormat_DepthNone)
+                        {
+                            aspectFlags = VK_IMAGE_ASPECT_DEPTH_BIT;
+                            if (texture->imageFormat == ImageFormat_Depth24Stencil8 || texture->imageFormat == ImageFormat_Depth16Stencil8)
+                            {
+                                aspectFlags |= VK_IMAGE_ASPECT_STENCIL_BIT;
+                            }
+                        }
+                        barriers.TransitionTexture(texture->texture, aspectFlags, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+                    }
+                    barriers.Flush();
+
+                    if (pass->writesBackbuffer)
+                    {
+                        graphics->SetRenderTarget(NULL);
+                        graphics->Viewport = windowViewport;
+                        graphics->ClipArea = windowClipArea;
+                    }
+                    else
+                    {
+                        //the render target holds copies of the textures, so carry the tracked layouts over
+                        for (usize j = 0; j < pass->colorWrites.count; j++)
+                        {
+                            pass->target.textures.data[j].imageLayout = this->textures.ptr[pass->colorWrites.ptr[j]].texture->imageLayout;
+                        }
+                        if (pass->depthWrite > -1)
+                        {
+                            pass->target.textures.data[pass->target.textures.length - 1].imageLayout = this->textures.ptr[pass->depthWrite].texture->imageLayout;
+                        }
+                        graphics->SetRenderTarget(&pass->target);
+                        graphics->Viewport = Maths::Rectangle(0, 0, pass->target.width, pass->target.height);
+                        graphics->ClipArea = graphics->Viewport;
+                    }
+
+                    if (pass->writesBackbuffer)
+                    {
+                        graphics->StartRenderProgram(&pass->program, pass->clearValues.ptr[pass->backbufferWrite]);
+                    }
+                    else
+                    {
+                        //attachments were added in the order of colorWrites, so the clear values line up with them
+                        graphics->StartRenderProgram(&pass->program, collections::Array<Color>(IAllocator{}, pass->clearValues.ptr, pass->clearValues.count));
+                    }
+                    if (pass->execute != NULL)
+                    {
+                        pass->execute(graphics, pass->userData);
+                    }
+                    graphics->EndRenderProgram();
+                    graphics->SetRenderTarget(NULL);
+
+                    if (!pass->writesBackbuffer)
+                    {
+                        for (usize j = 0; j < pass->colorWrites.count; j++)
+                        {
+                            this->textures.ptr[pass->colorWrites.ptr[j]].texture->imageLayout = pass->target.textures.data[j].imageLayout;
+                        }
+                        if (pass->depthWrite > -1)
+                        {
+                            this->textures.ptr[pass->depthWrite].texture->imageLayout = pass->target.textures.data[pass->target.textures.length - 1].imageLayout;
+                        }
+                    }
+                }
+
+                //leave outputs ready to be sampled by whatever comes after the graph
+                AstralCanvasVkBarrierBatch barriers = AstralCanvasVkBarrierBatch(gpu, AstralCanvasVk_GetMainCmdBuffer());
+                for (usize t = 0; t < this->textures.count; t++)
+                {
+                    RenderGraphTexture *texture = &this->textures.ptr[t];
+                    if (texture->type == RenderGraphResource_Imported && texture->isOutput && texture->firstUse > -1 && texture->imageFormat < ImageFormat_DepthNone)
+                    {
+                        barriers.TransitionTexture(texture->texture, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+                    }
+                }
+                barriers.Flush();
+                break;
+            }
+            #endif
+            default:
+                THROW_ERR("Unimplemented backend: RenderGraph Execute");
+                break;
+        }
+
+        graphics->Viewport = windowViewport;
+        graphics->ClipArea = windowClipArea;
+    }
+
+    void RenderGraph::ReleaseCompiled()
+    {
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                if (!this->compiled && this->executionOrder.count == 0)
+                {
+                    break;
+                }
+                //the previous frames may still be rendering with these, so everything goes through the destruction queue
+                for (usize i = 0; i < this->executionOrder.count; i++)
+                {
+                    RenderGraphPass *pass = &this->passes.ptr[this->executionOrder.ptr[i]];
+                    if (!pass->writesBackbuffer)
+                    {
+                        //the textures are owned by the graph or the user, so only the framebuffer belongs to the target
+                        if (pass->target.renderTargetHandle != NULL)
+                        {
+                            AstralCanvasVk_QueueDestroyFramebuffer((VkFramebuffer)pass->target.renderTargetHandle);
+                        }
+                        pass->target.textures.deinit();
+                    }
+                    pass->program.deinit();
+                    pass->program = RenderProgram();
+                }
+                for (usize t = 0; t < this->textures.count; t++)
+                {
+                    RenderGraphTexture *texture = &this->textures.ptr[t];
+                    if (texture->type == RenderGraphResource_Transient && texture->memoryBlock > -1)
+                    {
+                        VkImage image = (VkImage)texture->transientTexture.imageHandle;
+                        texture->transientTexture.deinit();
+                        AstralCanvasVk_QueueDestroyImage(image, GPUMemoryKind_Texture, NULL);
+                        texture->memoryBlock = -1;
+                    }
+                }
+                for (usize b = 0; b < this->memoryBlocks.count; b++)
+                {
+                    //queued after the images bound to it, so it is freed after them
+                    AstralCanvasVk_QueueFreeMemory(GPUMemoryKind_Texture, &this->memoryBlocks.ptr[b].memory);
+                }
+                break;
+            }
+            #endif
+            default:
+                break;
+        }
+        this->memoryBlocks.Clear();
+        this->executionOrder.Clear();
+        this->compiled = false;
+    }
+    void RenderGraph::deinit()
+    {
+        this->ReleaseCompiled();
+        for (usize i = 0; i < this->passes.count; i++)
+        {
+            this->passes.ptr[i].reads.deinit();
+            this->passes.ptr[i].colorWrites.deinit();
+            this->passes.ptr[i].colorClears.deinit();
+            this->passes.ptr[i].clearValues.deinit();
+        }
+        this->passes.deinit();
+        this->textures.deinit();
+        this->memoryBlocks.deinit();
+        this->executionOrder.deinit();
+    }
+}
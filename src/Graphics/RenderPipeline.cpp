@@ -2,10 +2,14 @@
 #include "Graphics/CurrentBackend.hpp"
 #include "ErrorHandling.hpp"
 #include "ArenaAllocator.hpp"
+#include "hash.hpp"
 
 #ifdef ASTRALCANVAS_VULKAN
 #include "Graphics/Vulkan/VulkanInstanceData.hpp"
 #include "Graphics/Vulkan/VulkanEnumConverters.hpp"
+#include "Graphics/Vulkan/VulkanHelpers.hpp"
+#include "Graphics/Vulkan/VulkanPipelineRegistry.hpp"
+#include "Graphics/Vulkan/VulkanBindless.hpp"
 #endif
 
 #ifdef ASTRALCANVAS_METAL
@@ -19,6 +23,82 @@
 
 namespace AstralCanvas
 {
+    RenderPipelineBindZone RenderPipelineGetBindZone(RenderProgram *renderProgram, u32 renderPassToUse)
+    {
+        RenderPipelineBindZone bindZone;
+        bindZone.renderProgramHandle = renderProgram->handle;
+        bindZone.subPassHandle = renderPassToUse;
+        bindZone.colorFormats = 0;
+        bindZone.depthFormat = 0;
+#ifdef ASTRALCANVAS_VULKAN
+        if (renderProgram->usesDynamicRendering)
+        {
+            //colorFormats packs one byte per attachment, which fits ASTRALVULKAN_MAX_COLOR_ATTACHMENTS of them
+            RenderPass *pass = &renderProgram->renderPasses.ptr[renderPassToUse];
+            for (usize i = 0; i < pass->colorAttachmentIndices.length && i < ASTRALVULKAN_MAX_COLOR_ATTACHMENTS; i++)
+            {
+                bindZone.colorFormats |= (u64)(u8)renderProgram->attachments.ptr[pass->colorAttachmentIndices.data[i]].imageFormat << (i * 8);
+            }
+            if (pass->depthAttachmentIndex > -1)
+            {
+                bindZone.depthFormat = (u32)renderProgram->attachments.ptr[pass->depthAttachmentIndex].imageFormat;
+            }
+        }
+#endif
+        return bindZone;
+    }
+
+#ifdef ASTRALCANVAS_VULKAN
+    inline void AstralCanvasVk_AppendPipelineState(collections::vector<u8> *state, void *data, usize size)
+    {
+        for (usize i = 0; i < size; i++)
+        {
+            state->Add(((u8 *)data)[i]);
+        }
+    }
+    /// Serializes everything that ends up in the VkGraphicsPipelineCreateInfo for this pipeline and bind zone
+    AstralCanvasVkPipelineStateKey AstralCanvasVk_GetPipelineStateKey(IAllocator allocator, RenderPipeline *pipeline, RenderPipelineBindZone bindZone)
+    {
+        collections::vector<u8> state = collections::vector<u8>(allocator);
+        AstralCanvasVk_AppendPipelineState(&state, &pipeline->shader->shaderModule1, sizeof(void *));
+        AstralCanvasVk_AppendPipelineState(&state, &pipeline->shader->shaderModule2, sizeof(void *));
+        AstralCanvasVk_AppendPipelineState(&state, &pipeline->layout, sizeof(void *));
+        AstralCanvasVk_AppendPipelineState(&state, &pipeline->cullMode, sizeof(CullMode));
+        AstralCanvasVk_AppendPipelineState(&state, &pipeline->primitiveType, sizeof(PrimitiveType));
+        AstralCanvasVk_AppendPipelineState(&state, &pipeline->blendState.sourceColorBlend, sizeof(Blend));
+        AstralCanvasVk_AppendPipelineState(&state, &pipeline->blendState.sourceAlphaBlend, sizeof(Blend));
+        AstralCanvasVk_AppendPipelineState(&state, &pipeline->blendState.destinationColorBlend, sizeof(Blend));
+        AstralCanvasVk_AppendPipelineState(&state, &pipeline->blendState.destinationAlphaBlend, sizeof(Blend));
+        AstralCanvasVk_AppendPipelineState(&state, &pipeline->depthTest, sizeof(bool));
+        AstralCanvasVk_AppendPipelineState(&state, &pipeline->depthWrite, sizeof(bool));
+        AstralCanvasVk_AppendPipelineState(&state, &bindZone.renderProgramHandle, sizeof(void *));
+        AstralCanvasVk_AppendPipelineState(&state, &bindZone.subPassHandle, sizeof(u32));
+        AstralCanvasVk_AppendPipelineState(&state, &bindZone.colorFormats, sizeof(u64));
+        AstralCanvasVk_AppendPipelineState(&state, &bindZone.depthFormat, sizeof(u32));
+
+        //vertex declarations are compared by contents, as each material tends to create its own
+        AstralCanvasVk_AppendPipelineState(&state, &pipeline->vertexDeclarations.length, sizeof(usize));
+        for (usize i = 0; i < pipeline->vertexDeclarations.length; i++)
+        {
+            VertexDeclaration *vertexDeclaration = pipeline->vertexDeclarations.data[i];
+            AstralCanvasVk_AppendPipelineState(&state, &vertexDeclaration->size, sizeof(usize));
+            AstralCanvasVk_AppendPipelineState(&state, &vertexDeclaration->inputRate, sizeof(VertexInputRate));
+            AstralCanvasVk_AppendPipelineState(&state, &vertexDeclaration->elements.count, sizeof(usize));
+            for (usize j = 0; j < vertexDeclaration->elements.count; j++)
+            {
+                AstralCanvasVk_AppendPipelineState(&state, &vertexDeclaration->elements.ptr[j].format, sizeof(VertexElementFormat));
+                AstralCanvasVk_AppendPipelineState(&state, &vertexDeclaration->elements.ptr[j].offset, sizeof(usize));
+            }
+        }
+
+        AstralCanvasVkPipelineStateKey key;
+        key.data = state.ptr;
+        key.size = state.count;
+        key.hash = GetHash(state.ptr, state.count);
+        return key;
+    }
+#endif
+
     RenderPipeline::RenderPipeline()
     {
         this->shader = NULL;
@@ -42,6 +122,7 @@ namespace AstralCanvas
         this->depthWrite = writeToDepth;
         this->vertexDeclarations = pipelineVertexDeclarations;
         this->zoneToPipelineInstance = collections::hashmap<RenderPipelineBindZone, void *>(allocator, &RenderPipelineBindZoneHash, &RenderPipelineBindZoneEql);
+        this->zoneMutex = threading::Mutex::init();
     }
     void *RenderPipeline::GetOrCreateFor(AstralCanvas::RenderProgram *renderProgram, u32 renderPassToUse)
     {
@@ -49,7 +130,7 @@ namespace AstralCanvas
         if (GetActiveBackend() == Backend_OpenGL)
         {
             // if can get then get
-            void *resultID = zoneToPipelineInstance.GetCopyOr(RenderPipelineBindZone{NULL, 0}, NULL);
+            void *resultID = zoneToPipelineInstance.GetCopyOr(RenderPipelineBindZone{NULL, 0, 0, 0}, NULL);
             if (resultID != NULL)
             {
                 return resultID;
@@ -81,18 +162,19 @@ namespace AstralCanvas
                 THROW_ERR("Failed to link OpenGL vertex fragment pipeline!");
             }
 
-            zoneToPipelineInstance.Add(RenderPipelineBindZone{ NULL, 0 }, (void*)programHandle);
+            zoneToPipelineInstance.Add(RenderPipelineBindZone{ NULL, 0, 0, 0 }, (void*)programHandle);
 
             return (void*)programHandle;
         }
         #endif
 
-        RenderPipelineBindZone bindZone;
-        bindZone.renderProgramHandle = renderProgram->handle;
-        bindZone.subPassHandle = renderPassToUse;
+        RenderPipelineBindZone bindZone = RenderPipelineGetBindZone(renderProgram, renderPassToUse);
+
+        this->zoneMutex.EnterLock();
         void *handle = this->zoneToPipelineInstance.GetCopyOr(bindZone, NULL);
         if (handle != NULL)
         {
+            this->zoneMutex.ExitLock();
             return handle;
         }
 
@@ -103,6 +185,22 @@ namespace AstralCanvas
             {
                 RenderPipeline *pipeline = this;
 
+                //pipeline layout itself, shared with every other pipeline using the same shader
+                if (pipeline->layout == NULL)
+                {
+                    ShaderVariables *variables = &pipeline->shader->shaderVariables;
+                    VkDescriptorSetLayout bindlessSetLayout = variables->usesBindlessHeap ? AstralCanvasVk_GetBindlessSetLayout() : NULL;
+                    pipeline->layout = AstralCanvasVk_AcquirePipelineLayout(AstralCanvasVk_GetCurrentGPU(), (VkDescriptorSetLayout)pipeline->shader->shaderPipelineLayout, variables->pushConstantsSize, AstralCanvasVk_FromAccessedBy(variables->pushConstantsAccessedBy), bindlessSetLayout);
+                    if (pipeline->layout == NULL)
+                    {
+                        this->zoneMutex.ExitLock();
+                        return NULL;
+                    }
+                }
+                //compile without holding the lock so that prewarm workers can build
+                //instances of the same pipeline for different passes in parallel
+                this->zoneMutex.ExitLock();
+
                 IAllocator cAllocator = GetCAllocator();
                 ArenaAllocator arena = ArenaAllocator(cAllocator);
                 const i32 dynamicStateCount = 2;
@@ -242,31 +340,19 @@ namespace AstralCanvas
                 colorBlendInfo.blendConstants[3] = 1.0f;
                 colorBlendInfo.logicOpEnable = false;
                 colorBlendInfo.logicOp = VK_LOGIC_OP_COPY;
-                colorBlendInfo.attachmentCount = 1;
-                colorBlendInfo.pAttachments = &colorBlendState;
-
-                //pipeline layout itself
-                if (pipeline->layout == NULL)
+                //every color attachment written by the pass needs its own blend state
+                VkPipelineColorBlendAttachmentState colorBlendStates[ASTRALVULKAN_MAX_COLOR_ATTACHMENTS];
+                u32 colorAttachmentCount = (u32)renderProgram->renderPasses.ptr[renderPassToUse].colorAttachmentIndices.length;
+                if (colorAttachmentCount > ASTRALVULKAN_MAX_COLOR_ATTACHMENTS)
                 {
-                    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
-                    pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-                    pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
-                    pipelineLayoutCreateInfo.pPushConstantRanges = NULL;
-                    pipelineLayoutCreateInfo.flags = 0;
-
-                    pipelineLayoutCreateInfo.setLayoutCount = 0;
-                    if (pipeline->shader->shaderPipelineLayout != NULL)
-                    {
-                        pipelineLayoutCreateInfo.setLayoutCount = 1;
-                        pipelineLayoutCreateInfo.pSetLayouts = (VkDescriptorSetLayout*)&pipeline->shader->shaderPipelineLayout;
-                    }
-
-                    if (vkCreatePipelineLayout(AstralCanvasVk_GetCurrentGPU()->logicalDevice, &pipelineLayoutCreateInfo, NULL, (VkPipelineLayout*)&pipeline->layout) != VK_SUCCESS)
-                    {
-                        arena.deinit();
-                        break;
-                    }
+                    colorAttachmentCount = ASTRALVULKAN_MAX_COLOR_ATTACHMENTS;
                 }
+                for (u32 i = 0; i < colorAttachmentCount; i++)
+                {
+                    colorBlendStates[i] = colorBlendState;
+                }
+                colorBlendInfo.attachmentCount = colorAttachmentCount;
+                colorBlendInfo.pAttachments = colorBlendStates;
 
                 //pipeline itself
 
@@ -297,12 +383,40 @@ namespace AstralCanvas
                 pipelineCreateInfo.renderPass = (VkRenderPass)renderProgram->handle;
                 pipelineCreateInfo.subpass = renderPassToUse;
 
-                VkPipeline result;
-                vkCreateGraphicsPipelines(AstralCanvasVk_GetCurrentGPU()->logicalDevice, NULL, 1, &pipelineCreateInfo, NULL, &result);
+                VkFormat colorFormats[ASTRALVULKAN_MAX_COLOR_ATTACHMENTS];
+                VkPipelineRenderingCreateInfo renderingCreateInfo{};
+                if (renderProgram->usesDynamicRendering)
+                {
+                    renderingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+                    renderingCreateInfo.colorAttachmentCount = AstralCanvasVk_GetPassAttachmentFormats(renderProgram, renderPassToUse, colorFormats, &renderingCreateInfo.depthAttachmentFormat, &renderingCreateInfo.stencilAttachmentFormat);
+                    renderingCreateInfo.pColorAttachmentFormats = colorFormats;
 
-                zoneToPipelineInstance.Add(bindZone, result);
+                    pipelineCreateInfo.pNext = &renderingCreateInfo;
+                    pipelineCreateInfo.renderPass = NULL;
+                    pipelineCreateInfo.subpass = 0;
+                }
 
+                //identical pipelines created by other RenderPipelines are shared instead of compiled again
+                AstralCanvasVkPipelineStateKey stateKey = AstralCanvasVk_GetPipelineStateKey(arena.AsAllocator(), pipeline, bindZone);
+                VkPipeline result = AstralCanvasVk_AcquirePipeline(AstralCanvasVk_GetCurrentGPU(), stateKey, &pipelineCreateInfo);
                 arena.deinit();
+                if (result == NULL)
+                {
+                    LOG_WARNING("Failed to create render pipeline");
+                    return NULL;
+                }
+
+                //another thread may have compiled the same instance while the lock was released, keep whichever got there first
+                this->zoneMutex.EnterLock();
+                void *existing = zoneToPipelineInstance.GetCopyOr(bindZone, NULL);
+                if (existing != NULL)
+                {
+                    this->zoneMutex.ExitLock();
+                    AstralCanvasVk_ReleasePipeline(AstralCanvasVk_GetCurrentGPU(), result);
+                    return existing;
+                }
+                zoneToPipelineInstance.Add(bindZone, result);
+                this->zoneMutex.ExitLock();
 
                 return result;
             }
@@ -313,6 +427,7 @@ namespace AstralCanvas
                 void *handle = AstralCanvasMetal_CreateRenderPipeline(this, renderProgram, renderPassToUse);
                 
                 zoneToPipelineInstance.Add(bindZone, handle);
+                this->zoneMutex.ExitLock();
                 
                 return handle;
             }
@@ -321,8 +436,24 @@ namespace AstralCanvas
                 THROW_ERR("Unimplemented backend: RenderPipeline GetOrCreateFor");
                 break;
         }
+        this->zoneMutex.ExitLock();
         return NULL;
     }
+    void *RenderPipeline::TryGetFor(AstralCanvas::RenderProgram *renderProgram, u32 renderPassToUse)
+    {
+        RenderPipelineBindZone bindZone = RenderPipelineGetBindZone(renderProgram, renderPassToUse);
+        #ifdef ASTRALCANVAS_OPENGL
+        if (GetActiveBackend() == Backend_OpenGL)
+        {
+            bindZone = RenderPipelineBindZone{ NULL, 0, 0, 0 };
+        }
+        #endif
+
+        this->zoneMutex.EnterLock();
+        void *handle = this->zoneToPipelineInstance.GetCopyOr(bindZone, NULL);
+        this->zoneMutex.ExitLock();
+        return handle;
+    }
     void RenderPipeline::deinit()
     {
         switch (GetActiveBackend())
@@ -337,12 +468,13 @@ namespace AstralCanvas
                         for (usize j = 0; j < this->zoneToPipelineInstance.buckets[i].entries.count; j++)
                         {
                             VkPipeline vkPipeline = (VkPipeline)this->zoneToPipelineInstance.buckets[i].entries.ptr[j].value;
-                            vkDestroyPipeline(AstralCanvasVk_GetCurrentGPU()->logicalDevice, vkPipeline, NULL);
+                            AstralCanvasVk_ReleasePipeline(AstralCanvasVk_GetCurrentGPU(), vkPipeline);
                         }
                     }
                 }
                 this->zoneToPipelineInstance.deinit();
-                vkDestroyPipelineLayout(AstralCanvasVk_GetCurrentGPU()->logicalDevice, (VkPipelineLayout)this->layout, NULL);
+                AstralCanvasVk_ReleasePipelineLayout(AstralCanvasVk_GetCurrentGPU(), (VkPipelineLayout)this->layout);
+                this->layout = NULL;
                 break;
             }
 #endif
@@ -379,5 +511,128 @@ namespace AstralCanvas
                 THROW_ERR("Unimplemented backend: RenderPipeline deinit");
                 break;
         }
+        this->zoneMutex.deinit();
+    }
+
+    THREAD_RESULT RenderPipelinePrewarmWorker(void *prewarmPtr)
+    {
+        RenderPipelinePrewarm *prewarm = (RenderPipelinePrewarm *)prewarmPtr;
+        while (prewarm->CompileNext())
+        {
+        }
+        prewarm->mutex.EnterLock();
+        prewarm->runningWorkers -= 1;
+        prewarm->mutex.ExitLock();
+        return 0;
+    }
+
+    RenderPipelinePrewarm::RenderPipelinePrewarm()
+    {
+        this->allocator = IAllocator();
+        this->entries = collections::Array<RenderPipelinePrewarmEntry>();
+        this->mutex = threading::Mutex();
+        this->nextEntry = 0;
+        this->completedEntries = 0;
+        this->runningWorkers = 0;
+        this->workers = collections::Array<threading::Thread>();
+    }
+    RenderPipelinePrewarm::RenderPipelinePrewarm(IAllocator allocator, RenderPipelinePrewarmEntry *entries, usize entryCount)
+    {
+        this->allocator = allocator;
+        this->entries = collections::Array<RenderPipelinePrewarmEntry>(allocator, entryCount);
+        for (usize i = 0; i < entryCount; i++)
+        {
+            this->entries.data[i] = entries[i];
+        }
+        this->mutex = threading::Mutex::init();
+        this->nextEntry = 0;
+        this->completedEntries = 0;
+        this->runningWorkers = 0;
+        this->workers = collections::Array<threading::Thread>();
+    }
+    void RenderPipelinePrewarm::Start(u32 threadCount)
+    {
+        //OpenGL programs can only be linked on the thread owning the context, so they are all compiled in Await
+        if (GetActiveBackend() != Backend_Vulkan)
+        {
+            return;
+        }
+        if (this->workers.data != NULL)
+        {
+            THROW_ERR("RenderPipelinePrewarm Start called twice");
+            return;
+        }
+        if (threadCount > this->entries.length)
+        {
+            threadCount = (u32)this->entries.length;
+        }
+        if (threadCount == 0)
+        {
+            return;
+        }
+        this->mutex.EnterLock();
+        this->runningWorkers += threadCount;
+        this->mutex.ExitLock();
+        this->workers = collections::Array<threading::Thread>(this->allocator, threadCount);
+        for (u32 i = 0; i < threadCount; i++)
+        {
+            this->workers.data[i] = threading::NewThread(&RenderPipelinePrewarmWorker, this);
+        }
+    }
+    bool RenderPipelinePrewarm::CompileNext()
+    {
+        this->mutex.EnterLock();
+        if (this->nextEntry >= this->entries.length)
+        {
+            this->mutex.ExitLock();
+            return false;
+        }
+        RenderPipelinePrewarmEntry entry = this->entries.data[this->nextEntry];
+        this->nextEntry += 1;
+        this->mutex.ExitLock();
+
+        entry.pipeline->GetOrCreateFor(entry.renderProgram, entry.renderPass);
+
+        this->mutex.EnterLock();
+        this->completedEntries += 1;
+        this->mutex.ExitLock();
+        return true;
+    }
+    float RenderPipelinePrewarm::GetProgress()
+    {
+        if (this->entries.length == 0)
+        {
+            return 1.0f;
+        }
+        this->mutex.EnterLock();
+        float progress = (float)this->completedEntries / (float)this->entries.length;
+        this->mutex.ExitLock();
+        return progress;
+    }
+    bool RenderPipelinePrewarm::IsComplete()
+    {
+        this->mutex.EnterLock();
+        bool complete = this->completedEntries >= this->entries.length && this->runningWorkers == 0;
+        this->mutex.ExitLock();
+        return complete;
+    }
+    void RenderPipelinePrewarm::Await()
+    {
+        //help out instead of idling, then wait for workers still finishing their last entry
+        while (this->CompileNext())
+        {
+        }
+        for (usize i = 0; i < this->workers.length; i++)
+        {
+            threading::JoinThread(this->workers.data[i]);
+        }
+        this->workers.deinit();
+        this->workers = collections::Array<threading::Thread>();
+    }
+    void RenderPipelinePrewarm::deinit()
+    {
+        this->Await();
+        this->mutex.deinit();
+        this->entries.deinit();
     }
-}
+}
\ No newline at end of file
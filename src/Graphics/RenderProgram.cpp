@@ -6,6 +6,7 @@
 
 #ifdef ASTRALCANVAS_VULKAN
 #include "Graphics/Vulkan/VulkanInstanceData.hpp"
+#include "Graphics/Vulkan/VulkanDestructionQueue.hpp"
 #endif
 
 #ifdef ASTRALCANVAS_METAL
@@ -28,12 +29,15 @@ namespace AstralCanvas
         this->renderPasses = collections::vector<RenderPass>();
         this->allocator = IAllocator{};
         this->handle = NULL;
+        this->usesDynamicRendering = false;
     }
     RenderProgram::RenderProgram(IAllocator allocator)
     {
         this->allocator = allocator;
         this->attachments = collections::vector<RenderProgramImageAttachment>(allocator);
         this->renderPasses = collections::vector<RenderPass>(allocator);
+        this->handle = NULL;
+        this->usesDynamicRendering = false;
     }
     i32 RenderProgram::AddAttachment(ImageFormat imageFormat, bool clearColor, bool clearDepth, RenderPassOutputType outputType)
     {
@@ -113,6 +117,14 @@ namespace AstralCanvas
                     return;
                 }
 
+                //single pass programs have no subpass dependencies or input attachments to describe,
+                //so they can skip the render pass object entirely
+                if (AstralCanvasVk_UseDynamicRendering() && program->renderPasses.count == 1 && program->renderPasses.ptr[0].readsAttachments.count == 0)
+                {
+                    program->usesDynamicRendering = true;
+                    return;
+                }
+
                 ArenaAllocator arena = ArenaAllocator(GetCAllocator());
                 VkSubpassDescription *subpassDescriptions = (VkSubpassDescription*)malloc(sizeof(VkSubpassDescription) * program->renderPasses.count);
                 
@@ -301,7 +313,10 @@ namespace AstralCanvas
                     this->renderPasses.ptr[i].readsAttachments.deinit();
                 }
                 this->renderPasses.deinit();
-                vkDestroyRenderPass(AstralCanvasVk_GetCurrentGPU()->logicalDevice, (VkRenderPass)this->handle, NULL);
+                if (this->handle != NULL)
+                {
+                    AstralCanvasVk_QueueDestroyRenderPass((VkRenderPass)this->handle);
+                }
                 
                 break;
             }
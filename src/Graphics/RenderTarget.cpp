@@ -4,6 +4,7 @@
 
 #ifdef ASTRALCANVAS_VULKAN
 #include "Graphics/Vulkan/VulkanInstanceData.hpp"
+#include "Graphics/Vulkan/VulkanDestructionQueue.hpp"
 #endif
 
 #ifdef ASTRALCANVAS_OPENGL
@@ -14,7 +15,7 @@ namespace AstralCanvas
 {
     void RenderTarget::deinit()
     {
-        if (this->isDisposed || !this->constructed || this->textures.data == NULL)
+        if (this->isDisposed || this->textures.data == NULL)
         {
             return;
         }
@@ -25,7 +26,7 @@ namespace AstralCanvas
             {
                 if (this->renderTargetHandle != NULL)
                 {
-                    vkDestroyFramebuffer(AstralCanvasVk_GetCurrentGPU()->logicalDevice, (VkFramebuffer)this->renderTargetHandle, NULL);
+                    AstralCanvasVk_QueueDestroyFramebuffer((VkFramebuffer)this->renderTargetHandle);
                 }
                 break;
             }
@@ -66,6 +67,12 @@ namespace AstralCanvas
             #ifdef ASTRALCANVAS_VULKAN
             case Backend_Vulkan:
             {
+                //dynamic rendering binds the textures' views directly. Not marked as constructed,
+                //as the target may still need a framebuffer for other programs
+                if (renderProgram->usesDynamicRendering)
+                {
+                    return;
+                }
                 VkFramebufferCreateInfo createInfo{};
                 createInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
                 createInfo.width = this->width;
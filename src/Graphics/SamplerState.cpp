@@ -4,6 +4,8 @@
 #ifdef ASTRALCANVAS_VULKAN
 #include "Graphics/Vulkan/VulkanEnumConverters.hpp"
 #include "Graphics/Vulkan/VulkanHelpers.hpp"
+#include "Graphics/Vulkan/VulkanBindless.hpp"
+#include "Graphics/Vulkan/VulkanDestructionQueue.hpp"
 #endif
 
 #ifdef ASTRALCANVAS_METAL
@@ -30,6 +32,7 @@ namespace AstralCanvas
         this->repeatMode = RepeatMode_Repeat;
         this->anisotropic = false;
         this->anisotropyLevel = 0.0f;
+        this->bindlessIndex = 0;
     }
     SamplerState::SamplerState(SampleMode thisSampleMode, RepeatMode thisRepeatMode, bool isAnisotropic, float thisAnisotropyLevel)
     {
@@ -38,6 +41,7 @@ namespace AstralCanvas
         this->anisotropic = isAnisotropic;
         this->anisotropyLevel = thisAnisotropyLevel;
         this->handle = NULL;
+        this->bindlessIndex = 0;
 
         this->Construct();
     }
@@ -78,6 +82,7 @@ namespace AstralCanvas
                     THROW_ERR("Failed to create sampler");
                 }
                 this->handle = sampler;
+                this->bindlessIndex = AstralCanvasVk_BindlessAddSampler(gpu, sampler);
                 break;
             }
             #endif
@@ -116,7 +121,9 @@ namespace AstralCanvas
             #ifdef ASTRALCANVAS_VULKAN
             case Backend_Vulkan:
             {
-                vkDestroySampler(AstralCanvasVk_GetCurrentGPU()->logicalDevice, (VkSampler)this->handle, NULL);
+                AstralCanvasVk_BindlessRemoveSampler(this->bindlessIndex);
+                this->bindlessIndex = 0;
+                AstralCanvasVk_QueueDestroySampler((VkSampler)this->handle);
                 break;
             }
             #endif
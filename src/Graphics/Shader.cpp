@@ -3,11 +3,16 @@
 #include "ArenaAllocator.hpp"
 #include "ErrorHandling.hpp"
 #include "Json.hpp"
+#include "hash.hpp"
 #include "cmath"
+#include <string.h>
 
 #ifdef ASTRALCANVAS_VULKAN
 #include "Graphics/Vulkan/VulkanInstanceData.hpp"
 #include "Graphics/Vulkan/VulkanEnumConverters.hpp"
+#include "Graphics/Vulkan/VulkanDescriptors.hpp"
+#include "Graphics/Vulkan/VulkanUniformArena.hpp"
+#include "Graphics/Vulkan/VulkanDestructionQueue.hpp"
 #endif
 
 #ifdef MACOS
@@ -22,6 +27,17 @@ using namespace Json;
 
 namespace AstralCanvas
 {
+#ifdef ASTRALCANVAS_VULKAN
+    /// Keys are made of whole words so that the cache can find a destroyed handle in them
+    inline void AstralCanvasVk_AppendDescriptorSetKey(collections::vector<u8> *key, u64 word)
+    {
+        for (usize i = 0; i < sizeof(u64); i++)
+        {
+            key->Add(((u8 *)&word)[i]);
+        }
+    }
+#endif
+
     Shader::Shader()
     {
         this->allocator = IAllocator{};
@@ -30,10 +46,11 @@ namespace AstralCanvas
         shaderModule2 = NULL;
         shaderPipelineLayout = NULL;
         shaderVariables = ShaderVariables();
-        uniformsHasBeenSet = false;
 
-        this->descriptorForThisDrawCall = 0;
-        this->descriptorSets = collections::vector<void *>();
+        this->descriptorSlotCount = 0;
+        this->descriptorSlotsClaimed = 0;
+        this->stagingMutex = threading::Mutex();
+        this->drawState = ShaderDrawState();
         this->usedMaterials = collections::Array<ShaderMaterialExport>();
     }
     Shader::Shader(IAllocator allocator, ShaderType type)
@@ -44,12 +61,35 @@ namespace AstralCanvas
         shaderModule2 = NULL;
         shaderPipelineLayout = NULL;
         shaderVariables = ShaderVariables(allocator);
-        uniformsHasBeenSet = false;
 
-        this->descriptorForThisDrawCall = 0;
-        this->descriptorSets = collections::vector<void *>(allocator);
+        this->descriptorSlotCount = 0;
+        this->descriptorSlotsClaimed = 0;
+        this->stagingMutex = threading::Mutex::init();
+        this->drawState = ShaderDrawState(allocator, NULL);
         this->usedMaterials = collections::Array<ShaderMaterialExport>();
     }
+    ShaderDrawState::ShaderDrawState()
+    {
+        this->shader = NULL;
+        this->uniformsHasBeenSet = false;
+        this->descriptorSlot = 0;
+        this->descriptorSet = NULL;
+        this->dynamicOffsetCount = 0;
+        this->descriptorSetKey = collections::vector<u8>();
+    }
+    ShaderDrawState::ShaderDrawState(IAllocator allocator, Shader *shader)
+    {
+        this->shader = shader;
+        this->uniformsHasBeenSet = false;
+        this->descriptorSlot = 0;
+        this->descriptorSet = NULL;
+        this->dynamicOffsetCount = 0;
+        this->descriptorSetKey = collections::vector<u8>(allocator);
+    }
+    void ShaderDrawState::deinit()
+    {
+        this->descriptorSetKey.deinit();
+    }
     void ParseShaderVariables(JsonElement *json, ShaderVariables *results, ShaderInputAccessedBy accessedByShaderOfType)
     {
         JsonElement *uniforms = json->GetProperty("uniforms");
@@ -84,6 +124,19 @@ namespace AstralCanvas
                 //results->uniforms.Add(binding, {name, set, binding, stride});
             }
         }
+        JsonElement *pushConstants = json->GetProperty("pushConstants");
+        if (pushConstants != NULL)
+        {
+            for (usize i = 0; i < pushConstants->arrayElements.length; i++)
+            {
+                u32 size = pushConstants->arrayElements.data[i].GetProperty("size")->GetUint32();
+                if (size > results->pushConstantsSize)
+                {
+                    results->pushConstantsSize = size;
+                }
+                results->pushConstantsAccessedBy = (ShaderInputAccessedBy)((u32)results->pushConstantsAccessedBy | (u32)accessedByShaderOfType);
+            }
+        }
         JsonElement *textures = json->GetProperty("images");
         if (textures != NULL)
         {
@@ -95,6 +148,14 @@ namespace AstralCanvas
                 u32 binding = textures->arrayElements.data[i].GetProperty("binding")->GetUint32();
                 u32 mslBinding = textures->arrayElements.data[i].GetProperty("mslBinding")->GetUint32();
 
+                if (set == ASTRALCANVAS_BINDLESS_SET)
+                {
+                    //not part of the shader's own descriptor set
+                    results->usesBindlessHeap = true;
+                    name.deinit();
+                    continue;
+                }
+
                 ShaderResource *resource = results->uniforms.Get(binding);
                 if (resource != NULL && resource->variableName.buffer != NULL)
                 {
@@ -128,6 +189,14 @@ namespace AstralCanvas
                 u32 binding = samplers->arrayElements.data[i].GetProperty("binding")->GetUint32();
                 u32 mslBinding = samplers->arrayElements.data[i].GetProperty("mslBinding")->GetUint32();
 
+                if (set == ASTRALCANVAS_BINDLESS_SET)
+                {
+                    //not part of the shader's own descriptor set
+                    results->usesBindlessHeap = true;
+                    name.deinit();
+                    continue;
+                }
+
                 ShaderResource *resource = results->uniforms.Get(binding);
                 if (resource != NULL && resource->variableName.buffer != NULL)
                 {
@@ -232,28 +301,18 @@ namespace AstralCanvas
         }
         return -1;
     }
-    void Shader::CheckDescriptorSetAvailability(bool forceAddNewDescriptor)
+    void Shader::CheckDescriptorSetAvailability(usize slot)
     {
-        if (descriptorForThisDrawCall >= descriptorSets.count || forceAddNewDescriptor)
+        while (slot >= descriptorSlotCount)
         {
             switch (GetActiveBackend())
             {
     #ifdef ASTRALCANVAS_VULKAN
                 case Backend_Vulkan:
                 {
-                    VkDescriptorPool descriptorPool = AstralCanvasVk_GetDescriptorPool();
-                    VkDescriptorSet result;
-                    VkDescriptorSetAllocateInfo allocInfo{};
-                    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-                    allocInfo.descriptorSetCount = 1;
-                    allocInfo.descriptorPool = descriptorPool;
-                    allocInfo.pSetLayouts = (VkDescriptorSetLayout*)&this->shaderPipelineLayout;
-                    
-                    if (vkAllocateDescriptorSets(AstralCanvasVk_GetCurrentGPU()->logicalDevice, &allocInfo, &result) != VK_SUCCESS)
-                    {
-                        THROW_ERR("Error creating descriptor set!");
-                    }
-                    descriptorSets.Add(result);
+                    //only the staging state is kept per slot, the descriptor set itself is allocated
+                    //from the frame's pool each time the slot is synced
+                    descriptorSlotCount += 1;
                     for (usize i = 0; i < shaderVariables.uniforms.capacity; i++)
                     {
                         ShaderResource *resource = &shaderVariables.uniforms.ptr[i];
@@ -271,8 +330,10 @@ namespace AstralCanvas
                             }
                             case ShaderResourceType_Uniform:
                             {
-                                newMutableState.ub = UniformBuffer(resource->size);
-                                newMutableState.ownsUniformBuffer = true;
+                                //no buffer of its own, the data is sub-allocated from the frame's uniform arena when synced
+                                newMutableState.ownsUniformBuffer = false;
+                                newMutableState.uniformData = this->allocator.Allocate(resource->size);
+                                memset(newMutableState.uniformData, 0, resource->size);
                                 break;
                             }
                             case ShaderResourceType_InputAttachment:
@@ -309,7 +370,7 @@ namespace AstralCanvas
     #ifdef ASTRALCANVAS_OPENGL
                 case Backend_OpenGL:
                 {
-                    descriptorSets.Add(NULL);
+                    descriptorSlotCount += 1;
                     for (usize i = 0; i < shaderVariables.uniforms.capacity; i++)
                     {
                         ShaderResource* resource = &shaderVariables.uniforms.ptr[i];
@@ -356,12 +417,24 @@ namespace AstralCanvas
                 }
     #endif
                 default:
-                    break;
+                    return;
             }
         }
     }
-    void Shader::SyncUniformsWithGPU(void *commandEncoder)
+    void Shader::ResetDescriptorSlots()
     {
+        this->stagingMutex.EnterLock();
+        this->descriptorSlotsClaimed = 0;
+        this->drawState.uniformsHasBeenSet = false;
+        this->stagingMutex.ExitLock();
+    }
+    void Shader::SyncUniformsWithGPU(void *commandEncoder, ShaderDrawState *drawState)
+    {
+        if (drawState == NULL)
+        {
+            drawState = &this->drawState;
+        }
+        this->stagingMutex.EnterLock();
         switch (GetActiveBackend())
         {
             #ifdef ASTRALCANVAS_VULKAN
@@ -376,6 +449,14 @@ namespace AstralCanvas
                 {
                     THROW_ERR("Cannot sync shader without uniforms with GPU");
                 }
+                AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
+                u64 frameNumber = AstralCanvasVk_GetFrameNumber();
+
+                //the key is every handle that ends up in the set, so that draws binding the same resources as an
+                //earlier draw, this frame or a previous one, can reuse its set instead of writing a new one
+                VkDescriptorSetLayout setLayout = (VkDescriptorSetLayout)this->shaderPipelineLayout;
+                drawState->descriptorSetKey.Clear();
+                AstralCanvasVk_AppendDescriptorSetKey(&drawState->descriptorSetKey, (u64)setLayout);
                 for (usize i = 0; i < this->shaderVariables.uniforms.capacity; i++)
                 {
                     if (this->shaderVariables.uniforms.ptr[i].variableName.buffer == NULL)
@@ -383,18 +464,18 @@ namespace AstralCanvas
                         break;
                     }
                     //should never throw out of range error since CheckDescriptorSetAvailability() is always called prior to this
-                    ShaderStagingMutableState *toMutate = &this->shaderVariables.uniforms.ptr[i].stagingData.ptr[this->descriptorForThisDrawCall];
-                    if (!toMutate->mutated)
+                    ShaderStagingMutableState *toMutate = &this->shaderVariables.uniforms.ptr[i].stagingData.ptr[drawState->descriptorSlot];
+                    if (!toMutate->hasBeenSet)
                     {
                         continue;
                     }
-                    //set mutated to false in anticipation of reuse for next frame
+                    bool mutated = toMutate->mutated;
                     toMutate->mutated = false;
 
                     VkWriteDescriptorSet setWrite{};
                     setWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    setWrite.dstSet = (VkDescriptorSet)this->descriptorSets.ptr[descriptorForThisDrawCall];
                     setWrite.dstBinding = this->shaderVariables.uniforms.ptr[i].binding;
+                    AstralCanvasVk_AppendDescriptorSetKey(&drawState->descriptorSetKey, (u64)setWrite.dstBinding);
 
                     switch (this->shaderVariables.uniforms.ptr[i].type)
                     {
@@ -405,6 +486,7 @@ namespace AstralCanvas
                             imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL; //(VkImageLayout)toMutate->textures.data[i]->imageLayout;
                             imageInfo.imageView = (VkImageView)toMutate->textures.data[0]->imageView;
                             ((VkDescriptorImageInfo*)toMutate->imageInfos)[0] = imageInfo;
+                            AstralCanvasVk_AppendDescriptorSetKey(&drawState->descriptorSetKey, (u64)imageInfo.imageView);
 
                             setWrite.dstArrayElement = 0;
                             setWrite.descriptorCount = toMutate->textures.length;
@@ -414,14 +496,24 @@ namespace AstralCanvas
                         }
                         case ShaderResourceType_Uniform:
                         {
-                            UniformBuffer buffer = toMutate->ub;
-                            bufferInfos[bufferInfoCount].buffer = (VkBuffer)buffer.handle;
+                            usize size = this->shaderVariables.uniforms.ptr[i].size;
+                            if (mutated || toMutate->arenaBuffer == NULL || toMutate->arenaFrameNumber != frameNumber)
+                            {
+                                AstralCanvasVkUniformAllocation allocation = AstralCanvasVk_AllocateFrameUniform(gpu, size);
+                                memcpy(allocation.mappedData, toMutate->uniformData, size);
+                                toMutate->arenaBuffer = allocation.buffer;
+                                toMutate->arenaOffset = allocation.offset;
+                                toMutate->arenaFrameNumber = frameNumber;
+                            }
+                            bufferInfos[bufferInfoCount].buffer = (VkBuffer)toMutate->arenaBuffer;
                             bufferInfos[bufferInfoCount].offset = 0;
-                            bufferInfos[bufferInfoCount].range = buffer.size;
+                            bufferInfos[bufferInfoCount].range = size;
+                            //the offset is dynamic, so uniforms in the same arena block share a set
+                            AstralCanvasVk_AppendDescriptorSetKey(&drawState->descriptorSetKey, (u64)bufferInfos[bufferInfoCount].buffer);
 
                             setWrite.dstArrayElement = 0;
                             setWrite.descriptorCount = 1;
-                            setWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                            setWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
                             setWrite.pBufferInfo = &bufferInfos[bufferInfoCount];
 
                             bufferInfoCount += 1;
@@ -437,6 +529,7 @@ namespace AstralCanvas
                                 imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL; //(VkImageLayout)toMutate->textures.data[i]->imageLayout;
                                 imageInfo.imageView = (VkImageView)toMutate->textures.data[i]->imageView;
                                 ((VkDescriptorImageInfo*)toMutate->imageInfos)[i] = imageInfo;
+                                AstralCanvasVk_AppendDescriptorSetKey(&drawState->descriptorSetKey, (u64)imageInfo.imageView);
                             }
 
                             setWrite.dstArrayElement = 0;
@@ -455,6 +548,7 @@ namespace AstralCanvas
                                 samplerInfo.imageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
                                 samplerInfo.imageView = NULL;
                                 ((VkDescriptorImageInfo*)toMutate->samplerInfos)[i] = samplerInfo;
+                                AstralCanvasVk_AppendDescriptorSetKey(&drawState->descriptorSetKey, (u64)samplerInfo.sampler);
                             }
 
                             setWrite.dstArrayElement = 0;
@@ -470,6 +564,8 @@ namespace AstralCanvas
                             bufferInfos[bufferInfoCount].buffer = (VkBuffer)buffer->handle;
                             bufferInfos[bufferInfoCount].offset = 0;
                             bufferInfos[bufferInfoCount].range = buffer->elementSize * buffer->elementCount;
+                            AstralCanvasVk_AppendDescriptorSetKey(&drawState->descriptorSetKey, (u64)bufferInfos[bufferInfoCount].buffer);
+                            AstralCanvasVk_AppendDescriptorSetKey(&drawState->descriptorSetKey, (u64)bufferInfos[bufferInfoCount].range);
 
                             setWrite.dstArrayElement = 0;
                             setWrite.descriptorCount = 1;
@@ -489,7 +585,44 @@ namespace AstralCanvas
                     setWriteCount += 1;
                 }
 
-                vkUpdateDescriptorSets(AstralCanvasVk_GetCurrentGPU()->logicalDevice, setWriteCount, setWrites, 0, NULL);
+                AstralCanvasVkDescriptorSetKey key;
+                key.data = drawState->descriptorSetKey.ptr;
+                key.size = drawState->descriptorSetKey.count;
+                key.hash = GetHash(key.data, key.size);
+
+                VkDescriptorSet descriptorSet = AstralCanvasVk_GetCachedDescriptorSet(key);
+                if (descriptorSet == NULL)
+                {
+                    //a cached set is never rewritten since frames in flight may have it bound, so a new one is written in full
+                    VkDescriptorPool pool;
+                    descriptorSet = AstralCanvasVk_AllocateDescriptorSet(gpu, setLayout, &pool);
+                    for (u32 i = 0; i < setWriteCount; i++)
+                    {
+                        setWrites[i].dstSet = descriptorSet;
+                    }
+                    vkUpdateDescriptorSets(gpu->logicalDevice, setWriteCount, setWrites, 0, NULL);
+                    AstralCanvasVk_CacheDescriptorSet(setLayout, key, descriptorSet, pool);
+                }
+                drawState->descriptorSet = descriptorSet;
+
+                //dynamic offsets are consumed in binding order rather than the order uniforms were declared in
+                drawState->dynamicOffsetCount = 0;
+                for (u32 binding = 0; binding < MAX_UNIFORMS_IN_SHADER; binding++)
+                {
+                    for (usize i = 0; i < this->shaderVariables.uniforms.capacity; i++)
+                    {
+                        ShaderResource *resource = &this->shaderVariables.uniforms.ptr[i];
+                        if (resource->variableName.buffer == NULL)
+                        {
+                            break;
+                        }
+                        if (resource->type == ShaderResourceType_Uniform && resource->binding == binding)
+                        {
+                            drawState->dynamicOffsets[drawState->dynamicOffsetCount] = resource->stagingData.ptr[drawState->descriptorSlot].arenaOffset;
+                            drawState->dynamicOffsetCount += 1;
+                        }
+                    }
+                }
 
                 break;
             }
@@ -497,7 +630,7 @@ namespace AstralCanvas
 #ifdef ASTRALCANVAS_METAL
             case Backend_Metal:
             {
-                AstralCanvasMetal_SyncUniformsWithGPU(commandEncoder, this);
+                AstralCanvasMetal_SyncUniformsWithGPU(commandEncoder, this, drawState->descriptorSlot);
                 
                 break;
             }
@@ -512,7 +645,7 @@ namespace AstralCanvas
                         break;
                     }
 
-                    ShaderStagingMutableState* toMutate = &this->shaderVariables.uniforms.ptr[i].stagingData.ptr[this->descriptorForThisDrawCall];
+                    ShaderStagingMutableState* toMutate = &this->shaderVariables.uniforms.ptr[i].stagingData.ptr[drawState->descriptorSlot];
                     if (!toMutate->mutated)
                     {
                         continue;
@@ -613,14 +746,17 @@ namespace AstralCanvas
                 THROW_ERR("Unimplemented backend: Shader SyncUniformsWithGPU");
                 break;
         }
+        this->stagingMutex.ExitLock();
     }
-    void Shader::SetShaderVariableComputeBuffer(const char* variableName, ComputeBuffer* buffer)
+    ShaderVariableHandle Shader::GetVariableHandle(const char* variableName)
     {
-        CheckDescriptorSetAvailability();
-        ShaderVariables *variables = &shaderVariables;
-        for (usize i = 0; i < variables->uniforms.capacity; i++)
+        ShaderVariableHandle result;
+        result.binding = -1;
+        result.type = ShaderResourceType_Uniform;
+        for (usize i = 0; i < shaderVariables.uniforms.capacity; i++)
         {
-            if (variables->uniforms.ptr[i].variableName.buffer == NULL)
+            ShaderResource *resource = &shaderVariables.uniforms.ptr[i];
+            if (resource->variableName.buffer == NULL)
             {
                 if (GetActiveBackend() == Backend_Vulkan)
                 {
@@ -628,144 +764,164 @@ namespace AstralCanvas
                 }
                 continue;
             }
-            
-            if (variables->uniforms.ptr[i].variableName == variableName)
+            if (resource->variableName == variableName)
             {
-                uniformsHasBeenSet = true;
-                variables->uniforms.ptr[i].stagingData.ptr[descriptorForThisDrawCall].mutated = true;
-                variables->uniforms.ptr[i].stagingData.ptr[descriptorForThisDrawCall].computeBuffer = buffer;
+                result.binding = (i32)resource->binding;
+                result.type = resource->type;
+                break;
             }
         }
+        return result;
     }
-    void Shader::SetShaderVariable(const char* variableName, void* ptr, usize size)
+    /// Uniforms are stored at their binding, so a handle finds its variable without comparing any names
+    inline ShaderResource *GetVariableFromHandle(ShaderVariables *variables, ShaderVariableHandle handle)
+    {
+        if (handle.binding < 0)
+        {
+            return NULL;
+        }
+        ShaderResource *resource = variables->uniforms.Get((usize)handle.binding);
+        if (resource == NULL || resource->variableName.buffer == NULL || resource->type != handle.type)
+        {
+            return NULL;
+        }
+        return resource;
+    }
+    /// Returns the staging state the variable is written to for drawState's next draw, claiming a slot for it first if the
+    /// last one has already been synced. Must be called with stagingMutex held
+    inline ShaderStagingMutableState *StageVariable(Shader *shader, ShaderDrawState *drawState, ShaderVariableHandle handle)
     {
-        CheckDescriptorSetAvailability();
-        ShaderVariables *variables = &shaderVariables;
-        for (usize i = 0; i < variables->uniforms.capacity; i++)
+        ShaderResource *resource = GetVariableFromHandle(&shader->shaderVariables, handle);
+        if (resource == NULL)
         {
-            if (variables->uniforms.ptr[i].variableName.buffer == NULL)
+            return NULL;
+        }
+        if (drawState == NULL)
+        {
+            drawState = &shader->drawState;
+        }
+        if (!drawState->uniformsHasBeenSet)
+        {
+            drawState->descriptorSlot = shader->descriptorSlotsClaimed;
+            shader->descriptorSlotsClaimed += 1;
+            shader->CheckDescriptorSetAvailability(drawState->descriptorSlot);
+            drawState->uniformsHasBeenSet = true;
+        }
+        ShaderStagingMutableState *mutableState = &resource->stagingData.ptr[drawState->descriptorSlot];
+        mutableState->mutated = true;
+        mutableState->hasBeenSet = true;
+        return mutableState;
+    }
+    void Shader::SetShaderVariableComputeBuffer(ShaderVariableHandle handle, ComputeBuffer* buffer, ShaderDrawState *drawState)
+    {
+        stagingMutex.EnterLock();
+        ShaderStagingMutableState *mutableState = StageVariable(this, drawState, handle);
+        if (mutableState != NULL)
+        {
+            mutableState->computeBuffer = buffer;
+        }
+        stagingMutex.ExitLock();
+    }
+    void Shader::SetShaderVariable(ShaderVariableHandle handle, void* ptr, usize size, ShaderDrawState *drawState)
+    {
+        stagingMutex.EnterLock();
+        ShaderStagingMutableState *mutableState = StageVariable(this, drawState, handle);
+        if (mutableState != NULL)
+        {
+            if (mutableState->uniformData != NULL)
             {
-                if (GetActiveBackend() == Backend_Vulkan)
-                {
-                    break; //can only break in vulkan as metal has non-continguous uniform indices
-                }
-                continue;
+                //uploaded to the uniform arena on the next sync
+                usize uniformSize = shaderVariables.uniforms.ptr[handle.binding].size;
+                memcpy(mutableState->uniformData, ptr, size < uniformSize ? size : uniformSize);
             }
-            
-            if (variables->uniforms.ptr[i].variableName == variableName)
+            else
             {
-                uniformsHasBeenSet = true;
-                variables->uniforms.ptr[i].stagingData.ptr[descriptorForThisDrawCall].mutated = true;
-                variables->uniforms.ptr[i].stagingData.ptr[descriptorForThisDrawCall].ub.SetData(ptr, size);
+                mutableState->ub.SetData(ptr, size);
             }
         }
+        stagingMutex.ExitLock();
     }
-    void Shader::SetShaderVariableTextures(const char* variableName, Texture2D **textures, usize count)
+    void Shader::SetShaderVariableTextures(ShaderVariableHandle handle, Texture2D **textures, usize count, ShaderDrawState *drawState)
     {
 #ifdef ASTRALCANVAS_OPENGL
         THROW_ERR("Bindless texturing not supported in OpenGL!");
 #endif
-        CheckDescriptorSetAvailability();
-        ShaderVariables *variables = &shaderVariables;
-        for (usize i = 0; i < variables->uniforms.capacity; i++)
+        stagingMutex.EnterLock();
+        ShaderStagingMutableState *mutableState = StageVariable(this, drawState, handle);
+        if (mutableState != NULL)
         {
-            if (variables->uniforms.ptr[i].variableName.buffer == NULL)
+            for (usize j = 0; j < count; j++)
             {
-                if (GetActiveBackend() == Backend_Vulkan)
-                {
-                    break; //can only break in vulkan as metal has non-continguous uniform indices
-                }
-                continue;
-            }
-            if (variables->uniforms.ptr[i].variableName == variableName)
-            {
-                uniformsHasBeenSet = true;
-                ShaderStagingMutableState *mutableState = &variables->uniforms.ptr[i].stagingData.ptr[descriptorForThisDrawCall];
-                mutableState->mutated = true;
-                for (usize j = 0; j < count; j++)
-                {
-                    variables->uniforms.ptr[i].stagingData.ptr[descriptorForThisDrawCall].textures.data[j] = textures[j];
-                }
-                break;
+                mutableState->textures.data[j] = textures[j];
             }
         }
+        stagingMutex.ExitLock();
     }
-    void Shader::SetShaderVariableTexture(const char* variableName, Texture2D *texture)
+    void Shader::SetShaderVariableTexture(ShaderVariableHandle handle, Texture2D *texture, ShaderDrawState *drawState)
     {
-        CheckDescriptorSetAvailability();
-        ShaderVariables *variables = &shaderVariables;
-        for (usize i = 0; i < variables->uniforms.capacity; i++)
+        stagingMutex.EnterLock();
+        ShaderStagingMutableState *mutableState = StageVariable(this, drawState, handle);
+        if (mutableState != NULL)
         {
-            if (variables->uniforms.ptr[i].variableName.buffer == NULL)
-            {
-                if (GetActiveBackend() == Backend_Vulkan)
-                {
-                    break; //can only break in vulkan as metal has non-continguous uniform indices
-                }
-                continue;
-            }
-            if (variables->uniforms.ptr[i].variableName == variableName)
-            {
-                uniformsHasBeenSet = true;
-                variables->uniforms.ptr[i].stagingData.ptr[descriptorForThisDrawCall].mutated = true;
-                variables->uniforms.ptr[i].stagingData.ptr[descriptorForThisDrawCall].textures.data[0] = texture;
-                return;
-            }
+            mutableState->textures.data[0] = texture;
         }
-        fprintf(stderr, "Variable of name %s not found\n", variableName);
+        stagingMutex.ExitLock();
     }
-    void Shader::SetShaderVariableSamplers(const char* variableName, SamplerState **samplers, usize count)
+    void Shader::SetShaderVariableSamplers(ShaderVariableHandle handle, SamplerState **samplers, usize count, ShaderDrawState *drawState)
     {
 #ifdef ASTRALCANVAS_OPENGL
         THROW_ERR("Bindless texturing not supported in OpenGL!");
 #endif
-        CheckDescriptorSetAvailability();
-        ShaderVariables *variables = &shaderVariables;
-        for (usize i = 0; i < variables->uniforms.capacity; i++)
+        stagingMutex.EnterLock();
+        ShaderStagingMutableState *mutableState = StageVariable(this, drawState, handle);
+        if (mutableState != NULL)
         {
-            if (variables->uniforms.ptr[i].variableName.buffer == NULL)
-            {
-                if (GetActiveBackend() == Backend_Vulkan)
-                {
-                    break; //can only break in vulkan as metal has non-continguous uniform indices
-                }
-                continue;
-            }
-            if (variables->uniforms.ptr[i].variableName == variableName)
+            for (usize j = 0; j < count; j++)
             {
-                uniformsHasBeenSet = true;
-                ShaderStagingMutableState *mutableState = &variables->uniforms.ptr[i].stagingData.ptr[descriptorForThisDrawCall];
-                mutableState->mutated = true;
-                for (usize j = 0; j < count; j++)
-                {
-                    variables->uniforms.ptr[i].stagingData.ptr[descriptorForThisDrawCall].samplers.data[j] = samplers[j];
-                }
-                break;
+                mutableState->samplers.data[j] = samplers[j];
             }
         }
+        stagingMutex.ExitLock();
     }
-    void Shader::SetShaderVariableSampler(const char* variableName, SamplerState *sampler)
+    void Shader::SetShaderVariableSampler(ShaderVariableHandle handle, SamplerState *sampler, ShaderDrawState *drawState)
     {
-        CheckDescriptorSetAvailability();
-        ShaderVariables *variables = &shaderVariables;
-        for (usize i = 0; i < variables->uniforms.capacity; i++)
+        stagingMutex.EnterLock();
+        ShaderStagingMutableState *mutableState = StageVariable(this, drawState, handle);
+        if (mutableState != NULL)
         {
-            if (variables->uniforms.ptr[i].variableName.buffer == NULL)
-            {
-                if (GetActiveBackend() == Backend_Vulkan)
-                {
-                    break; //can only break in vulkan as metal has non-continguous uniform indices
-                }
-                continue;
-            }
-            if (variables->uniforms.ptr[i].variableName == variableName)
-            {
-                uniformsHasBeenSet = true;
-                variables->uniforms.ptr[i].stagingData.ptr[descriptorForThisDrawCall].mutated = true;
-                variables->uniforms.ptr[i].stagingData.ptr[descriptorForThisDrawCall].samplers.data[0] = sampler;
-                break;
-            }
+            mutableState->samplers.data[0] = sampler;
         }
+        stagingMutex.ExitLock();
+    }
+    void Shader::SetShaderVariableComputeBuffer(const char* variableName, ComputeBuffer* buffer)
+    {
+        SetShaderVariableComputeBuffer(GetVariableHandle(variableName), buffer);
+    }
+    void Shader::SetShaderVariable(const char* variableName, void* ptr, usize size)
+    {
+        SetShaderVariable(GetVariableHandle(variableName), ptr, size);
+    }
+    void Shader::SetShaderVariableTextures(const char* variableName, Texture2D **textures, usize count)
+    {
+        SetShaderVariableTextures(GetVariableHandle(variableName), textures, count);
+    }
+    void Shader::SetShaderVariableTexture(const char* variableName, Texture2D *texture)
+    {
+        ShaderVariableHandle handle = GetVariableHandle(variableName);
+        if (handle.binding < 0)
+        {
+            fprintf(stderr, "Variable of name %s not found\n", variableName);
+            return;
+        }
+        SetShaderVariableTexture(handle, texture);
+    }
+    void Shader::SetShaderVariableSamplers(const char* variableName, SamplerState **samplers, usize count)
+    {
+        SetShaderVariableSamplers(GetVariableHandle(variableName), samplers, count);
+    }
+    void Shader::SetShaderVariableSampler(const char* variableName, SamplerState *sampler)
+    {
+        SetShaderVariableSampler(GetVariableHandle(variableName), sampler);
     }
     void Shader::deinit()
     {
@@ -778,8 +934,11 @@ namespace AstralCanvas
 
                 if (this->shaderPipelineLayout != NULL)
                 {
-                    vkDestroyDescriptorSetLayout(logicalDevice, (VkDescriptorSetLayout)this->shaderPipelineLayout, NULL);
+                    AstralCanvasVk_EvictCachedDescriptorSets((VkDescriptorSetLayout)this->shaderPipelineLayout);
+                    //descriptor sets of frames still in flight were allocated with it
+                    AstralCanvasVk_QueueDestroyDescriptorSetLayout((VkDescriptorSetLayout)this->shaderPipelineLayout);
                 }
+                //modules are only read while pipelines are being created, so nothing in flight can reference them
                 if (this->shaderModule1 != NULL)
                 {
                     vkDestroyShaderModule(logicalDevice, (VkShaderModule)this->shaderModule1, NULL);
@@ -814,6 +973,8 @@ namespace AstralCanvas
         }
 
         this->shaderVariables.deinit();
+        this->drawState.deinit();
+        this->stagingMutex.deinit();
         if (this->usedMaterials.data != NULL)
         {
             for (usize i = 0; i < this->usedMaterials.length; i++)
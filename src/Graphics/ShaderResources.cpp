@@ -7,11 +7,17 @@ namespace AstralCanvas
     {
         this->uniforms = collections::denseset<ShaderResource>();
         this->allocator = IAllocator{};
+        this->pushConstantsSize = 0;
+        this->pushConstantsAccessedBy = InputAccessedBy_None;
+        this->usesBindlessHeap = false;
     }
     ShaderVariables::ShaderVariables(IAllocator allocator)
     {
         this->allocator = allocator;
         this->uniforms = collections::denseset<ShaderResource>(allocator, 16);
+        this->pushConstantsSize = 0;
+        this->pushConstantsAccessedBy = InputAccessedBy_None;
+        this->usesBindlessHeap = false;
     }
     void ShaderVariables::deinit()
     {
@@ -28,6 +34,10 @@ namespace AstralCanvas
                         {
                             this->uniforms.ptr[i].stagingData.ptr[j].ub.deinit();
                         }
+                        if (this->uniforms.ptr[i].stagingData.ptr[j].uniformData != NULL)
+                        {
+                            this->allocator.Free(this->uniforms.ptr[i].stagingData.ptr[j].uniformData);
+                        }
                     }
                     else if (this->uniforms.ptr[i].type == ShaderResourceType_Sampler)
                     {
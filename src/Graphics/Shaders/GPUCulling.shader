@@ -0,0 +1,78 @@
+#compute
+#version 450
+
+layout (binding = 0) uniform CullingData {
+    vec4 planes[6];
+    uint instanceCount;
+    uint maxDraws;
+} cullingData;
+
+struct CullingInstance {
+    vec4 boundingSphere;
+    uint drawRecord;
+    uint padding0;
+    uint padding1;
+    uint padding2;
+};
+
+struct DrawRecord {
+    uint indexCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint padding;
+};
+
+struct DrawIndexedIndirectCommand {
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
+
+layout(std430, binding = 1) readonly buffer Instances {
+    CullingInstance instances[ ];
+};
+
+layout(std430, binding = 2) readonly buffer DrawRecords {
+    DrawRecord drawRecords[ ];
+};
+
+layout(std430, binding = 3) writeonly buffer DrawCommands {
+    DrawIndexedIndirectCommand drawCommands[ ];
+};
+
+layout(std430, binding = 4) buffer DrawCount {
+    uint drawCount;
+};
+
+layout (local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+void main() 
+{
+    uint index = gl_GlobalInvocationID.x;
+    if (index >= cullingData.instanceCount)
+    {
+        return;
+    }
+
+    vec4 sphere = instances[index].boundingSphere;
+    for (int i = 0; i < 6; i++)
+    {
+        if (dot(cullingData.planes[i].xyz, sphere.xyz) + cullingData.planes[i].w < -sphere.w)
+        {
+            return;
+        }
+    }
+
+    uint slot = atomicAdd(drawCount, 1);
+    if (slot >= cullingData.maxDraws)
+    {
+        return;
+    }
+    DrawRecord record = drawRecords[instances[index].drawRecord];
+    drawCommands[slot].indexCount = record.indexCount;
+    drawCommands[slot].instanceCount = 1;
+    drawCommands[slot].firstIndex = record.firstIndex;
+    drawCommands[slot].vertexOffset = record.vertexOffset;
+    drawCommands[slot].firstInstance = index;
+}
@@ -0,0 +1,52 @@
+#vertex
+#version 450
+
+layout(location = 0) in vec2 corner;
+
+layout(location = 1) in vec4 destination;
+layout(location = 2) in vec4 source;
+layout(location = 3) in vec4 color;
+layout(location = 4) in vec4 originRotationDepth;
+layout(location = 5) in uint textureIndex;
+layout(location = 6) in uint samplerIndex;
+
+layout(binding = 0) uniform Matrices
+{
+    mat4 transform;
+} matrices;
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) flat out uint fragTextureIndex;
+layout(location = 3) flat out uint fragSamplerIndex;
+
+void main() {
+    vec2 local = corner * destination.zw - originRotationDepth.xy;
+    float s = sin(originRotationDepth.z);
+    float c = cos(originRotationDepth.z);
+    vec2 position = destination.xy + vec2(local.x * c - local.y * s, local.x * s + local.y * c);
+    gl_Position = matrices.transform * vec4(position, originRotationDepth.w, 1.0);
+
+    fragColor = color;
+    fragTexCoord = mix(source.xy, source.zw, corner);
+    fragTextureIndex = textureIndex;
+    fragSamplerIndex = samplerIndex;
+}
+
+#fragment
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(set = 1, binding = 0) uniform texture2D textures[];
+layout(set = 1, binding = 1) uniform sampler samplers[];
+
+layout(location = 0) in vec4 fragColor;
+layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) flat in uint fragTextureIndex;
+layout(location = 3) flat in uint fragSamplerIndex;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    outColor = texture(sampler2D(textures[nonuniformEXT(fragTextureIndex)], samplers[nonuniformEXT(fragSamplerIndex)]), fragTexCoord) * fragColor;
+}
@@ -0,0 +1,297 @@
+#include "Graphics/SpriteBatch.hpp"
+#include "Graphics/CurrentBackend.hpp"
+#include "ErrorHandling.hpp"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanInstanceData.hpp"
+#endif
+
+namespace AstralCanvas
+{
+    /// Matches Matrices in the shader
+    struct SpriteBatchMatrices
+    {
+        Maths::Matrix4x4 transform;
+    };
+
+    SpriteBatch::SpriteBatch()
+    {
+        this->allocator = IAllocator{};
+        this->shader = NULL;
+        this->pipeline = RenderPipeline();
+        this->matricesHandle = {-1, ShaderResourceType_Uniform};
+        this->quadDecl = NULL;
+        this->instanceDecl = NULL;
+        this->quadVertices = VertexBuffer();
+        this->quadIndices = IndexBuffer();
+        this->instanceStream = VertexBuffer();
+        this->streamCapacity = 0;
+        this->streamHead = 0;
+        this->sprites = collections::vector<SpriteBatchInstance>();
+        this->sortedSprites = collections::vector<SpriteBatchInstance>();
+        this->sortKeys = collections::vector<u64>();
+        this->begun = false;
+        this->sortMode = SpriteSortMode_Deferred;
+        this->transform = Maths::Matrix4x4::Identity();
+        this->samplerIndex = 0;
+    }
+    /// Sprites read their textures from the bindless heap, which only exists on GPUs with descriptor indexing
+    inline bool SpriteBatchSupported()
+    {
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+                return AstralCanvasVk_GetCurrentGPU()->supportsBindless;
+            #endif
+            default:
+                return false;
+        }
+    }
+    SpriteBatch::SpriteBatch(IAllocator allocator, Shader *spriteShader, BlendState blendState, usize initialCapacity)
+    {
+        if (!SpriteBatchSupported())
+        {
+            THROW_ERR("SpriteBatch requires bindless texture support, which the current GPU or backend does not provide");
+            //leaves the batch empty, so deinit is still safe to call
+            *this = SpriteBatch();
+            return;
+        }
+        this->allocator = allocator;
+        this->shader = spriteShader;
+        this->matricesHandle = spriteShader->GetVariableHandle("Matrices");
+
+        this->quadDecl = (VertexDeclaration *)allocator.Allocate(sizeof(VertexDeclaration));
+        *this->quadDecl = VertexDeclaration(allocator, sizeof(Maths::Vec2), VertexInput_PerVertex);
+        this->quadDecl->elements.Add({VertexElement_Vector2, 0});
+
+        this->instanceDecl = (VertexDeclaration *)allocator.Allocate(sizeof(VertexDeclaration));
+        *this->instanceDecl = VertexDeclaration(allocator, sizeof(SpriteBatchInstance), VertexInput_PerInstance);
+        this->instanceDecl->elements.Add({VertexElement_Vector4, 0});
+        this->instanceDecl->elements.Add({VertexElement_Vector4, 16});
+        this->instanceDecl->elements.Add({VertexElement_Vector4, 32});
+        this->instanceDecl->elements.Add({VertexElement_Vector4, 48});
+        this->instanceDecl->elements.Add({VertexElement_Uint, 64});
+        this->instanceDecl->elements.Add({VertexElement_Uint, 68});
+
+        collections::Array<VertexDeclaration*> vertexDecls = collections::Array<VertexDeclaration*>(allocator, 2);
+        vertexDecls.data[0] = this->quadDecl;
+        vertexDecls.data[1] = this->instanceDecl;
+        this->pipeline = RenderPipeline(allocator, spriteShader, CullMode_CullNone, PrimitiveType_TriangleList, blendState, false, false, vertexDecls);
+
+        Maths::Vec2 corners[4] = {Maths::Vec2(0.0f, 0.0f), Maths::Vec2(1.0f, 0.0f), Maths::Vec2(1.0f, 1.0f), Maths::Vec2(0.0f, 1.0f)};
+        this->quadVertices = VertexBuffer(this->quadDecl, 4);
+        this->quadVertices.SetData(corners, 4);
+
+        u16 indices[6] = {0, 1, 2, 3, 0, 2};
+        this->quadIndices = IndexBuffer(IndexBufferSize_U16, 6);
+        this->quadIndices.SetData((u8 *)indices, sizeof(u16) * 6);
+
+        this->streamCapacity = initialCapacity > 0 ? initialCapacity : 1;
+        this->instanceStream = VertexBuffer(this->instanceDecl, this->streamCapacity, true);
+        this->streamHead = 0;
+
+        this->sprites = collections::vector<SpriteBatchInstance>(allocator);
+        this->sortedSprites = collections::vector<SpriteBatchInstance>(allocator);
+        this->sortKeys = collections::vector<u64>(allocator);
+
+        this->begun = false;
+        this->sortMode = SpriteSortMode_Deferred;
+        this->transform = Maths::Matrix4x4::Identity();
+        this->samplerIndex = 0;
+    }
+
+    void SpriteBatch::Begin(SpriteSortMode sortMode, Maths::Matrix4x4 transform, SamplerState *sampler)
+    {
+        if (this->begun)
+        {
+            THROW_ERR("SpriteBatch Begin called twice without End");
+            return;
+        }
+        this->begun = true;
+        this->sortMode = sortMode;
+        this->transform = transform;
+        this->samplerIndex = sampler != NULL ? sampler->bindlessIndex : 0;
+        this->sprites.Clear();
+    }
+    void SpriteBatch::Draw(Texture2D *texture, Maths::Vec2 position, Color color)
+    {
+        this->Draw(texture, position, NULL, color, 0.0f, Maths::Vec2(0.0f, 0.0f), Maths::Vec2(1.0f, 1.0f), 0.0f);
+    }
+    void SpriteBatch::Draw(Texture2D *texture, Maths::Vec2 position, Maths::Rectangle *sourceRectangle, Color color, float rotation, Maths::Vec2 origin, Maths::Vec2 scale, float depth)
+    {
+        if (!this->begun)
+        {
+            THROW_ERR("SpriteBatch Draw called before Begin");
+            return;
+        }
+        Maths::Rectangle source = sourceRectangle != NULL ? *sourceRectangle : Maths::Rectangle(0, 0, (i32)texture->width, (i32)texture->height);
+        float inverseWidth = texture->width > 0 ? 1.0f / (float)texture->width : 0.0f;
+        float inverseHeight = texture->height > 0 ? 1.0f / (float)texture->height : 0.0f;
+        Maths::Vec4 colorVector = color.ToVector4();
+
+        SpriteBatchInstance instance;
+        instance.destination[0] = position.X;
+        instance.destination[1] = position.Y;
+        instance.destination[2] = (float)source.Width * scale.X;
+        instance.destination[3] = (float)source.Height * scale.Y;
+        instance.source[0] = (float)source.X * inverseWidth;
+        instance.source[1] = (float)source.Y * inverseHeight;
+        instance.source[2] = (float)(source.X + source.Width) * inverseWidth;
+        instance.source[3] = (float)(source.Y + source.Height) * inverseHeight;
+        instance.color[0] = colorVector.X;
+        instance.color[1] = colorVector.Y;
+        instance.color[2] = colorVector.Z;
+        instance.color[3] = colorVector.W;
+        instance.originRotationDepth[0] = origin.X * scale.X;
+        instance.originRotationDepth[1] = origin.Y * scale.Y;
+        instance.originRotationDepth[2] = rotation;
+        instance.originRotationDepth[3] = depth;
+        instance.textureIndex = texture->bindlessIndex;
+        instance.samplerIndex = this->samplerIndex;
+        instance.padding[0] = 0;
+        instance.padding[1] = 0;
+        this->sprites.Add(instance);
+    }
+
+    /// Maps a float's bits to an unsigned integer that sorts in the same order as the float
+    inline u32 SpriteBatchOrderedDepth(float depth)
+    {
+        u32 bits;
+        memcpy(&bits, &depth, sizeof(u32));
+        return (bits & 0x80000000) != 0 ? ~bits : bits | 0x80000000;
+    }
+    int SpriteBatchCompareKeys(const void *A, const void *B)
+    {
+        u64 a = *(const u64 *)A;
+        u64 b = *(const u64 *)B;
+        return a < b ? -1 : (a > b ? 1 : 0);
+    }
+
+    void SpriteBatch::End(Graphics *graphics)
+    {
+        if (!this->begun)
+        {
+            THROW_ERR("SpriteBatch End called before Begin");
+            return;
+        }
+        this->begun = false;
+        usize count = this->sprites.count;
+        if (count == 0)
+        {
+            return;
+        }
+
+        SpriteBatchInstance *instances = this->sprites.ptr;
+        if (this->sortMode != SpriteSortMode_Deferred)
+        {
+            //the submission index in the low bits keeps the sort stable and tells us where each key came from
+            this->sortKeys.Clear();
+            this->sortKeys.EnsureArrayCapacity(count);
+            for (usize i = 0; i < count; i++)
+            {
+                u32 high;
+                switch (this->sortMode)
+                {
+                    case SpriteSortMode_Texture:
+                        high = this->sprites.ptr[i].textureIndex;
+                        break;
+                    case SpriteSortMode_BackToFront:
+                        high = ~SpriteBatchOrderedDepth(this->sprites.ptr[i].originRotationDepth[3]);
+                        break;
+                    default:
+                        high = SpriteBatchOrderedDepth(this->sprites.ptr[i].originRotationDepth[3]);
+                        break;
+                }
+                this->sortKeys.Add(((u64)high << 32) | (u64)i);
+            }
+            qsort(this->sortKeys.ptr, count, sizeof(u64), &SpriteBatchCompareKeys);
+
+            this->sortedSprites.Clear();
+            this->sortedSprites.EnsureArrayCapacity(count);
+            for (usize i = 0; i < count; i++)
+            {
+                this->sortedSprites.Add(this->sprites.ptr[(u32)this->sortKeys.ptr[i]]);
+            }
+            instances = this->sortedSprites.ptr;
+        }
+
+        //the stream moves on to a fresh region on the first write of every frame, so start filling it from the top again
+        if (this->instanceStream.regions.WillMoveToNextRegion())
+        {
+            this->streamHead = 0;
+        }
+
+        if (this->streamHead + count > this->streamCapacity)
+        {
+            //with a single region the old storage is orphaned when written from the start, so wrapping around is safe
+            if (this->instanceStream.regions.regionCount == 1 && count <= this->streamCapacity)
+            {
+                this->streamHead = 0;
+            }
+            else
+            {
+                usize newCapacity = this->streamCapacity * 2;
+                while (newCapacity < count)
+                {
+                    newCapacity *= 2;
+                }
+                //earlier draws this frame may still read the old stream, its destruction waits for them to retire
+                this->instanceStream.deinit();
+                this->streamCapacity = newCapacity;
+                this->instanceStream = VertexBuffer(this->instanceDecl, newCapacity, true);
+                this->streamHead = 0;
+            }
+        }
+
+        usize firstInstance = this->streamHead;
+        this->instanceStream.SetData(instances, count, firstInstance);
+        this->streamHead += count;
+
+        SpriteBatchMatrices matrices;
+        matrices.transform = this->transform;
+
+        graphics->UseRenderPipeline(&this->pipeline);
+        graphics->SetVertexBuffer(&this->quadVertices, 0);
+        graphics->SetVertexBuffer(&this->instanceStream, 1);
+        graphics->SetIndexBuffer(&this->quadIndices);
+        graphics->SetShaderVariable(this->matricesHandle, &matrices, sizeof(SpriteBatchMatrices));
+        graphics->DrawIndexedPrimitives(6, (u32)count, 0, 0, (u32)firstInstance);
+    }
+    void SpriteBatch::deinit()
+    {
+        if (this->instanceStream.handle != NULL)
+        {
+            this->instanceStream.deinit();
+        }
+        if (this->quadVertices.handle != NULL)
+        {
+            this->quadVertices.deinit();
+        }
+        if (this->quadIndices.handle != NULL)
+        {
+            this->quadIndices.deinit();
+        }
+        if (this->shader != NULL)
+        {
+            this->pipeline.deinit();
+            this->pipeline.vertexDeclarations.deinit();
+        }
+        if (this->quadDecl != NULL)
+        {
+            this->quadDecl->deinit();
+            this->allocator.Free(this->quadDecl);
+        }
+        if (this->instanceDecl != NULL)
+        {
+            this->instanceDecl->deinit();
+            this->allocator.Free(this->instanceDecl);
+        }
+        this->sprites.deinit();
+        this->sortedSprites.deinit();
+        this->sortKeys.deinit();
+    }
+}
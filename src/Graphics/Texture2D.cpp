@@ -7,6 +7,9 @@
 #ifdef ASTRALCANVAS_VULKAN
 #include "Graphics/Vulkan/VulkanEnumConverters.hpp"
 #include "Graphics/Vulkan/VulkanHelpers.hpp"
+#include "Graphics/Vulkan/VulkanStaging.hpp"
+#include "Graphics/Vulkan/VulkanBindless.hpp"
+#include "Graphics/Vulkan/VulkanDestructionQueue.hpp"
 #endif
 
 #ifdef ASTRALCANVAS_METAL
@@ -125,27 +128,15 @@ namespace AstralCanvas
                 if ((this->width * this->height > 0) && this->ownsHandle)
                 {
                     //VmaAllocation
-                    this->allocatedMemory = AstralCanvasVk_AllocateMemoryForImage(image, VMA_MEMORY_USAGE_GPU_ONLY, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+                    this->allocatedMemory = AstralCanvasVk_AllocateMemoryForImage(image, AstralCanvas::GPUMemoryKind_Texture, VMA_MEMORY_USAGE_GPU_ONLY, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
                     //for non-rendertarget textures
                     if (this->bytes != NULL && !this->usedForRenderTarget)
                     {
                         transitionToAttachmentOptimal = false;
-                        VkBuffer stagingBuffer = AstralCanvasVk_CreateResourceBuffer(gpu, this->width * this->height * 4, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
-
-                        AstralCanvas::MemoryAllocation stagingMemory = AstralCanvasVk_AllocateMemoryForBuffer(stagingBuffer, VMA_MEMORY_USAGE_CPU_TO_GPU, (VkMemoryPropertyFlagBits)(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT), true);
-
-                        memcpy(stagingMemory.vkAllocationInfo.pMappedData, this->bytes, (usize)(this->width * this->height * 4));
-
-                        AstralCanvasVk_TransitionImageLayout(gpu, NULL, (VkImage)this->imageHandle, this->mipLevels, imageAspect, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-
-                        AstralCanvasVk_CopyBufferToImage(gpu, stagingBuffer, (VkImage)this->imageHandle, this->width, this->height);
-
-                        AstralCanvasVk_TransitionImageLayout(gpu, NULL, (VkImage)this->imageHandle, this->mipLevels, imageAspect, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-                        vkDestroyBuffer(gpu->logicalDevice, stagingBuffer, NULL);
-
-                        vmaFreeMemory(AstralCanvasVk_GetCurrentVulkanAllocator(), stagingMemory.vkAllocation);
+                        usize lengthOfBytes = (usize)(this->width * this->height * 4);
+                        //records the transitions around the copy as well
+                        AstralCanvasVk_StageImageUpload(gpu, this->bytes, lengthOfBytes, (VkImage)this->imageHandle, this->mipLevels, imageAspect, this->width, this->height);
 
                         this->imageLayout = (u64)VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
                     }
@@ -187,6 +178,13 @@ namespace AstralCanvas
                     THROW_ERR("Failed to create image view");
                 }
 
+                //depth images are never created with sampled usage, and swapchain aliases come and go with resizes
+                this->bindlessIndex = 0;
+                if (this->imageFormat < ImageFormat_DepthNone && this->ownsHandle)
+                {
+                    this->bindlessIndex = AstralCanvasVk_BindlessAddTexture(gpu, (VkImageView)this->imageView);
+                }
+
                 break;
             }
             #endif
@@ -247,7 +245,7 @@ namespace AstralCanvas
 
                 VkBuffer stagingBuffer = AstralCanvasVk_CreateResourceBuffer(gpu, this->width * this->height * 4, VK_BUFFER_USAGE_TRANSFER_DST_BIT);
 
-                AstralCanvas::MemoryAllocation stagingMemory = AstralCanvasVk_AllocateMemoryForBuffer(stagingBuffer, VMA_MEMORY_USAGE_GPU_TO_CPU, (VkMemoryPropertyFlagBits)(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT), true);
+                AstralCanvas::MemoryAllocation stagingMemory = AstralCanvasVk_AllocateMemoryForBuffer(stagingBuffer, AstralCanvas::GPUMemoryKind_Staging, VMA_MEMORY_USAGE_GPU_TO_CPU, (VkMemoryPropertyFlagBits)(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT), true);
 
                 AstralCanvasVk_TransitionImageLayout(gpu, NULL, (VkImage)this->imageHandle, this->mipLevels, imageAspect, (VkImageLayout)this->imageLayout, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
 
@@ -259,7 +257,7 @@ namespace AstralCanvas
 
                 vkDestroyBuffer(gpu->logicalDevice, stagingBuffer, NULL);
 
-                vmaFreeMemory(AstralCanvasVk_GetCurrentVulkanAllocator(), stagingMemory.vkAllocation);
+                AstralCanvasVk_FreeMemory(AstralCanvas::GPUMemoryKind_Staging, &stagingMemory);
 
 
                 return bytes;
@@ -314,13 +312,12 @@ namespace AstralCanvas
             #ifdef ASTRALCANVAS_VULKAN
             case Backend_Vulkan:
             {
-                AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
-
-                vkDestroyImageView(gpu->logicalDevice, (VkImageView)this->imageView, NULL);
+                AstralCanvasVk_BindlessRemoveTexture(this->bindlessIndex);
+                this->bindlessIndex = 0;
+                AstralCanvasVk_QueueDestroyImageView((VkImageView)this->imageView);
                 if (this->ownsHandle)
                 {
-                    vmaFreeMemory(AstralCanvasVk_GetCurrentVulkanAllocator(), this->allocatedMemory.vkAllocation);
-                    vkDestroyImage(gpu->logicalDevice, (VkImage)this->imageHandle, NULL);
+                    AstralCanvasVk_QueueDestroyImage((VkImage)this->imageHandle, AstralCanvas::GPUMemoryKind_Texture, &this->allocatedMemory);
                 }
                 
                 break;
@@ -4,6 +4,7 @@
 #ifdef ASTRALCANVAS_VULKAN
 #include "Graphics/Vulkan/VulkanInstanceData.hpp"
 #include "Graphics/Vulkan/VulkanHelpers.hpp"
+#include "Graphics/Vulkan/VulkanDestructionQueue.hpp"
 #endif
 
 #ifdef ASTRALCANVAS_METAL
@@ -39,7 +40,7 @@ namespace AstralCanvas
             {
                 VkBufferUsageFlags bufferUsage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
                 this->handle = AstralCanvasVk_CreateResourceBuffer(AstralCanvasVk_GetCurrentGPU(), this->size, bufferUsage);
-                this->memoryAllocation = AstralCanvasVk_AllocateMemoryForBuffer((VkBuffer)this->handle, VMA_MEMORY_USAGE_CPU_TO_GPU, (VkMemoryPropertyFlagBits)(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+                this->memoryAllocation = AstralCanvasVk_AllocateMemoryForBuffer((VkBuffer)this->handle, AstralCanvas::GPUMemoryKind_Uniform, VMA_MEMORY_USAGE_CPU_TO_GPU, (VkMemoryPropertyFlagBits)(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
                 break;
             }
             #endif
@@ -96,11 +97,7 @@ namespace AstralCanvas
             case Backend_Vulkan:
             {
                 if (handle != NULL)
-                    vkDestroyBuffer(AstralCanvasVk_GetCurrentGPU()->logicalDevice, (VkBuffer)this->handle, NULL);
-                if (this->memoryAllocation.vkAllocation != NULL)
-                {
-                    vmaFreeMemory(AstralCanvasVk_GetCurrentVulkanAllocator(), this->memoryAllocation.vkAllocation);
-                }
+                    AstralCanvasVk_QueueDestroyBuffer((VkBuffer)this->handle, AstralCanvas::GPUMemoryKind_Uniform, &this->memoryAllocation);
                 break;
             }
             #endif
@@ -1,9 +1,12 @@
 #include "Graphics/VertexBuffer.hpp"
 #include "Graphics/CurrentBackend.hpp"
+#include "ErrorHandling.hpp"
 
 #ifdef ASTRALCANVAS_VULKAN
 #include "Graphics/Vulkan/VulkanHelpers.hpp"
+#include "Graphics/Vulkan/VulkanStaging.hpp"
 #include "Graphics/Vulkan/vk_mem_alloc.h"
+#include "Graphics/Vulkan/VulkanDestructionQueue.hpp"
 #endif
 
 #ifdef ASTRALCANVAS_METAL
@@ -23,6 +26,7 @@ namespace AstralCanvas
         this->vertexCount = 0;
         this->vertexType = NULL;
         this->isDynamic = false;
+        this->regions = DynamicBufferRegions();
     }
     VertexBuffer::VertexBuffer(VertexDeclaration *thisVertexType, usize vertexCount, bool isDynamic, bool canRead)
     {
@@ -32,6 +36,7 @@ namespace AstralCanvas
         this->handle = NULL;
         this->memoryAllocation.unused = 0;
         this->isDynamic = isDynamic;
+        this->regions = DynamicBufferRegions();
 
         this->Construct();
     }
@@ -47,14 +52,20 @@ namespace AstralCanvas
                 {
                     bufferUsage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
                 }
-                this->handle = AstralCanvasVk_CreateResourceBuffer(AstralCanvasVk_GetCurrentGPU(), this->vertexCount * this->vertexType->size, bufferUsage);
+                usize bufferSize = this->vertexCount * this->vertexType->size;
                 if (this->isDynamic)
                 {
-                    this->memoryAllocation = AstralCanvasVk_AllocateMemoryForBuffer((VkBuffer)this->handle, VMA_MEMORY_USAGE_CPU_TO_GPU, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+                    this->regions = DynamicBufferRegions(bufferSize);
+                    bufferSize = this->regions.GetTotalSize();
+                }
+                this->handle = AstralCanvasVk_CreateResourceBuffer(AstralCanvasVk_GetCurrentGPU(), bufferSize, bufferUsage);
+                if (this->isDynamic)
+                {
+                    this->memoryAllocation = AstralCanvasVk_AllocateMemoryForBuffer((VkBuffer)this->handle, AstralCanvas::GPUMemoryKind_Vertex, VMA_MEMORY_USAGE_CPU_TO_GPU, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
                 }
                 else
                 {
-                    this->memoryAllocation = AstralCanvasVk_AllocateMemoryForBuffer((VkBuffer)this->handle, VMA_MEMORY_USAGE_GPU_ONLY, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+                    this->memoryAllocation = AstralCanvasVk_AllocateMemoryForBuffer((VkBuffer)this->handle, AstralCanvas::GPUMemoryKind_Vertex, VMA_MEMORY_USAGE_GPU_ONLY, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
                 }
                 break;
             }
@@ -88,21 +99,13 @@ namespace AstralCanvas
             {
                 if (this->isDynamic)
                 {
-                    memcpy(this->memoryAllocation.vkAllocationInfo.pMappedData, verticesData, count * this->vertexType->size);
+                    usize regionOffset = this->regions.BeginWrite();
+                    memcpy((u8 *)this->memoryAllocation.vkAllocationInfo.pMappedData + regionOffset, verticesData, count * this->vertexType->size);
                 }
                 else
                 {
                     usize lengthOfBytes = count * this->vertexType->size;
-                    AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
-                    VkBuffer stagingBuffer = AstralCanvasVk_CreateResourceBuffer(gpu, lengthOfBytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
-                    MemoryAllocation stagingMemory = AstralCanvasVk_AllocateMemoryForBuffer(stagingBuffer, VMA_MEMORY_USAGE_CPU_TO_GPU, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
-
-                    memcpy(stagingMemory.vkAllocationInfo.pMappedData, verticesData, lengthOfBytes);
-
-                    AstralCanvasVk_CopyBufferToBuffer(gpu, stagingBuffer, (VkBuffer)this->handle, lengthOfBytes);
-
-                    vkDestroyBuffer(gpu->logicalDevice, stagingBuffer, NULL);
-                    vmaFreeMemory(AstralCanvasVk_GetCurrentVulkanAllocator(), stagingMemory.vkAllocation);
+                    AstralCanvasVk_StageBufferUpload(AstralCanvasVk_GetCurrentGPU(), verticesData, lengthOfBytes, (VkBuffer)this->handle, 0);
                 }
                 break;
             }
@@ -127,6 +130,54 @@ namespace AstralCanvas
                 break;
         }
     }
+    void VertexBuffer::SetData(void* verticesData, usize count, usize startVertex)
+    {
+        switch (GetActiveBackend())
+        {
+            #ifdef ASTRALCANVAS_VULKAN
+            case Backend_Vulkan:
+            {
+                usize offset = startVertex * this->vertexType->size;
+                if (this->isDynamic)
+                {
+                    usize regionOffset = this->regions.BeginPartialWrite((u8 *)this->memoryAllocation.vkAllocationInfo.pMappedData, offset);
+                    memcpy((u8 *)this->memoryAllocation.vkAllocationInfo.pMappedData + regionOffset + offset, verticesData, count * this->vertexType->size);
+                }
+                else
+                {
+                    AstralCanvasVk_StageBufferUpload(AstralCanvasVk_GetCurrentGPU(), verticesData, count * this->vertexType->size, (VkBuffer)this->handle, offset);
+                }
+                break;
+            }
+            #endif
+            #ifdef ASTRALCANVAS_METAL
+            case Backend_Metal:
+            {
+                if (startVertex != 0)
+                {
+                    THROW_ERR("Unimplemented backend: VertexBuffer SetData at an offset");
+                    break;
+                }
+                AstralCanvasMetal_SetVertexData(this, verticesData, count);
+                break;
+            }
+            #endif
+            #ifdef ASTRALCANVAS_OPENGL
+            case Backend_OpenGL:
+            {
+                //rewriting a dynamic buffer from the start orphans the old storage rather than waiting on draws still reading it
+                if (startVertex == 0 && this->isDynamic)
+                {
+                    glNamedBufferData((u32)this->handle, this->vertexCount * this->vertexType->size, NULL, GL_DYNAMIC_DRAW);
+                }
+                glNamedBufferSubData((u32)this->handle, startVertex * this->vertexType->size, count * this->vertexType->size, verticesData);
+                break;
+            }
+            #endif
+            default:
+                break;
+        }
+    }
     void *VertexBuffer::GetData(IAllocator allocator, usize* dataLength)
     {
         if (canRead)
@@ -137,9 +188,20 @@ namespace AstralCanvas
                 case Backend_Vulkan:
                 {
                     usize lengthOfBytes = this->vertexCount * this->vertexType->size;
+                    if (this->isDynamic)
+                    {
+                        //already host visible, read back the region last written
+                        void *result = allocator.Allocate(lengthOfBytes);
+                        memcpy(result, (u8 *)this->memoryAllocation.vkAllocationInfo.pMappedData + this->regions.GetCurrentOffset(), lengthOfBytes);
+                        if (dataLength != NULL)
+                        {
+                            *dataLength = lengthOfBytes;
+                        }
+                        return result;
+                    }
                     AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
                     VkBuffer stagingBuffer = AstralCanvasVk_CreateResourceBuffer(gpu, lengthOfBytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT);
-                    MemoryAllocation stagingMemory = AstralCanvasVk_AllocateMemoryForBuffer(stagingBuffer, VMA_MEMORY_USAGE_GPU_TO_CPU, (VkMemoryPropertyFlagBits)(VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT));
+                    MemoryAllocation stagingMemory = AstralCanvasVk_AllocateMemoryForBuffer(stagingBuffer, AstralCanvas::GPUMemoryKind_Staging, VMA_MEMORY_USAGE_GPU_TO_CPU, (VkMemoryPropertyFlagBits)(VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT));
 
                     AstralCanvasVk_CopyBufferToBuffer(gpu, (VkBuffer)this->handle, stagingBuffer, lengthOfBytes);
 
@@ -147,7 +209,7 @@ namespace AstralCanvas
                     memcpy(result, stagingMemory.vkAllocationInfo.pMappedData, lengthOfBytes);
 
                     vkDestroyBuffer(gpu->logicalDevice, stagingBuffer, NULL);
-                    vmaFreeMemory(AstralCanvasVk_GetCurrentVulkanAllocator(), stagingMemory.vkAllocation);
+                    AstralCanvasVk_FreeMemory(AstralCanvas::GPUMemoryKind_Staging, &stagingMemory);
 
                     if (dataLength != NULL)
                     {
@@ -190,11 +252,7 @@ namespace AstralCanvas
             #ifdef ASTRALCANVAS_VULKAN
             case Backend_Vulkan:
             {
-                AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
-
-                vkDestroyBuffer(gpu->logicalDevice, (VkBuffer)this->handle, NULL);
-
-                vmaFreeMemory(AstralCanvasVk_GetCurrentVulkanAllocator(), this->memoryAllocation.vkAllocation);
+                AstralCanvasVk_QueueDestroyBuffer((VkBuffer)this->handle, AstralCanvas::GPUMemoryKind_Vertex, &this->memoryAllocation);
                 break;
             }
             #endif
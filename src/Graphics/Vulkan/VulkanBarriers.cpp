@@ -0,0 +1,323 @@
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanBarriers.hpp"
+#include "ErrorHandling.hpp"
+
+#define ASTRALVULKAN_DEPTH_STAGES (VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT)
+#define ASTRALVULKAN_SAMPLED_STAGES (VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT)
+#define ASTRALVULKAN_WRITE_ACCESSES (VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_HOST_WRITE_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT)
+
+struct AstralCanvasVkImageLayoutStateEntry
+{
+    VkImageLayout layout;
+    //what must complete before leaving this layout
+    AstralCanvasVkResourceState asSource;
+    //what must wait for the transition into this layout
+    AstralCanvasVkResourceState asDestination;
+};
+
+const AstralCanvasVkImageLayoutStateEntry AstralCanvasVk_ImageLayoutStates[] =
+{
+    { VK_IMAGE_LAYOUT_UNDEFINED,
+        { VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, 0 },
+        { VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, 0 } },
+    { VK_IMAGE_LAYOUT_GENERAL,
+        { VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_WRITE_BIT },
+        { VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT } },
+    { VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        { VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT },
+        { VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT } },
+    { VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        { ASTRALVULKAN_DEPTH_STAGES, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT },
+        { ASTRALVULKAN_DEPTH_STAGES, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT } },
+    { VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+        { ASTRALVULKAN_DEPTH_STAGES | ASTRALVULKAN_SAMPLED_STAGES, 0 },
+        { ASTRALVULKAN_DEPTH_STAGES | ASTRALVULKAN_SAMPLED_STAGES, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_INPUT_ATTACHMENT_READ_BIT } },
+    { VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        { ASTRALVULKAN_SAMPLED_STAGES, 0 },
+        { ASTRALVULKAN_SAMPLED_STAGES, VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_INPUT_ATTACHMENT_READ_BIT } },
+    { VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        { VK_PIPELINE_STAGE_2_TRANSFER_BIT, 0 },
+        { VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT } },
+    { VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        { VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT },
+        { VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT } },
+    { VK_IMAGE_LAYOUT_PREINITIALIZED,
+        { VK_PIPELINE_STAGE_2_HOST_BIT, VK_ACCESS_2_HOST_WRITE_BIT },
+        { VK_PIPELINE_STAGE_2_HOST_BIT, VK_ACCESS_2_HOST_WRITE_BIT } },
+    //leaving present has to wait on the stage the acquire semaphore is waited on, so the transition chains after it.
+    //Entering present needs nothing, vkQueuePresentKHR performs automatic visibility operations
+    { VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+        { VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, 0 },
+        { VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, 0 } },
+};
+
+AstralCanvasVkResourceState AstralCanvasVk_GetImageLayoutState(VkImageLayout layout, bool asDestination)
+{
+    usize count = sizeof(AstralCanvasVk_ImageLayoutStates) / sizeof(AstralCanvasVkImageLayoutStateEntry);
+    for (usize i = 0; i < count; i++)
+    {
+        if (AstralCanvasVk_ImageLayoutStates[i].layout == layout)
+        {
+            if (asDestination)
+            {
+                if (layout == VK_IMAGE_LAYOUT_UNDEFINED)
+                {
+                    break;
+                }
+                return AstralCanvasVk_ImageLayoutStates[i].asDestination;
+            }
+            return AstralCanvasVk_ImageLayoutStates[i].asSource;
+        }
+    }
+    if (asDestination)
+    {
+        THROW_ERR("Invalid destination layout!");
+    }
+    else
+    {
+        THROW_ERR("Invalid source layout!");
+    }
+    AstralCanvasVkResourceState result = {};
+    result.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    result.accessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+    return result;
+}
+
+AstralCanvasVkBarrierBatch::AstralCanvasVkBarrierBatch(AstralVulkanGPU *gpu, VkCommandBuffer commandBuffer)
+{
+    this->gpu = gpu;
+    this->commandBuffer = commandBuffer;
+    this->imageBarrierCount = 0;
+    this->bufferBarrierCount = 0;
+    this->memoryBarrier = {};
+    this->memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+    this->hasMemoryBarrier = false;
+}
+void AstralCanvasVkBarrierBatch::TransitionImage(VkImage image, u32 mipLevels, VkImageAspectFlags aspectFlags, VkImageLayout oldLayout, VkImageLayout newLayout)
+{
+    if (imageBarrierCount == ASTRALVULKAN_MAX_BATCHED_BARRIERS)
+    {
+        Flush();
+    }
+    AstralCanvasVkResourceState source = AstralCanvasVk_GetImageLayoutState(oldLayout, false);
+    AstralCanvasVkResourceState destination = AstralCanvasVk_GetImageLayoutState(newLayout, true);
+
+    VkImageMemoryBarrier2 *barrier = &imageBarriers[imageBarrierCount];
+    *barrier = {};
+    barrier->sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+    barrier->srcStageMask = source.stageMask;
+    barrier->srcAccessMask = source.accessMask;
+    barrier->dstStageMask = destination.stageMask;
+    barrier->dstAccessMask = destination.accessMask;
+    barrier->oldLayout = oldLayout;
+    barrier->newLayout = newLayout;
+    barrier->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier->image = image;
+    barrier->subresourceRange.aspectMask = aspectFlags;
+    barrier->subresourceRange.baseMipLevel = 0;
+    barrier->subresourceRange.levelCount = mipLevels;
+    barrier->subresourceRange.baseArrayLayer = 0;
+    barrier->subresourceRange.layerCount = 1;
+
+    imageBarrierCount += 1;
+}
+void AstralCanvasVkBarrierBatch::AccessTexture(AstralCanvas::Texture2D *texture, VkImageAspectFlags aspectFlags, VkImageLayout newLayout, VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask)
+{
+    VkImageLayout oldLayout = (VkImageLayout)texture->imageLayout;
+    AstralCanvasVkResourceState source;
+    if (texture->usageStageMask != 0 && texture->usageLayout == texture->imageLayout)
+    {
+        source.stageMask = (VkPipelineStageFlags2)texture->usageStageMask;
+        source.accessMask = (VkAccessFlags2)texture->usageAccessMask;
+    }
+    else
+    {
+        source = AstralCanvasVk_GetImageLayoutState(oldLayout, false);
+    }
+
+    if (oldLayout == newLayout && (source.accessMask & ASTRALVULKAN_WRITE_ACCESSES) == 0 && (dstAccessMask & ASTRALVULKAN_WRITE_ACCESSES) == 0)
+    {
+        //reads need not wait on each other, but whatever writes next has to wait on all of them
+        texture->usageLayout = (u64)newLayout;
+        texture->usageStageMask = (u64)(source.stageMask | dstStageMask);
+        texture->usageAccessMask = (u64)(source.accessMask | dstAccessMask);
+        return;
+    }
+
+    if (imageBarrierCount == ASTRALVULKAN_MAX_BATCHED_BARRIERS)
+    {
+        Flush();
+    }
+    VkImageMemoryBarrier2 *barrier = &imageBarriers[imageBarrierCount];
+    *barrier = {};
+    barrier->sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+    barrier->srcStageMask = source.stageMask;
+    barrier->srcAccessMask = source.accessMask;
+    barrier->dstStageMask = dstStageMask;
+    barrier->dstAccessMask = dstAccessMask;
+    barrier->oldLayout = oldLayout;
+    barrier->newLayout = newLayout;
+    barrier->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier->image = (VkImage)texture->imageHandle;
+    barrier->subresourceRange.aspectMask = aspectFlags;
+    barrier->subresourceRange.baseMipLevel = 0;
+    barrier->subresourceRange.levelCount = texture->mipLevels;
+    barrier->subresourceRange.baseArrayLayer = 0;
+    barrier->subresourceRange.layerCount = 1;
+    imageBarrierCount += 1;
+
+    texture->imageLayout = (u64)newLayout;
+    texture->usageLayout = (u64)newLayout;
+    texture->usageStageMask = (u64)dstStageMask;
+    texture->usageAccessMask = (u64)dstAccessMask;
+}
+void AstralCanvasVkBarrierBatch::TransitionTexture(AstralCanvas::Texture2D *texture, VkImageAspectFlags aspectFlags, VkImageLayout newLayout)
+{
+    if (texture->imageLayout == (u64)newLayout)
+    {
+        return;
+    }
+    AstralCanvasVkResourceState destination = AstralCanvasVk_GetImageLayoutState(newLayout, true);
+    AccessTexture(texture, aspectFlags, newLayout, destination.stageMask, destination.accessMask);
+}
+void AstralCanvasVkBarrierBatch::AccessBuffer(AstralCanvas::ComputeBuffer *buffer, VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask)
+{
+    VkPipelineStageFlags2 srcStageMask = (VkPipelineStageFlags2)buffer->usageStageMask;
+    VkAccessFlags2 srcAccessMask = (VkAccessFlags2)buffer->usageAccessMask;
+    if (srcStageMask == 0 || ((srcAccessMask & ASTRALVULKAN_WRITE_ACCESSES) == 0 && (dstAccessMask & ASTRALVULKAN_WRITE_ACCESSES) == 0))
+    {
+        buffer->usageStageMask = (u64)(srcStageMask | dstStageMask);
+        buffer->usageAccessMask = (u64)(srcAccessMask | dstAccessMask);
+        return;
+    }
+    BufferBarrier((VkBuffer)buffer->handle, 0, VK_WHOLE_SIZE, srcStageMask, srcAccessMask, dstStageMask, dstAccessMask);
+    buffer->usageStageMask = (u64)dstStageMask;
+    buffer->usageAccessMask = (u64)dstAccessMask;
+}
+void AstralCanvasVkBarrierBatch::BufferBarrier(VkBuffer buffer, usize offset, usize size, VkPipelineStageFlags2 srcStageMask, VkAccessFlags2 srcAccessMask, VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask)
+{
+    if (bufferBarrierCount == ASTRALVULKAN_MAX_BATCHED_BARRIERS)
+    {
+        Flush();
+    }
+    VkBufferMemoryBarrier2 *barrier = &bufferBarriers[bufferBarrierCount];
+    *barrier = {};
+    barrier->sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+    barrier->srcStageMask = srcStageMask;
+    barrier->srcAccessMask = srcAccessMask;
+    barrier->dstStageMask = dstStageMask;
+    barrier->dstAccessMask = dstAccessMask;
+    barrier->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier->buffer = buffer;
+    barrier->offset = offset;
+    barrier->size = size;
+
+    bufferBarrierCount += 1;
+}
+void AstralCanvasVkBarrierBatch::GlobalBarrier(VkPipelineStageFlags2 srcStageMask, VkAccessFlags2 srcAccessMask, VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask)
+{
+    memoryBarrier.srcStageMask |= srcStageMask;
+    memoryBarrier.srcAccessMask |= srcAccessMask;
+    memoryBarrier.dstStageMask |= dstStageMask;
+    memoryBarrier.dstAccessMask |= dstAccessMask;
+    hasMemoryBarrier = true;
+}
+void AstralCanvasVkBarrierBatch::Flush()
+{
+    if (imageBarrierCount == 0 && bufferBarrierCount == 0 && !hasMemoryBarrier)
+    {
+        return;
+    }
+
+    if (gpu->supportsSynchronization2)
+    {
+        VkDependencyInfo dependencyInfo = {};
+        dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependencyInfo.memoryBarrierCount = hasMemoryBarrier ? 1 : 0;
+        dependencyInfo.pMemoryBarriers = &memoryBarrier;
+        dependencyInfo.bufferMemoryBarrierCount = bufferBarrierCount;
+        dependencyInfo.pBufferMemoryBarriers = bufferBarriers;
+        dependencyInfo.imageMemoryBarrierCount = imageBarrierCount;
+        dependencyInfo.pImageMemoryBarriers = imageBarriers;
+
+        vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+    }
+    else
+    {
+        //synchronization 1 only takes a single pair of stage masks per call, so merge them all.
+        //The legacy stage and access bits share their values with the first 32 bits of the 2 variants
+        VkPipelineStageFlags srcStageMask = 0;
+        VkPipelineStageFlags dstStageMask = 0;
+
+        VkMemoryBarrier legacyMemoryBarrier = {};
+        legacyMemoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        if (hasMemoryBarrier)
+        {
+            srcStageMask |= (VkPipelineStageFlags)memoryBarrier.srcStageMask;
+            dstStageMask |= (VkPipelineStageFlags)memoryBarrier.dstStageMask;
+            legacyMemoryBarrier.srcAccessMask = (VkAccessFlags)memoryBarrier.srcAccessMask;
+            legacyMemoryBarrier.dstAccessMask = (VkAccessFlags)memoryBarrier.dstAccessMask;
+        }
+
+        VkBufferMemoryBarrier legacyBufferBarriers[ASTRALVULKAN_MAX_BATCHED_BARRIERS];
+        for (u32 i = 0; i < bufferBarrierCount; i++)
+        {
+            VkBufferMemoryBarrier2 *barrier = &bufferBarriers[i];
+            srcStageMask |= (VkPipelineStageFlags)barrier->srcStageMask;
+            dstStageMask |= (VkPipelineStageFlags)barrier->dstStageMask;
+
+            legacyBufferBarriers[i] = {};
+            legacyBufferBarriers[i].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            legacyBufferBarriers[i].srcAccessMask = (VkAccessFlags)barrier->srcAccessMask;
+            legacyBufferBarriers[i].dstAccessMask = (VkAccessFlags)barrier->dstAccessMask;
+            legacyBufferBarriers[i].srcQueueFamilyIndex = barrier->srcQueueFamilyIndex;
+            legacyBufferBarriers[i].dstQueueFamilyIndex = barrier->dstQueueFamilyIndex;
+            legacyBufferBarriers[i].buffer = barrier->buffer;
+            legacyBufferBarriers[i].offset = barrier->offset;
+            legacyBufferBarriers[i].size = barrier->size;
+        }
+
+        VkImageMemoryBarrier legacyImageBarriers[ASTRALVULKAN_MAX_BATCHED_BARRIERS];
+        for (u32 i = 0; i < imageBarrierCount; i++)
+        {
+            VkImageMemoryBarrier2 *barrier = &imageBarriers[i];
+            srcStageMask |= (VkPipelineStageFlags)barrier->srcStageMask;
+            dstStageMask |= (VkPipelineStageFlags)barrier->dstStageMask;
+
+            legacyImageBarriers[i] = {};
+            legacyImageBarriers[i].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            legacyImageBarriers[i].srcAccessMask = (VkAccessFlags)barrier->srcAccessMask;
+            legacyImageBarriers[i].dstAccessMask = (VkAccessFlags)barrier->dstAccessMask;
+            legacyImageBarriers[i].oldLayout = barrier->oldLayout;
+            legacyImageBarriers[i].newLayout = barrier->newLayout;
+            legacyImageBarriers[i].srcQueueFamilyIndex = barrier->srcQueueFamilyIndex;
+            legacyImageBarriers[i].dstQueueFamilyIndex = barrier->dstQueueFamilyIndex;
+            legacyImageBarriers[i].image = barrier->image;
+            legacyImageBarriers[i].subresourceRange = barrier->subresourceRange;
+        }
+
+        if (srcStageMask == 0)
+        {
+            srcStageMask = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        }
+        if (dstStageMask == 0)
+        {
+            dstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+        }
+
+        vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask, 0,
+            hasMemoryBarrier ? 1 : 0, &legacyMemoryBarrier,
+            bufferBarrierCount, legacyBufferBarriers,
+            imageBarrierCount, legacyImageBarriers);
+    }
+
+    imageBarrierCount = 0;
+    bufferBarrierCount = 0;
+    memoryBarrier = {};
+    memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+    hasMemoryBarrier = false;
+}
+#endif
@@ -0,0 +1,289 @@
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanBindless.hpp"
+#include "Graphics/Vulkan/VulkanInstanceData.hpp"
+#include "ErrorHandling.hpp"
+#include "vector.hpp"
+#include "threading.hpp"
+
+struct AstralCanvasVkBindlessReleasedSlot
+{
+    u32 index;
+    u64 releasedOnFrame;
+};
+/// Hands out indices of one binding of the heap. Index 0 is reserved so that zero initialized resources never
+/// appear to be in the heap
+struct AstralCanvasVkBindlessSlots
+{
+    u32 capacity;
+    u32 nextUnused;
+    collections::vector<u32> freeSlots;
+    /// Released slots in release order, waiting for the frames that may still read them to retire
+    collections::vector<AstralCanvasVkBindlessReleasedSlot> releasedSlots;
+};
+
+VkDescriptorSetLayout AstralCanvasVk_BindlessSetLayout = NULL;
+VkDescriptorSetLayout AstralCanvasVk_EmptySetLayout = NULL;
+VkDescriptorPool AstralCanvasVk_BindlessPool = NULL;
+VkDescriptorSet AstralCanvasVk_BindlessSet = NULL;
+AstralCanvasVkBindlessSlots AstralCanvasVk_BindlessTextures;
+AstralCanvasVkBindlessSlots AstralCanvasVk_BindlessSamplers;
+threading::Mutex AstralCanvasVk_BindlessMutex;
+
+VkDescriptorSetLayout AstralCanvasVk_GetBindlessSetLayout()
+{
+    return AstralCanvasVk_BindlessSetLayout;
+}
+VkDescriptorSet AstralCanvasVk_GetBindlessSet()
+{
+    return AstralCanvasVk_BindlessSet;
+}
+VkDescriptorSetLayout AstralCanvasVk_GetEmptySetLayout()
+{
+    return AstralCanvasVk_EmptySetLayout;
+}
+
+bool AstralCanvasVk_CreateBindlessHeap(AstralVulkanGPU *gpu, IAllocator allocator)
+{
+    if (!gpu->supportsBindless)
+    {
+        return true;
+    }
+
+    VkPhysicalDeviceVulkan12Properties properties12 = {};
+    properties12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+    VkPhysicalDeviceProperties2 properties = {};
+    properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties.pNext = &properties12;
+    vkGetPhysicalDeviceProperties2(gpu->physicalDevice, &properties);
+
+    u32 maxTextures = ASTRALVULKAN_BINDLESS_MAX_TEXTURES;
+    if (properties12.maxPerStageDescriptorUpdateAfterBindSampledImages < maxTextures)
+    {
+        maxTextures = properties12.maxPerStageDescriptorUpdateAfterBindSampledImages;
+    }
+    u32 maxSamplers = ASTRALVULKAN_BINDLESS_MAX_SAMPLERS;
+    if (properties12.maxPerStageDescriptorUpdateAfterBindSamplers < maxSamplers)
+    {
+        maxSamplers = properties12.maxPerStageDescriptorUpdateAfterBindSamplers;
+    }
+
+    VkDescriptorSetLayoutBinding bindings[2];
+    bindings[0] = {};
+    bindings[0].binding = ASTRALVULKAN_BINDLESS_TEXTURES_BINDING;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    bindings[0].descriptorCount = maxTextures;
+    bindings[0].stageFlags = VK_SHADER_STAGE_ALL;
+    bindings[1] = {};
+    bindings[1].binding = ASTRALVULKAN_BINDLESS_SAMPLERS_BINDING;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+    bindings[1].descriptorCount = maxSamplers;
+    bindings[1].stageFlags = VK_SHADER_STAGE_ALL;
+
+    //slots are written while frames using other slots are in flight, and most slots are empty at any one time
+    VkDescriptorBindingFlags bindingFlags[2];
+    bindingFlags[0] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+    bindingFlags[1] = bindingFlags[0];
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo = {};
+    bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    bindingFlagsInfo.bindingCount = 2;
+    bindingFlagsInfo.pBindingFlags = bindingFlags;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.pNext = &bindingFlagsInfo;
+    layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layoutInfo.bindingCount = 2;
+    layoutInfo.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(gpu->logicalDevice, &layoutInfo, NULL, &AstralCanvasVk_BindlessSetLayout) != VK_SUCCESS)
+    {
+        AstralCanvasVk_BindlessSetLayout = NULL;
+        return false;
+    }
+
+    VkDescriptorSetLayoutCreateInfo emptyLayoutInfo = {};
+    emptyLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    if (vkCreateDescriptorSetLayout(gpu->logicalDevice, &emptyLayoutInfo, NULL, &AstralCanvasVk_EmptySetLayout) != VK_SUCCESS)
+    {
+        return false;
+    }
+
+    VkDescriptorPoolSize poolSizes[2];
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    poolSizes[0].descriptorCount = maxTextures;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_SAMPLER;
+    poolSizes[1].descriptorCount = maxSamplers;
+
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = 2;
+    poolInfo.pPoolSizes = poolSizes;
+    if (vkCreateDescriptorPool(gpu->logicalDevice, &poolInfo, NULL, &AstralCanvasVk_BindlessPool) != VK_SUCCESS)
+    {
+        AstralCanvasVk_BindlessPool = NULL;
+        return false;
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = AstralCanvasVk_BindlessPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &AstralCanvasVk_BindlessSetLayout;
+    if (vkAllocateDescriptorSets(gpu->logicalDevice, &allocInfo, &AstralCanvasVk_BindlessSet) != VK_SUCCESS)
+    {
+        AstralCanvasVk_BindlessSet = NULL;
+        return false;
+    }
+
+    AstralCanvasVk_BindlessTextures.capacity = maxTextures;
+    AstralCanvasVk_BindlessTextures.nextUnused = 1;
+    AstralCanvasVk_BindlessTextures.freeSlots = collections::vector<u32>(allocator);
+    AstralCanvasVk_BindlessTextures.releasedSlots = collections::vector<AstralCanvasVkBindlessReleasedSlot>(allocator);
+    AstralCanvasVk_BindlessSamplers.capacity = maxSamplers;
+    AstralCanvasVk_BindlessSamplers.nextUnused = 1;
+    AstralCanvasVk_BindlessSamplers.freeSlots = collections::vector<u32>(allocator);
+    AstralCanvasVk_BindlessSamplers.releasedSlots = collections::vector<AstralCanvasVkBindlessReleasedSlot>(allocator);
+    AstralCanvasVk_BindlessMutex = threading::Mutex::init();
+    return true;
+}
+void AstralCanvasVk_DestroyBindlessHeap(AstralVulkanGPU *gpu)
+{
+    if (AstralCanvasVk_BindlessSetLayout == NULL)
+    {
+        return;
+    }
+    //frees the set along with it
+    if (AstralCanvasVk_BindlessPool != NULL)
+    {
+        vkDestroyDescriptorPool(gpu->logicalDevice, AstralCanvasVk_BindlessPool, NULL);
+    }
+    if (AstralCanvasVk_EmptySetLayout != NULL)
+    {
+        vkDestroyDescriptorSetLayout(gpu->logicalDevice, AstralCanvasVk_EmptySetLayout, NULL);
+    }
+    vkDestroyDescriptorSetLayout(gpu->logicalDevice, AstralCanvasVk_BindlessSetLayout, NULL);
+    AstralCanvasVk_BindlessPool = NULL;
+    AstralCanvasVk_BindlessSet = NULL;
+    AstralCanvasVk_EmptySetLayout = NULL;
+    AstralCanvasVk_BindlessSetLayout = NULL;
+
+    AstralCanvasVk_BindlessTextures.freeSlots.deinit();
+    AstralCanvasVk_BindlessTextures.releasedSlots.deinit();
+    AstralCanvasVk_BindlessSamplers.freeSlots.deinit();
+    AstralCanvasVk_BindlessSamplers.releasedSlots.deinit();
+    AstralCanvasVk_BindlessMutex.deinit();
+}
+
+//expects the bindless mutex to be held
+u32 AstralCanvasVk_BindlessTakeSlot(AstralCanvasVkBindlessSlots *slots)
+{
+    //released slots are in release order, so stop at the first one that may still be in use
+    u64 frameNumber = AstralCanvasVk_GetFrameNumber();
+    u64 framesInFlight = AstralCanvasVk_GetFramesInFlight();
+    usize retired = 0;
+    while (retired < slots->releasedSlots.count && slots->releasedSlots.ptr[retired].releasedOnFrame + framesInFlight < frameNumber)
+    {
+        slots->freeSlots.Add(slots->releasedSlots.ptr[retired].index);
+        retired += 1;
+    }
+    for (usize i = 0; i < retired; i++)
+    {
+        slots->releasedSlots.RemoveAt_Pullback(0);
+    }
+
+    if (slots->freeSlots.count > 0)
+    {
+        u32 index = slots->freeSlots.ptr[slots->freeSlots.count - 1];
+        slots->freeSlots.RemoveAt_Swap(slots->freeSlots.count - 1);
+        return index;
+    }
+    if (slots->nextUnused < slots->capacity)
+    {
+        u32 index = slots->nextUnused;
+        slots->nextUnused += 1;
+        return index;
+    }
+    return 0;
+}
+void AstralCanvasVk_BindlessWrite(AstralVulkanGPU *gpu, u32 binding, u32 index, VkDescriptorType type, VkImageView imageView, VkSampler sampler)
+{
+    VkDescriptorImageInfo imageInfo = {};
+    imageInfo.imageView = imageView;
+    imageInfo.sampler = sampler;
+    imageInfo.imageLayout = imageView != NULL ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = AstralCanvasVk_BindlessSet;
+    write.dstBinding = binding;
+    write.dstArrayElement = index;
+    write.descriptorCount = 1;
+    write.descriptorType = type;
+    write.pImageInfo = &imageInfo;
+    vkUpdateDescriptorSets(gpu->logicalDevice, 1, &write, 0, NULL);
+}
+
+u32 AstralCanvasVk_BindlessAddTexture(AstralVulkanGPU *gpu, VkImageView imageView)
+{
+    if (AstralCanvasVk_BindlessSet == NULL)
+    {
+        return 0;
+    }
+    AstralCanvasVk_BindlessMutex.EnterLock();
+    u32 index = AstralCanvasVk_BindlessTakeSlot(&AstralCanvasVk_BindlessTextures);
+    if (index == 0)
+    {
+        LOG_WARNING("Bindless texture heap is full");
+    }
+    else
+    {
+        AstralCanvasVk_BindlessWrite(gpu, ASTRALVULKAN_BINDLESS_TEXTURES_BINDING, index, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, imageView, NULL);
+    }
+    AstralCanvasVk_BindlessMutex.ExitLock();
+    return index;
+}
+u32 AstralCanvasVk_BindlessAddSampler(AstralVulkanGPU *gpu, VkSampler sampler)
+{
+    if (AstralCanvasVk_BindlessSet == NULL)
+    {
+        return 0;
+    }
+    AstralCanvasVk_BindlessMutex.EnterLock();
+    u32 index = AstralCanvasVk_BindlessTakeSlot(&AstralCanvasVk_BindlessSamplers);
+    if (index == 0)
+    {
+        LOG_WARNING("Bindless sampler heap is full");
+    }
+    else
+    {
+        AstralCanvasVk_BindlessWrite(gpu, ASTRALVULKAN_BINDLESS_SAMPLERS_BINDING, index, VK_DESCRIPTOR_TYPE_SAMPLER, NULL, sampler);
+    }
+    AstralCanvasVk_BindlessMutex.ExitLock();
+    return index;
+}
+
+void AstralCanvasVk_BindlessRelease(AstralCanvasVkBindlessSlots *slots, u32 index)
+{
+    if (index == 0 || AstralCanvasVk_BindlessSet == NULL)
+    {
+        return;
+    }
+    //the stale descriptor is left in place, partially bound slots are fine as long as shaders stop indexing them
+    AstralCanvasVk_BindlessMutex.EnterLock();
+    AstralCanvasVkBindlessReleasedSlot released;
+    released.index = index;
+    released.releasedOnFrame = AstralCanvasVk_GetFrameNumber();
+    slots->releasedSlots.Add(released);
+    AstralCanvasVk_BindlessMutex.ExitLock();
+}
+void AstralCanvasVk_BindlessRemoveTexture(u32 index)
+{
+    AstralCanvasVk_BindlessRelease(&AstralCanvasVk_BindlessTextures, index);
+}
+void AstralCanvasVk_BindlessRemoveSampler(u32 index)
+{
+    AstralCanvasVk_BindlessRelease(&AstralCanvasVk_BindlessSamplers, index);
+}
+#endif
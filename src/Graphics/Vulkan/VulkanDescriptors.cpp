@@ -0,0 +1,335 @@
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanDescriptors.hpp"
+#include "Graphics/Vulkan/VulkanInstanceData.hpp"
+#include "ErrorHandling.hpp"
+#include "hashmap.hpp"
+#include "vector.hpp"
+#include "threading.hpp"
+#include <string.h>
+
+struct AstralCanvasVkCachedDescriptorSet
+{
+    /// Owned copy of the key the set was written with
+    AstralCanvasVkDescriptorSetKey key;
+    VkDescriptorSetLayout setLayout;
+    VkDescriptorSet set;
+    VkDescriptorPool pool;
+    /// The last frame a draw was handed this set. It may only be freed once that frame has retired
+    u64 lastUsedFrame;
+};
+struct AstralCanvasVkEvictedDescriptorSet
+{
+    VkDescriptorSet set;
+    VkDescriptorPool pool;
+    u64 lastUsedFrame;
+};
+
+inline u32 AstralCanvasVk_DescriptorSetKeyHash(AstralCanvasVkDescriptorSetKey key)
+{
+    return key.hash;
+}
+inline bool AstralCanvasVk_DescriptorSetKeyEql(AstralCanvasVkDescriptorSetKey A, AstralCanvasVkDescriptorSetKey B)
+{
+    return A.hash == B.hash && A.size == B.size && memcmp(A.data, B.data, A.size) == 0;
+}
+
+IAllocator AstralCanvasVk_DescriptorCacheAllocator;
+/// Pools are never destroyed until shutdown. Sets are freed back into them individually as they are evicted
+collections::vector<VkDescriptorPool> AstralCanvasVk_DescriptorPools;
+usize AstralCanvasVk_CurrentDescriptorPool;
+/// Keys in the map point into the copies owned by the entries in the list
+collections::hashmap<AstralCanvasVkDescriptorSetKey, AstralCanvasVkCachedDescriptorSet *> AstralCanvasVk_CachedDescriptorSets;
+collections::vector<AstralCanvasVkCachedDescriptorSet *> AstralCanvasVk_CachedDescriptorSetList;
+/// Sets no longer in the cache that a frame in flight may still have bound
+collections::vector<AstralCanvasVkEvictedDescriptorSet> AstralCanvasVk_EvictedDescriptorSets;
+bool AstralCanvasVk_DescriptorCacheCreated = false;
+threading::Mutex AstralCanvasVk_DescriptorPoolMutex;
+
+//expects the descriptor pool mutex to be held
+void AstralCanvasVk_EvictCachedDescriptorSetAt(usize index)
+{
+    AstralCanvasVkCachedDescriptorSet *entry = AstralCanvasVk_CachedDescriptorSetList.ptr[index];
+
+    AstralCanvasVkEvictedDescriptorSet evicted;
+    evicted.set = entry->set;
+    evicted.pool = entry->pool;
+    evicted.lastUsedFrame = entry->lastUsedFrame;
+    AstralCanvasVk_EvictedDescriptorSets.Add(evicted);
+
+    AstralCanvasVk_CachedDescriptorSets.Remove(entry->key);
+    AstralCanvasVk_DescriptorCacheAllocator.Free(entry->key.data);
+    AstralCanvasVk_DescriptorCacheAllocator.Free(entry);
+    AstralCanvasVk_CachedDescriptorSetList.RemoveAt_Swap(index);
+}
+
+VkDescriptorPool AstralCanvasVk_CreateDescriptorPool(AstralVulkanGPU *gpu)
+{
+    u32 maxDescriptors = ASTRALVULKAN_DESCRIPTOR_POOL_SETS;
+    VkDescriptorPoolSize poolSizes[6];
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    poolSizes[0].descriptorCount = maxDescriptors;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_SAMPLER;
+    poolSizes[1].descriptorCount = maxDescriptors;
+    poolSizes[2].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    poolSizes[2].descriptorCount = maxDescriptors;
+    poolSizes[3].type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+    poolSizes[3].descriptorCount = maxDescriptors;
+    poolSizes[4].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[4].descriptorCount = maxDescriptors;
+    poolSizes[5].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    poolSizes[5].descriptorCount = maxDescriptors;
+
+    //cached sets live across frames and are evicted one at a time, so they have to be freeable individually
+    VkDescriptorPoolCreateInfo poolCreateInfo{};
+    poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    poolCreateInfo.pPoolSizes = poolSizes;
+    poolCreateInfo.poolSizeCount = 6;
+    poolCreateInfo.maxSets = maxDescriptors;
+
+    VkDescriptorPool pool;
+    if (vkCreateDescriptorPool(gpu->logicalDevice, &poolCreateInfo, NULL, &pool) != VK_SUCCESS)
+    {
+        return NULL;
+    }
+    return pool;
+}
+
+bool AstralCanvasVk_CreateDescriptorPools(AstralVulkanGPU *gpu, IAllocator allocator)
+{
+    AstralCanvasVk_DescriptorPoolMutex = threading::Mutex::init();
+    AstralCanvasVk_DescriptorCacheAllocator = allocator;
+    AstralCanvasVk_DescriptorPools = collections::vector<VkDescriptorPool>(allocator);
+    AstralCanvasVk_CurrentDescriptorPool = 0;
+    AstralCanvasVk_CachedDescriptorSets = collections::hashmap<AstralCanvasVkDescriptorSetKey, AstralCanvasVkCachedDescriptorSet *>(allocator, &AstralCanvasVk_DescriptorSetKeyHash, &AstralCanvasVk_DescriptorSetKeyEql);
+    AstralCanvasVk_CachedDescriptorSetList = collections::vector<AstralCanvasVkCachedDescriptorSet *>(allocator);
+    AstralCanvasVk_EvictedDescriptorSets = collections::vector<AstralCanvasVkEvictedDescriptorSet>(allocator);
+    AstralCanvasVk_DescriptorCacheCreated = true;
+
+    VkDescriptorPool pool = AstralCanvasVk_CreateDescriptorPool(gpu);
+    if (pool == NULL)
+    {
+        return false;
+    }
+    AstralCanvasVk_DescriptorPools.Add(pool);
+    return true;
+}
+void AstralCanvasVk_DestroyDescriptorPools(AstralVulkanGPU *gpu)
+{
+    if (!AstralCanvasVk_DescriptorCacheCreated)
+    {
+        return;
+    }
+    //destroying the pools frees every set, cached or evicted
+    for (usize i = 0; i < AstralCanvasVk_DescriptorPools.count; i++)
+    {
+        vkDestroyDescriptorPool(gpu->logicalDevice, AstralCanvasVk_DescriptorPools.ptr[i], NULL);
+    }
+    for (usize i = 0; i < AstralCanvasVk_CachedDescriptorSetList.count; i++)
+    {
+        AstralCanvasVk_DescriptorCacheAllocator.Free(AstralCanvasVk_CachedDescriptorSetList.ptr[i]->key.data);
+        AstralCanvasVk_DescriptorCacheAllocator.Free(AstralCanvasVk_CachedDescriptorSetList.ptr[i]);
+    }
+    AstralCanvasVk_DescriptorPools.deinit();
+    AstralCanvasVk_CurrentDescriptorPool = 0;
+    AstralCanvasVk_CachedDescriptorSets.deinit();
+    AstralCanvasVk_CachedDescriptorSetList.deinit();
+    AstralCanvasVk_EvictedDescriptorSets.deinit();
+    AstralCanvasVk_DescriptorCacheCreated = false;
+    AstralCanvasVk_DescriptorPoolMutex.deinit();
+}
+
+void AstralCanvasVk_RetireCachedDescriptorSets(AstralVulkanGPU *gpu)
+{
+    //once the fence of this slot has been waited on, every frame up to framesInFlight behind the current one has finished
+    u64 frameNumber = AstralCanvasVk_GetFrameNumber();
+    u64 framesInFlight = AstralCanvasVk_GetFramesInFlight();
+    if (frameNumber < framesInFlight)
+    {
+        return;
+    }
+    u64 lastRetiredFrame = frameNumber - framesInFlight;
+
+    AstralCanvasVk_DescriptorPoolMutex.EnterLock();
+    //sets nothing has asked for in a while are evicted so that the cache does not grow without bound
+    if (frameNumber >= ASTRALVULKAN_DESCRIPTOR_SET_MAX_UNUSED_FRAMES)
+    {
+        usize i = 0;
+        while (i < AstralCanvasVk_CachedDescriptorSetList.count)
+        {
+            if (AstralCanvasVk_CachedDescriptorSetList.ptr[i]->lastUsedFrame <= frameNumber - ASTRALVULKAN_DESCRIPTOR_SET_MAX_UNUSED_FRAMES)
+            {
+                AstralCanvasVk_EvictCachedDescriptorSetAt(i);
+            }
+            else
+            {
+                i += 1;
+            }
+        }
+    }
+    usize i = 0;
+    while (i < AstralCanvasVk_EvictedDescriptorSets.count)
+    {
+        AstralCanvasVkEvictedDescriptorSet *evicted = &AstralCanvasVk_EvictedDescriptorSets.ptr[i];
+        if (evicted->lastUsedFrame <= lastRetiredFrame)
+        {
+            vkFreeDescriptorSets(gpu->logicalDevice, evicted->pool, 1, &evicted->set);
+            AstralCanvasVk_EvictedDescriptorSets.RemoveAt_Swap(i);
+        }
+        else
+        {
+            i += 1;
+        }
+    }
+    AstralCanvasVk_DescriptorPoolMutex.ExitLock();
+}
+VkDescriptorSet AstralCanvasVk_AllocateDescriptorSet(AstralVulkanGPU *gpu, VkDescriptorSetLayout setLayout, VkDescriptorPool *pool)
+{
+    AstralCanvasVk_DescriptorPoolMutex.EnterLock();
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &setLayout;
+
+    VkDescriptorSet result = NULL;
+    //sets are freed back into any pool, so every existing pool is tried once before chaining a new one
+    usize poolsTried = 0;
+    while (true)
+    {
+        if (poolsTried >= AstralCanvasVk_DescriptorPools.count)
+        {
+            VkDescriptorPool newPool = AstralCanvasVk_CreateDescriptorPool(gpu);
+            if (newPool == NULL)
+            {
+                THROW_ERR("Failed to create descriptor pool");
+                result = NULL;
+                break;
+            }
+            AstralCanvasVk_DescriptorPools.Add(newPool);
+            AstralCanvasVk_CurrentDescriptorPool = AstralCanvasVk_DescriptorPools.count - 1;
+        }
+        allocInfo.descriptorPool = AstralCanvasVk_DescriptorPools.ptr[AstralCanvasVk_CurrentDescriptorPool];
+
+        VkResult allocResult = vkAllocateDescriptorSets(gpu->logicalDevice, &allocInfo, &result);
+        if (allocResult == VK_SUCCESS)
+        {
+            *pool = allocInfo.descriptorPool;
+            break;
+        }
+        if (allocResult != VK_ERROR_OUT_OF_POOL_MEMORY && allocResult != VK_ERROR_FRAGMENTED_POOL)
+        {
+            THROW_ERR("Error creating descriptor set!");
+            result = NULL;
+            break;
+        }
+        poolsTried += 1;
+        AstralCanvasVk_CurrentDescriptorPool = (AstralCanvasVk_CurrentDescriptorPool + 1) % AstralCanvasVk_DescriptorPools.count;
+    }
+    AstralCanvasVk_DescriptorPoolMutex.ExitLock();
+    return result;
+}
+
+VkDescriptorSet AstralCanvasVk_GetCachedDescriptorSet(AstralCanvasVkDescriptorSetKey key)
+{
+    VkDescriptorSet result = NULL;
+    AstralCanvasVk_DescriptorPoolMutex.EnterLock();
+    AstralCanvasVkCachedDescriptorSet *entry = AstralCanvasVk_CachedDescriptorSets.GetCopyOr(key, NULL);
+    if (entry != NULL)
+    {
+        entry->lastUsedFrame = AstralCanvasVk_GetFrameNumber();
+        result = entry->set;
+    }
+    AstralCanvasVk_DescriptorPoolMutex.ExitLock();
+    return result;
+}
+void AstralCanvasVk_CacheDescriptorSet(VkDescriptorSetLayout setLayout, AstralCanvasVkDescriptorSetKey key, VkDescriptorSet set, VkDescriptorPool pool)
+{
+    AstralCanvasVkCachedDescriptorSet *entry = (AstralCanvasVkCachedDescriptorSet *)AstralCanvasVk_DescriptorCacheAllocator.Allocate(sizeof(AstralCanvasVkCachedDescriptorSet));
+    entry->key.data = (u8 *)AstralCanvasVk_DescriptorCacheAllocator.Allocate(key.size);
+    memcpy(entry->key.data, key.data, key.size);
+    entry->key.size = key.size;
+    entry->key.hash = key.hash;
+    entry->setLayout = setLayout;
+    entry->set = set;
+    entry->pool = pool;
+    entry->lastUsedFrame = AstralCanvasVk_GetFrameNumber();
+
+    AstralCanvasVk_DescriptorPoolMutex.EnterLock();
+    if (AstralCanvasVk_CachedDescriptorSets.Contains(entry->key))
+    {
+        //another thread wrote the same combination first. The caller still binds its own set this frame, so it
+        //is released like an evicted one
+        AstralCanvasVkEvictedDescriptorSet evicted;
+        evicted.set = set;
+        evicted.pool = pool;
+        evicted.lastUsedFrame = entry->lastUsedFrame;
+        AstralCanvasVk_EvictedDescriptorSets.Add(evicted);
+
+        AstralCanvasVk_DescriptorCacheAllocator.Free(entry->key.data);
+        AstralCanvasVk_DescriptorCacheAllocator.Free(entry);
+    }
+    else
+    {
+        AstralCanvasVk_CachedDescriptorSets.Add(entry->key, entry);
+        AstralCanvasVk_CachedDescriptorSetList.Add(entry);
+    }
+    AstralCanvasVk_DescriptorPoolMutex.ExitLock();
+}
+void AstralCanvasVk_EvictCachedDescriptorSets(VkDescriptorSetLayout setLayout)
+{
+    if (!AstralCanvasVk_DescriptorCacheCreated)
+    {
+        return;
+    }
+    AstralCanvasVk_DescriptorPoolMutex.EnterLock();
+    usize i = 0;
+    while (i < AstralCanvasVk_CachedDescriptorSetList.count)
+    {
+        if (AstralCanvasVk_CachedDescriptorSetList.ptr[i]->setLayout == setLayout)
+        {
+            AstralCanvasVk_EvictCachedDescriptorSetAt(i);
+        }
+        else
+        {
+            i += 1;
+        }
+    }
+    AstralCanvasVk_DescriptorPoolMutex.ExitLock();
+}
+void AstralCanvasVk_EvictDescriptorSetsReferencing(u64 handle)
+{
+    if (!AstralCanvasVk_DescriptorCacheCreated)
+    {
+        return;
+    }
+    AstralCanvasVk_DescriptorPoolMutex.EnterLock();
+    usize i = 0;
+    while (i < AstralCanvasVk_CachedDescriptorSetList.count)
+    {
+        AstralCanvasVkDescriptorSetKey *key = &AstralCanvasVk_CachedDescriptorSetList.ptr[i]->key;
+        bool references = false;
+        //keys are whole words, so a handle can only ever sit at a word boundary. Bindings and ranges that happen
+        //to equal the handle only cause a set to be written again
+        for (usize offset = 0; offset + sizeof(u64) <= key->size; offset += sizeof(u64))
+        {
+            u64 word;
+            memcpy(&word, key->data + offset, sizeof(u64));
+            if (word == handle)
+            {
+                references = true;
+                break;
+            }
+        }
+        if (references)
+        {
+            AstralCanvasVk_EvictCachedDescriptorSetAt(i);
+        }
+        else
+        {
+            i += 1;
+        }
+    }
+    AstralCanvasVk_DescriptorPoolMutex.ExitLock();
+}
+#endif
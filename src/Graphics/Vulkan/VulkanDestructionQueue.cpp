@@ -0,0 +1,212 @@
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanDestructionQueue.hpp"
+#include "Graphics/Vulkan/VulkanInstanceData.hpp"
+#include "Graphics/Vulkan/VulkanHelpers.hpp"
+#include "Graphics/Vulkan/VulkanDescriptors.hpp"
+#include "vector.hpp"
+#include "threading.hpp"
+
+enum AstralCanvasVkDestroyableType
+{
+    AstralCanvasVkDestroyable_Buffer,
+    AstralCanvasVkDestroyable_Image,
+    AstralCanvasVkDestroyable_ImageView,
+    AstralCanvasVkDestroyable_Sampler,
+    AstralCanvasVkDestroyable_Framebuffer,
+    AstralCanvasVkDestroyable_Pipeline,
+    AstralCanvasVkDestroyable_PipelineLayout,
+    AstralCanvasVkDestroyable_RenderPass,
+    AstralCanvasVkDestroyable_DescriptorSetLayout,
+    AstralCanvasVkDestroyable_CommandPool,
+    AstralCanvasVkDestroyable_Memory
+};
+struct AstralCanvasVkPendingDestruction
+{
+    AstralCanvasVkDestroyableType type;
+    void *handle;
+    bool ownsMemory;
+    AstralCanvas::GPUMemoryKind memoryKind;
+    AstralCanvas::MemoryAllocation memory;
+    u64 releasedOnFrame;
+};
+
+/// Pending destructions in release order
+collections::vector<AstralCanvasVkPendingDestruction> AstralCanvasVk_PendingDestructions;
+bool AstralCanvasVk_DestructionQueueCreated = false;
+threading::Mutex AstralCanvasVk_DestructionQueueMutex;
+
+bool AstralCanvasVk_CreateDestructionQueue(IAllocator allocator)
+{
+    AstralCanvasVk_DestructionQueueMutex = threading::Mutex::init();
+    AstralCanvasVk_PendingDestructions = collections::vector<AstralCanvasVkPendingDestruction>(allocator);
+    AstralCanvasVk_DestructionQueueCreated = true;
+    return true;
+}
+
+void AstralCanvasVk_Destroy(AstralVulkanGPU *gpu, AstralCanvasVkPendingDestruction *pending)
+{
+    switch (pending->type)
+    {
+        case AstralCanvasVkDestroyable_Buffer:
+            vkDestroyBuffer(gpu->logicalDevice, (VkBuffer)pending->handle, NULL);
+            AstralCanvasVk_EvictDescriptorSetsReferencing((u64)pending->handle);
+            break;
+        case AstralCanvasVkDestroyable_Image:
+            vkDestroyImage(gpu->logicalDevice, (VkImage)pending->handle, NULL);
+            break;
+        case AstralCanvasVkDestroyable_ImageView:
+            vkDestroyImageView(gpu->logicalDevice, (VkImageView)pending->handle, NULL);
+            AstralCanvasVk_EvictDescriptorSetsReferencing((u64)pending->handle);
+            break;
+        case AstralCanvasVkDestroyable_Sampler:
+            vkDestroySampler(gpu->logicalDevice, (VkSampler)pending->handle, NULL);
+            AstralCanvasVk_EvictDescriptorSetsReferencing((u64)pending->handle);
+            break;
+        case AstralCanvasVkDestroyable_Framebuffer:
+            vkDestroyFramebuffer(gpu->logicalDevice, (VkFramebuffer)pending->handle, NULL);
+            break;
+        case AstralCanvasVkDestroyable_Pipeline:
+            vkDestroyPipeline(gpu->logicalDevice, (VkPipeline)pending->handle, NULL);
+            break;
+        case AstralCanvasVkDestroyable_PipelineLayout:
+            vkDestroyPipelineLayout(gpu->logicalDevice, (VkPipelineLayout)pending->handle, NULL);
+            break;
+        case AstralCanvasVkDestroyable_RenderPass:
+            vkDestroyRenderPass(gpu->logicalDevice, (VkRenderPass)pending->handle, NULL);
+            break;
+        case AstralCanvasVkDestroyable_DescriptorSetLayout:
+            vkDestroyDescriptorSetLayout(gpu->logicalDevice, (VkDescriptorSetLayout)pending->handle, NULL);
+            break;
+        case AstralCanvasVkDestroyable_CommandPool:
+            vkDestroyCommandPool(gpu->logicalDevice, (VkCommandPool)pending->handle, NULL);
+            break;
+        case AstralCanvasVkDestroyable_Memory:
+            break;
+    }
+    if (pending->ownsMemory)
+    {
+        AstralCanvasVk_FreeMemory(pending->memoryKind, &pending->memory);
+    }
+}
+
+void AstralCanvasVk_QueueDestruction(AstralCanvasVkDestroyableType type, void *handle, AstralCanvas::GPUMemoryKind kind, AstralCanvas::MemoryAllocation *memory)
+{
+    AstralCanvasVkPendingDestruction pending{};
+    pending.type = type;
+    pending.handle = handle;
+    pending.ownsMemory = memory != NULL && memory->vkAllocation != NULL;
+    pending.memoryKind = kind;
+    if (pending.ownsMemory)
+    {
+        pending.memory = *memory;
+    }
+    pending.releasedOnFrame = AstralCanvasVk_GetFrameNumber();
+
+    if (!AstralCanvasVk_DestructionQueueCreated)
+    {
+        //nothing can be in flight without the backend running
+        AstralCanvasVk_Destroy(AstralCanvasVk_GetCurrentGPU(), &pending);
+        return;
+    }
+    AstralCanvasVk_DestructionQueueMutex.EnterLock();
+    AstralCanvasVk_PendingDestructions.Add(pending);
+    AstralCanvasVk_DestructionQueueMutex.ExitLock();
+}
+void AstralCanvasVk_QueueDestroyBuffer(VkBuffer buffer, AstralCanvas::GPUMemoryKind kind, AstralCanvas::MemoryAllocation *memory)
+{
+    AstralCanvasVk_QueueDestruction(AstralCanvasVkDestroyable_Buffer, (void *)buffer, kind, memory);
+}
+void AstralCanvasVk_QueueDestroyImage(VkImage image, AstralCanvas::GPUMemoryKind kind, AstralCanvas::MemoryAllocation *memory)
+{
+    AstralCanvasVk_QueueDestruction(AstralCanvasVkDestroyable_Image, (void *)image, kind, memory);
+}
+void AstralCanvasVk_QueueDestroyImageView(VkImageView imageView)
+{
+    AstralCanvasVk_QueueDestruction(AstralCanvasVkDestroyable_ImageView, (void *)imageView, AstralCanvas::GPUMemoryKind_Texture, NULL);
+}
+void AstralCanvasVk_QueueDestroySampler(VkSampler sampler)
+{
+    AstralCanvasVk_QueueDestruction(AstralCanvasVkDestroyable_Sampler, (void *)sampler, AstralCanvas::GPUMemoryKind_Texture, NULL);
+}
+void AstralCanvasVk_QueueDestroyFramebuffer(VkFramebuffer framebuffer)
+{
+    AstralCanvasVk_QueueDestruction(AstralCanvasVkDestroyable_Framebuffer, (void *)framebuffer, AstralCanvas::GPUMemoryKind_Texture, NULL);
+}
+void AstralCanvasVk_QueueDestroyPipeline(VkPipeline pipeline)
+{
+    AstralCanvasVk_QueueDestruction(AstralCanvasVkDestroyable_Pipeline, (void *)pipeline, AstralCanvas::GPUMemoryKind_Texture, NULL);
+}
+void AstralCanvasVk_QueueDestroyPipelineLayout(VkPipelineLayout layout)
+{
+    AstralCanvasVk_QueueDestruction(AstralCanvasVkDestroyable_PipelineLayout, (void *)layout, AstralCanvas::GPUMemoryKind_Texture, NULL);
+}
+void AstralCanvasVk_QueueDestroyRenderPass(VkRenderPass renderPass)
+{
+    AstralCanvasVk_QueueDestruction(AstralCanvasVkDestroyable_RenderPass, (void *)renderPass, AstralCanvas::GPUMemoryKind_Texture, NULL);
+}
+void AstralCanvasVk_QueueDestroyDescriptorSetLayout(VkDescriptorSetLayout setLayout)
+{
+    AstralCanvasVk_QueueDestruction(AstralCanvasVkDestroyable_DescriptorSetLayout, (void *)setLayout, AstralCanvas::GPUMemoryKind_Texture, NULL);
+}
+void AstralCanvasVk_QueueDestroyCommandPool(VkCommandPool commandPool)
+{
+    AstralCanvasVk_QueueDestruction(AstralCanvasVkDestroyable_CommandPool, (void *)commandPool, AstralCanvas::GPUMemoryKind_Texture, NULL);
+}
+void AstralCanvasVk_QueueFreeMemory(AstralCanvas::GPUMemoryKind kind, AstralCanvas::MemoryAllocation *memory)
+{
+    AstralCanvasVk_QueueDestruction(AstralCanvasVkDestroyable_Memory, NULL, kind, memory);
+}
+
+/// Destroys pending destructions released on or before lastRetiredFrame, or all of them if flushAll is set
+void AstralCanvasVk_DestroyRetired(AstralVulkanGPU *gpu, u64 lastRetiredFrame, bool flushAll)
+{
+    AstralCanvasVk_DestructionQueueMutex.EnterLock();
+    //pending destructions are in release order, so stop at the first one that may still be in use
+    usize retired = 0;
+    while (retired < AstralCanvasVk_PendingDestructions.count && (flushAll || AstralCanvasVk_PendingDestructions.ptr[retired].releasedOnFrame <= lastRetiredFrame))
+    {
+        AstralCanvasVk_Destroy(gpu, &AstralCanvasVk_PendingDestructions.ptr[retired]);
+        retired += 1;
+    }
+    if (retired > 0)
+    {
+        usize remaining = AstralCanvasVk_PendingDestructions.count - retired;
+        for (usize i = 0; i < remaining; i++)
+        {
+            AstralCanvasVk_PendingDestructions.ptr[i] = AstralCanvasVk_PendingDestructions.ptr[i + retired];
+        }
+        AstralCanvasVk_PendingDestructions.count = remaining;
+    }
+    AstralCanvasVk_DestructionQueueMutex.ExitLock();
+}
+void AstralCanvasVk_RetireDestructions(AstralVulkanGPU *gpu)
+{
+    //once the fence of this slot has been waited on, every frame up to framesInFlight behind the current one has finished
+    u64 frameNumber = AstralCanvasVk_GetFrameNumber();
+    u64 framesInFlight = AstralCanvasVk_GetFramesInFlight();
+    if (frameNumber < framesInFlight)
+    {
+        return;
+    }
+    AstralCanvasVk_DestroyRetired(gpu, frameNumber - framesInFlight, false);
+}
+void AstralCanvasVk_FlushDestructions(AstralVulkanGPU *gpu)
+{
+    if (!AstralCanvasVk_DestructionQueueCreated)
+    {
+        return;
+    }
+    AstralCanvasVk_DestroyRetired(gpu, 0, true);
+}
+void AstralCanvasVk_DestroyDestructionQueue(AstralVulkanGPU *gpu)
+{
+    if (!AstralCanvasVk_DestructionQueueCreated)
+    {
+        return;
+    }
+    AstralCanvasVk_DestroyRetired(gpu, 0, true);
+    AstralCanvasVk_PendingDestructions.deinit();
+    AstralCanvasVk_DestructionQueueCreated = false;
+    AstralCanvasVk_DestructionQueueMutex.deinit();
+}
+#endif
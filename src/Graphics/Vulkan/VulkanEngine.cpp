@@ -3,6 +3,14 @@
 #include <Graphics/Vulkan/VulkanInstanceData.hpp>
 #include "Graphics/Vulkan/vk_mem_alloc.h"
 #include "Graphics/SamplerState.hpp"
+#include "Graphics/Vulkan/VulkanStaging.hpp"
+#include "Graphics/Vulkan/VulkanPipelineCache.hpp"
+#include "Graphics/Vulkan/VulkanPipelineRegistry.hpp"
+#include "Graphics/Vulkan/VulkanDescriptors.hpp"
+#include "Graphics/Vulkan/VulkanUniformArena.hpp"
+#include "Graphics/Vulkan/VulkanBindless.hpp"
+#include "Graphics/Vulkan/VulkanMemoryStatistics.hpp"
+#include "Graphics/Vulkan/VulkanDestructionQueue.hpp"
 
 using namespace collections;
 
@@ -98,6 +106,10 @@ bool AstralCanvasVk_InitializeFor(IAllocator allocator, Array<const char*> valid
 		allocatorCreateInfo.pDeviceMemoryCallbacks = NULL;
 		allocatorCreateInfo.vulkanApiVersion = VK_API_VERSION_1_3;
 		allocatorCreateInfo.pVulkanFunctions = &vulkanAllocatorFunctions;
+		if (gpu.supportsMemoryBudget)
+		{
+			allocatorCreateInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+		}
 
 		if (vmaCreateAllocator(&allocatorCreateInfo, &vulkanAllocator) != VK_SUCCESS)
 		{
@@ -106,6 +118,28 @@ bool AstralCanvasVk_InitializeFor(IAllocator allocator, Array<const char*> valid
 		}
 		AstralCanvasVk_SetCurrentVulkanAllocator(vulkanAllocator);
 		LOG_WARNING("Created memory allocator");
+		AstralCanvasVk_CreateMemoryStatistics();
+		AstralCanvasVk_CreateDestructionQueue(allocator);
+
+		if (!AstralCanvasVk_CreateStagingRing(AstralCanvasVk_GetCurrentGPU(), ASTRALVULKAN_STAGING_RING_SIZE))
+		{
+			LOG_WARNING("Failed to create staging ring");
+			return false;
+		}
+		LOG_WARNING("Created staging ring");
+
+		if (!AstralCanvasVk_CreatePipelineCache(AstralCanvasVk_GetCurrentGPU()))
+		{
+			LOG_WARNING("Failed to create pipeline cache");
+			return false;
+		}
+		LOG_WARNING("Created pipeline cache");
+
+		if (!AstralCanvasVk_CreatePipelineRegistry(allocator))
+		{
+			LOG_WARNING("Failed to create pipeline registry");
+			return false;
+		}
 
 		window->swapchain = malloc(sizeof(AstralVulkanSwapchain));
 		if (!AstralCanvasVk_CreateSwapchain(allocator, AstralCanvasVk_GetCurrentGPU(), window, (AstralVulkanSwapchain *)window->swapchain))
@@ -120,70 +154,77 @@ bool AstralCanvasVk_InitializeFor(IAllocator allocator, Array<const char*> valid
 		semaphoreCreateInfo.flags = 0;
 		semaphoreCreateInfo.pNext = NULL;
 
-		VkSemaphore awaitPresentCompleteSemaphore;
-		vkCreateSemaphore(AstralCanvasVk_GetCurrentGPU()->logicalDevice, &semaphoreCreateInfo, NULL, &awaitPresentCompleteSemaphore);
-
-		AstralCanvasVk_SetAwaitPresentCompleteSemaphore(awaitPresentCompleteSemaphore);
-
-		VkSemaphore awaitRenderCompleteSemaphore;
-		vkCreateSemaphore(AstralCanvasVk_GetCurrentGPU()->logicalDevice, &semaphoreCreateInfo, NULL, &awaitRenderCompleteSemaphore);
+		//created signalled so that the first wait on each frame does not block
+		VkFenceCreateInfo fenceCreateInfo{};
+		fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-		AstralCanvasVk_SetAwaitRenderCompleteSemaphore(awaitRenderCompleteSemaphore);
-
-		//main rendering command pool (Non transient)
-		VkCommandPool mainCmdPool;
+		//main rendering command pools (Non transient), one per frame in flight
 		VkCommandPoolCreateInfo cmdPoolCreateInfo{};
 		cmdPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
 		cmdPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 		cmdPoolCreateInfo.queueFamilyIndex = AstralCanvasVk_GetCurrentGPU()->queueInfo.dedicatedGraphicsQueueIndex;
-		if (vkCreateCommandPool(AstralCanvasVk_GetCurrentGPU()->logicalDevice, &cmdPoolCreateInfo, NULL, &mainCmdPool) != VK_SUCCESS)
+
+		for (u32 i = 0; i < AstralCanvasVk_GetFramesInFlight(); i++)
 		{
-			LOG_WARNING("Failed to create main command pool");
+			AstralCanvasVkFrameData *frame = AstralCanvasVk_GetFrameData(i);
+
+			if (vkCreateSemaphore(gpu.logicalDevice, &semaphoreCreateInfo, NULL, &frame->awaitPresentCompleteSemaphore) != VK_SUCCESS)
+			{
+				LOG_WARNING("Failed to create present semaphore");
+				return false;
+			}
+			if (vkCreateSemaphore(gpu.logicalDevice, &semaphoreCreateInfo, NULL, &frame->awaitRenderCompleteSemaphore) != VK_SUCCESS)
+			{
+				LOG_WARNING("Failed to create render semaphore");
+				return false;
+			}
+			if (vkCreateFence(gpu.logicalDevice, &fenceCreateInfo, NULL, &frame->frameFence) != VK_SUCCESS)
+			{
+				LOG_WARNING("Failed to create frame fence");
+				return false;
+			}
+			if (vkCreateCommandPool(gpu.logicalDevice, &cmdPoolCreateInfo, NULL, &frame->commandPool) != VK_SUCCESS)
+			{
+				LOG_WARNING("Failed to create main command pool");
+				return false;
+			}
+
+			//main command buffer (Non transient)
+			VkCommandBufferAllocateInfo cmdBufferInfo{};
+			cmdBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			cmdBufferInfo.commandPool = frame->commandPool;
+			cmdBufferInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			cmdBufferInfo.commandBufferCount = 1;
+			if (vkAllocateCommandBuffers(gpu.logicalDevice, &cmdBufferInfo, &frame->commandBuffer) != VK_SUCCESS)
+			{
+				LOG_WARNING("Failed to create main command buffer");
+				return false;
+			}
 		}
-		LOG_WARNING("Created main command pool");
-
-		AstralCanvasVk_SetMainCmdPool(mainCmdPool);
-
-		//main command buffer (Non transient)
-		VkCommandBuffer mainCmdBuffer;
-		VkCommandBufferAllocateInfo cmdBufferInfo{};
-		cmdBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-		cmdBufferInfo.commandPool = mainCmdPool;
-		cmdBufferInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-		cmdBufferInfo.commandBufferCount = 1;
-		if (vkAllocateCommandBuffers(AstralCanvasVk_GetCurrentGPU()->logicalDevice, &cmdBufferInfo, &mainCmdBuffer) != VK_SUCCESS)
+		AstralCanvasVk_SetCurrentFrame(0);
+		LOG_WARNING("Created per-frame command buffers and sync objects");
+
+		if (!AstralCanvasVk_CreateDescriptorPools(AstralCanvasVk_GetCurrentGPU(), allocator))
 		{
-			LOG_WARNING("Failed to create main command buffer");
+			LOG_WARNING("Failed to create shader uniform descriptor pools");
+			return false;
 		}
-		LOG_WARNING("Created main command buffer");
-
-		AstralCanvasVk_SetMainCmdBuffer(mainCmdBuffer);
-
-		u32 maxUniformDescriptors = ASTRALVULKAN_MAX_DESCRIPTOR_SETS;
-		VkDescriptorPoolSize poolSizes[4];
-		poolSizes[0].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-		poolSizes[0].descriptorCount = maxUniformDescriptors;
-		poolSizes[1].type = VK_DESCRIPTOR_TYPE_SAMPLER;
-		poolSizes[1].descriptorCount = maxUniformDescriptors;
-		poolSizes[2].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		poolSizes[2].descriptorCount = maxUniformDescriptors;
-		poolSizes[3].type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
-		poolSizes[3].descriptorCount = maxUniformDescriptors;
-
-		VkDescriptorPoolCreateInfo poolCreateInfo{};
-		poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-		poolCreateInfo.pPoolSizes = poolSizes;
-		poolCreateInfo.poolSizeCount = 4;
-		poolCreateInfo.maxSets = maxUniformDescriptors;
-
-		VkDescriptorPool mainPool;
-		if (vkCreateDescriptorPool(gpu.logicalDevice, &poolCreateInfo, NULL, &mainPool) != VK_SUCCESS)
+		LOG_WARNING("Created shader uniform descriptor pools");
+
+		if (!AstralCanvasVk_CreateUniformArenas(AstralCanvasVk_GetCurrentGPU(), allocator))
 		{
-			LOG_WARNING("Failed to create shader uniform descriptor pool");
+			LOG_WARNING("Failed to create shader uniform arenas");
+			return false;
 		}
-		LOG_WARNING("Created shader uniform descriptor pool");
+		LOG_WARNING("Created shader uniform arenas");
 
-		AstralCanvasVk_SetDescriptorPool(mainPool);
+		if (!AstralCanvasVk_CreateBindlessHeap(AstralCanvasVk_GetCurrentGPU(), allocator))
+		{
+			LOG_WARNING("Failed to create bindless heap");
+			return false;
+		}
+		LOG_WARNING("Created bindless heap");
 
 		window->justResized = &onResized;
 
@@ -293,7 +334,16 @@ bool AstralCanvasVk_CreateDebugMessenger()
 
 void AstralCanvasVk_AwaitShutdown()
 {
-	vkQueueWaitIdle(AstralCanvasVk_GetCurrentGPU()->DedicatedGraphicsQueue.queue);
+	AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
+	for (u32 i = 0; i < AstralCanvasVk_GetFramesInFlight(); i++)
+	{
+		VkFence frameFence = AstralCanvasVk_GetFrameData(i)->frameFence;
+		if (frameFence != NULL)
+		{
+			vkWaitForFences(gpu->logicalDevice, 1, &frameFence, true, UINT64_MAX);
+		}
+	}
+	vkQueueWaitIdle(gpu->DedicatedGraphicsQueue.queue);
 }
 void AstralCanvasVk_Deinitialize(IAllocator allocator, AstralCanvas::Window* windows, u32 windowCount)
 {
@@ -301,27 +351,34 @@ void AstralCanvasVk_Deinitialize(IAllocator allocator, AstralCanvas::Window* win
 	AstralCanvas::DestroyDefaultSamplerStates();
 	//vkWaitForFences(gpu->logicalDevice, 1, &gpu->DedicatedGraphicsQueue.queueFence, true, UINT64_MAX);
 
-	VkDescriptorPool mainDescriptorPool = AstralCanvasVk_GetDescriptorPool();
-	if (mainDescriptorPool != NULL)
-	{
-		vkDestroyDescriptorPool(gpu->logicalDevice, mainDescriptorPool, NULL);
-	}
-
-	VkCommandPool mainCommandPool = AstralCanvasVk_GetMainCmdPool();
-	if (mainCommandPool != NULL)
-	{
-		vkDestroyCommandPool(gpu->logicalDevice, mainCommandPool, NULL);
-	}
+	AstralCanvasVk_DestroyDescriptorPools(gpu);
+	AstralCanvasVk_DestroyUniformArenas(gpu);
+	AstralCanvasVk_DestroyBindlessHeap(gpu);
 
-	VkSemaphore semaphore = AstralCanvasVk_GetAwaitRenderCompleteSemaphore();
-	if (semaphore != NULL)
+	for (u32 i = 0; i < AstralCanvasVk_GetFramesInFlight(); i++)
 	{
-		vkDestroySemaphore(gpu->logicalDevice, semaphore, NULL);
-	}
-	semaphore = AstralCanvasVk_GetAwaitPresentCompleteSemaphore();
-	if (semaphore != NULL)
-	{
-		vkDestroySemaphore(gpu->logicalDevice, semaphore, NULL);
+		AstralCanvasVkFrameData *frame = AstralCanvasVk_GetFrameData(i);
+		if (frame->commandPool != NULL)
+		{
+			vkDestroyCommandPool(gpu->logicalDevice, frame->commandPool, NULL);
+			frame->commandPool = NULL;
+			frame->commandBuffer = NULL;
+		}
+		if (frame->frameFence != NULL)
+		{
+			vkDestroyFence(gpu->logicalDevice, frame->frameFence, NULL);
+			frame->frameFence = NULL;
+		}
+		if (frame->awaitRenderCompleteSemaphore != NULL)
+		{
+			vkDestroySemaphore(gpu->logicalDevice, frame->awaitRenderCompleteSemaphore, NULL);
+			frame->awaitRenderCompleteSemaphore = NULL;
+		}
+		if (frame->awaitPresentCompleteSemaphore != NULL)
+		{
+			vkDestroySemaphore(gpu->logicalDevice, frame->awaitPresentCompleteSemaphore, NULL);
+			frame->awaitPresentCompleteSemaphore = NULL;
+		}
 	}
 
 	for (usize i = 0; i < windowCount; i++)
@@ -335,10 +392,18 @@ void AstralCanvasVk_Deinitialize(IAllocator allocator, AstralCanvas::Window* win
 		}
 	}
 
+	//everything released by the deinits above, or earlier, is freed now that the device has finished
+	AstralCanvasVk_DestroyDestructionQueue(gpu);
+	AstralCanvasVk_DestroyStagingRing(gpu);
+	AstralCanvasVk_DestroyPipelineRegistry(gpu);
+	AstralCanvasVk_DestroyPipelineCache(gpu);
+
 	VmaAllocator vma = AstralCanvasVk_GetCurrentVulkanAllocator();
 	if (vma != NULL)
 	{
 		vmaDestroyAllocator(vma);
+		AstralCanvasVk_SetCurrentVulkanAllocator(NULL);
+		AstralCanvasVk_DestroyMemoryStatistics();
 	}
 
 	if (gpu != NULL)
@@ -372,15 +437,24 @@ bool AstralCanvasVk_BeginDraw(AstralCanvas::Window *window)
 	AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
 	AstralVulkanSwapchain *swapchain = (AstralVulkanSwapchain *)window->swapchain;
 
-	VkFence toWaitFor = gpu->DedicatedGraphicsQueue.queueFence;
+	AstralCanvasVkFrameData *frame = AstralCanvasVk_GetCurrentFrameData();
+
+	//only wait for the GPU to finish the frame that last used this slot,
+	//the other frames in flight may still be executing
+	VkFence toWaitFor = frame->frameFence;
 	//if (swapchain->presentedPreviousFrame)
 	{
 		vkWaitForFences(gpu->logicalDevice, 1, &toWaitFor, true, UINT64_MAX);
+		//nothing still executing can reference the uniforms allocated the last time this slot was recorded
+		AstralCanvasVk_ResetFrameUniformArena(AstralCanvasVk_GetCurrentFrame());
+		AstralCanvasVk_RetireCachedDescriptorSets(gpu);
+		AstralCanvasVk_RetireDestructions(gpu);
+		AstralCanvasVk_UpdateMemoryBudgets(AstralCanvasVk_GetFrameNumber());
 
 		swapchain->recreatedThisFrame = false;
 
 		swapchain->presentedPreviousFrame = false;
-		if (AstralCanvasVk_SwapchainSwapBuffers(gpu, swapchain, AstralCanvasVk_GetAwaitPresentCompleteSemaphore(), NULL))
+		if (AstralCanvasVk_SwapchainSwapBuffers(gpu, swapchain, frame->awaitPresentCompleteSemaphore, NULL))
 		{
 			swapchain->recreatedThisFrame = true;
 			return false;
@@ -388,7 +462,7 @@ bool AstralCanvasVk_BeginDraw(AstralCanvas::Window *window)
 	}
 	vkResetFences(gpu->logicalDevice, 1, &toWaitFor);
 
-	VkCommandBuffer mainCmdBuffer = AstralCanvasVk_GetMainCmdBuffer();
+	VkCommandBuffer mainCmdBuffer = frame->commandBuffer;
 	vkResetCommandBuffer(mainCmdBuffer, 0);
 
 	VkCommandBufferBeginInfo beginInfo{};
@@ -404,13 +478,18 @@ bool AstralCanvasVk_BeginDraw(AstralCanvas::Window *window)
 }
 void AstralCanvasVk_EndDraw(AstralCanvas::Window *window)
 {
+	AstralCanvasVkFrameData *frame = AstralCanvasVk_GetCurrentFrameData();
+
+	//uploads made during this frame have to be submitted ahead of the frame that uses them
+	AstralCanvasVk_FlushStaging(AstralCanvasVk_GetCurrentGPU());
+
 	//submit to GPU
-	vkEndCommandBuffer(AstralCanvasVk_GetMainCmdBuffer());
+	vkEndCommandBuffer(frame->commandBuffer);
 
-	VkSemaphore awaitPresentComplete = AstralCanvasVk_GetAwaitPresentCompleteSemaphore();
-	VkSemaphore awaitRenderComplete = AstralCanvasVk_GetAwaitRenderCompleteSemaphore();
+	VkSemaphore awaitPresentComplete = frame->awaitPresentCompleteSemaphore;
+	VkSemaphore awaitRenderComplete = frame->awaitRenderCompleteSemaphore;
 	VkPipelineStageFlags waitFlags = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-	VkCommandBuffer mainCmdBuffer = AstralCanvasVk_GetMainCmdBuffer();
+	VkCommandBuffer mainCmdBuffer = frame->commandBuffer;
 
 	AstralVulkanSwapchain *swapchain = (AstralVulkanSwapchain *)window->swapchain;
 
@@ -428,7 +507,7 @@ void AstralCanvasVk_EndDraw(AstralCanvas::Window *window)
 
 		AstralVulkanGPU *gpu = AstralCanvasVk_GetCurrentGPU();
 		gpu->DedicatedGraphicsQueue.queueMutex.EnterLock();
-		if (vkQueueSubmit(gpu->DedicatedGraphicsQueue.queue, 1, &submitInfo, gpu->DedicatedGraphicsQueue.queueFence) != VK_SUCCESS)
+		if (vkQueueSubmit(gpu->DedicatedGraphicsQueue.queue, 1, &submitInfo, frame->frameFence) != VK_SUCCESS)
 		{
 			THROW_ERR("Error submitting vulkan queue");
 		}
@@ -471,5 +550,7 @@ void AstralCanvasVk_EndDraw(AstralCanvas::Window *window)
 			THROW_ERR("Error presenting queue");
 		}
 	}
+
+	AstralCanvasVk_AdvanceFrame();
 }
 #endif
@@ -1,6 +1,7 @@
 #ifdef ASTRALCANVAS_VULKAN
 #include "Graphics/Vulkan/VulkanGPU.hpp"
 #include <Graphics/Vulkan/VulkanSwapchainSupportDetails.hpp>
+#include <string.h>
 
 using namespace collections;
 
@@ -127,6 +128,29 @@ bool AstralCanvasVk_GPUExtensionsSupported(AstralVulkanGPU *gpu)
 	properties.deinit();
 	return totalSupported == gpu->requiredExtensions.length;
 }
+bool AstralCanvasVk_GPUSupportsExtension(AstralVulkanGPU *gpu, const char *extensionName)
+{
+	IAllocator cAllocator = GetCAllocator();
+
+	u32 supportedExtensionsCount = 0;
+	vkEnumerateDeviceExtensionProperties(gpu->physicalDevice, NULL, &supportedExtensionsCount, NULL);
+
+	Array<VkExtensionProperties> properties = Array<VkExtensionProperties>(cAllocator, supportedExtensionsCount);
+	vkEnumerateDeviceExtensionProperties(gpu->physicalDevice, NULL, &supportedExtensionsCount, properties.data);
+
+	bool result = false;
+	for (usize i = 0; i < supportedExtensionsCount; i++)
+	{
+		if (strcmp(properties.data[i].extensionName, extensionName) == 0)
+		{
+			result = true;
+			break;
+		}
+	}
+
+	properties.deinit();
+	return result;
+}
 
 bool AstralCanvasVk_CreateLogicalDevice(AstralVulkanGPU* gpu, IAllocator allocator)
 {
@@ -161,17 +185,94 @@ bool AstralCanvasVk_CreateLogicalDevice(AstralVulkanGPU* gpu, IAllocator allocat
 		createInfos.Add(createInfo);
 	}
 
+	//optional extensions are appended after the required ones
+	collections::vector<const char *> enabledExtensions = collections::vector<const char *>(allocator);
+	for (usize i = 0; i < gpu->requiredExtensions.length; i++)
+	{
+		enabledExtensions.Add(gpu->requiredExtensions.data[i]);
+	}
+	//lets the allocator report the driver's real budget instead of estimating it from heap sizes
+	gpu->supportsMemoryBudget = AstralCanvasVk_GPUSupportsExtension(gpu, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+	if (gpu->supportsMemoryBudget)
+	{
+		enabledExtensions.Add(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+	}
+
 	VkDeviceCreateInfo deviceCreateInfo = {};
 	deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 	deviceCreateInfo.queueCreateInfoCount = (u32)createInfos.count;
 	deviceCreateInfo.pQueueCreateInfos = createInfos.ptr;
-	deviceCreateInfo.enabledExtensionCount = (u32)gpu->requiredExtensions.length;
-	deviceCreateInfo.ppEnabledExtensionNames = gpu->requiredExtensions.data;
+	deviceCreateInfo.enabledExtensionCount = (u32)enabledExtensions.count;
+	deviceCreateInfo.ppEnabledExtensionNames = enabledExtensions.ptr;
 	deviceCreateInfo.enabledLayerCount = 0;
 	deviceCreateInfo.ppEnabledLayerNames = NULL;
 	deviceCreateInfo.pNext = NULL;
 
-	if (vkCreateDevice(gpu->physicalDevice, &deviceCreateInfo, NULL, &gpu->logicalDevice) != VK_SUCCESS)
+	//optional Vulkan 1.3 features, only enabled where the device supports them
+	VkPhysicalDeviceVulkan13Features supportedFeatures13 = {};
+	supportedFeatures13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+	VkPhysicalDeviceVulkan13Features enabledFeatures13 = {};
+	enabledFeatures13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+	if (gpu->properties.apiVersion >= VK_API_VERSION_1_3)
+	{
+		VkPhysicalDeviceFeatures2 supportedFeatures = {};
+		supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		supportedFeatures.pNext = &supportedFeatures13;
+		vkGetPhysicalDeviceFeatures2(gpu->physicalDevice, &supportedFeatures);
+
+		enabledFeatures13.synchronization2 = supportedFeatures13.synchronization2;
+		enabledFeatures13.dynamicRendering = supportedFeatures13.dynamicRendering;
+		deviceCreateInfo.pNext = &enabledFeatures13;
+	}
+	gpu->supportsSynchronization2 = enabledFeatures13.synchronization2 == VK_TRUE;
+	gpu->supportsDynamicRendering = enabledFeatures13.dynamicRendering == VK_TRUE;
+
+	//descriptor indexing for the bindless heap, all or nothing
+	VkPhysicalDeviceVulkan12Features supportedFeatures12 = {};
+	supportedFeatures12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+	VkPhysicalDeviceVulkan12Features enabledFeatures12 = {};
+	enabledFeatures12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+	if (gpu->properties.apiVersion >= VK_API_VERSION_1_2)
+	{
+		VkPhysicalDeviceFeatures2 supportedFeatures = {};
+		supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		supportedFeatures.pNext = &supportedFeatures12;
+		vkGetPhysicalDeviceFeatures2(gpu->physicalDevice, &supportedFeatures);
+
+		if (supportedFeatures12.descriptorIndexing && supportedFeatures12.runtimeDescriptorArray && supportedFeatures12.descriptorBindingPartiallyBound
+			&& supportedFeatures12.descriptorBindingSampledImageUpdateAfterBind && supportedFeatures12.descriptorBindingUpdateUnusedWhilePending
+			&& supportedFeatures12.shaderSampledImageArrayNonUniformIndexing)
+		{
+			enabledFeatures12.descriptorIndexing = VK_TRUE;
+			enabledFeatures12.runtimeDescriptorArray = VK_TRUE;
+			enabledFeatures12.descriptorBindingPartiallyBound = VK_TRUE;
+			enabledFeatures12.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+			enabledFeatures12.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+			enabledFeatures12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+		}
+		//draw counts written by GPU culling
+		enabledFeatures12.drawIndirectCount = supportedFeatures12.drawIndirectCount;
+
+		if (enabledFeatures12.descriptorIndexing || enabledFeatures12.drawIndirectCount)
+		{
+			enabledFeatures12.pNext = (void *)deviceCreateInfo.pNext;
+			deviceCreateInfo.pNext = &enabledFeatures12;
+		}
+	}
+	gpu->supportsBindless = enabledFeatures12.descriptorIndexing == VK_TRUE;
+	gpu->supportsDrawIndirectCount = enabledFeatures12.drawIndirectCount == VK_TRUE;
+
+	//needed to submit merged draws as a single indirect draw
+	VkPhysicalDeviceFeatures enabledFeatures = {};
+	enabledFeatures.multiDrawIndirect = gpu->features.multiDrawIndirect;
+	enabledFeatures.drawIndirectFirstInstance = gpu->features.drawIndirectFirstInstance;
+	deviceCreateInfo.pEnabledFeatures = &enabledFeatures;
+	gpu->supportsMultiDrawIndirect = enabledFeatures.multiDrawIndirect == VK_TRUE;
+	gpu->supportsDrawIndirectFirstInstance = enabledFeatures.drawIndirectFirstInstance == VK_TRUE;
+
+	VkResult createDeviceResult = vkCreateDevice(gpu->physicalDevice, &deviceCreateInfo, NULL, &gpu->logicalDevice);
+	enabledExtensions.deinit();
+	if (createDeviceResult != VK_SUCCESS)
 	{
 		return false;
 	}
@@ -2,6 +2,8 @@
 #include "Graphics/Vulkan/VulkanHelpers.hpp"
 #include "Graphics/Vulkan/VulkanEnumConverters.hpp"
 #include "Graphics/Vulkan/VulkanGPU.hpp"
+#include "Graphics/Vulkan/VulkanBarriers.hpp"
+#include "Graphics/Vulkan/VulkanStaging.hpp"
 #include "Json.hpp"
 #include "ArenaAllocator.hpp"
 
@@ -25,22 +27,45 @@ VkBuffer AstralCanvasVk_CreateResourceBuffer(AstralVulkanGPU *gpu, usize size, V
 }
 VkCommandBuffer AstralCanvasVk_CreateTransientCommandBuffer(AstralVulkanGPU *gpu, AstralCanvasVkCommandQueue *queueToUse, bool alsoBeginBuffer)
 {
-    VkCommandBufferAllocateInfo allocInfo = {};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandBufferCount = 1;
-    allocInfo.commandPool = queueToUse->transientCommandPool;
-    allocInfo.pNext = NULL;
+    AstralCanvasVk_RetireTransientSubmissions(gpu, queueToUse);
 
-    queueToUse->commandPoolMutex.EnterLock();
+    VkCommandBuffer result = NULL;
 
-    VkCommandBuffer result;
-    if (vkAllocateCommandBuffers(gpu->logicalDevice, &allocInfo, &result) != VK_SUCCESS)
+    //reuse a command buffer from a retired submission if we have one
+    AstralCanvasVkSubmissionTracker *submissions = queueToUse->submissions;
+    submissions->mutex.EnterLock();
+    if (submissions->freeCommandBuffers.count > 0)
     {
-        result = NULL;
+        result = submissions->freeCommandBuffers.ptr[submissions->freeCommandBuffers.count - 1];
+        submissions->freeCommandBuffers.count -= 1;
     }
+    submissions->mutex.ExitLock();
 
-    queueToUse->commandPoolMutex.ExitLock();
+    if (result != NULL)
+    {
+        //the pool the buffer was allocated from must not be used by another thread at the same time
+        queueToUse->commandPoolMutex.EnterLock();
+        vkResetCommandBuffer(result, 0);
+        queueToUse->commandPoolMutex.ExitLock();
+    }
+    else
+    {
+        VkCommandBufferAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+        allocInfo.commandPool = queueToUse->transientCommandPool;
+        allocInfo.pNext = NULL;
+
+        queueToUse->commandPoolMutex.EnterLock();
+
+        if (vkAllocateCommandBuffers(gpu->logicalDevice, &allocInfo, &result) != VK_SUCCESS)
+        {
+            result = NULL;
+        }
+
+        queueToUse->commandPoolMutex.ExitLock();
+    }
 
     if (alsoBeginBuffer && result != NULL)
     {
@@ -54,60 +79,162 @@ VkCommandBuffer AstralCanvasVk_CreateTransientCommandBuffer(AstralVulkanGPU *gpu
     }
     return result;
 }
-void AstralCanvasVk_EndTransientCommandBuffer(AstralVulkanGPU *gpu, AstralCanvasVkCommandQueue *queueToUse, VkCommandBuffer commandBuffer)
+AstralCanvasVkSubmitTicket AstralCanvasVk_SubmitTransientCommandBuffer(AstralVulkanGPU *gpu, AstralCanvasVkCommandQueue *queueToUse, VkCommandBuffer commandBuffer)
 {
     vkEndCommandBuffer(commandBuffer);
 
+    AstralCanvasVkSubmissionTracker *submissions = queueToUse->submissions;
+
+    VkFence fence = NULL;
+    submissions->mutex.EnterLock();
+    if (submissions->freeFences.count > 0)
+    {
+        fence = submissions->freeFences.ptr[submissions->freeFences.count - 1];
+        submissions->freeFences.count -= 1;
+    }
+    submissions->mutex.ExitLock();
+
+    if (fence != NULL)
+    {
+        vkResetFences(gpu->logicalDevice, 1, &fence);
+    }
+    else
+    {
+        VkFenceCreateInfo fenceCreateInfo = {};
+        fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        if (vkCreateFence(gpu->logicalDevice, &fenceCreateInfo, NULL, &fence) != VK_SUCCESS)
+        {
+            THROW_ERR("Failed to create transient submission fence");
+        }
+    }
+
     VkSubmitInfo submitInfo = {};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
 
-    //if we are on the graphics queue, the queue may also be used for presenting
-    //hence, we need to wait for the queue to finish presenting before we can transition the image
-    if (gpu->DedicatedGraphicsQueue.queue == queueToUse->queue)
+    //tickets are handed out and recorded while holding the queue lock
+    //so that their order matches the order the queue executes them in
+    queueToUse->queueMutex.EnterLock();
+
+    if (vkQueueSubmit(queueToUse->queue, 1, &submitInfo, fence) != VK_SUCCESS)
     {
-        queueToUse->queueMutex.EnterLock();
+        queueToUse->queueMutex.ExitLock();
+        THROW_ERR("Failed to submit queue");
+    }
 
-        vkQueueWaitIdle(queueToUse->queue);
-        //alternatively, wait for queue fence
-        //vkWaitForFences(gpu->logicalDevice, 1, &queueToUse->queueFence, true, UINT64_MAX);
-        //vkResetFences(gpu->logicalDevice, 1, &queueToUse->queueFence);
+    submissions->mutex.EnterLock();
+    AstralCanvasVkPendingSubmission pending;
+    pending.ticket = submissions->nextTicket;
+    pending.fence = fence;
+    pending.commandBuffer = commandBuffer;
+    pending.waiters = 0;
+    submissions->nextTicket += 1;
+    submissions->pending.Add(pending);
+    submissions->mutex.ExitLock();
 
-        queueToUse->queueMutex.ExitLock();
+    queueToUse->queueMutex.ExitLock();
+
+    return pending.ticket;
+}
+void AstralCanvasVk_RetireTransientSubmissions(AstralVulkanGPU *gpu, AstralCanvasVkCommandQueue *queueToUse)
+{
+    AstralCanvasVkSubmissionTracker *submissions = queueToUse->submissions;
+
+    submissions->mutex.EnterLock();
+    for (usize i = submissions->pending.count; i > 0; i--)
+    {
+        AstralCanvasVkPendingSubmission pending = submissions->pending.ptr[i - 1];
+        if (pending.waiters == 0 && vkGetFenceStatus(gpu->logicalDevice, pending.fence) == VK_SUCCESS)
+        {
+            //left signalled until it is reused, so a late waiter on this ticket cannot block forever
+            submissions->freeFences.Add(pending.fence);
+            submissions->freeCommandBuffers.Add(pending.commandBuffer);
+            submissions->pending.RemoveAt_Swap(i - 1);
+        }
     }
+    submissions->mutex.ExitLock();
+}
+bool AstralCanvasVk_TransientSubmissionCompleted(AstralVulkanGPU *gpu, AstralCanvasVkCommandQueue *queueToUse, AstralCanvasVkSubmitTicket ticket)
+{
+    AstralCanvasVk_RetireTransientSubmissions(gpu, queueToUse);
 
-    //submit the queue
-    queueToUse->queueMutex.EnterLock();
+    AstralCanvasVkSubmissionTracker *submissions = queueToUse->submissions;
+    bool result = true;
 
-    if (vkQueueSubmit(queueToUse->queue, 1, &submitInfo, NULL) != VK_SUCCESS)
+    submissions->mutex.EnterLock();
+    for (usize i = 0; i < submissions->pending.count; i++)
     {
-        queueToUse->queueMutex.ExitLock();
-        THROW_ERR("Failed to submit queue");
+        if (submissions->pending.ptr[i].ticket == ticket)
+        {
+            result = false;
+            break;
+        }
     }
-    //todo: see if can transfer this to a fence or something
-    //vkWaitForFences(gpu->logicalDevice, 1, &queueToUse->queueFence, true, UINT64_MAX);
-    //vkResetFences(gpu->logicalDevice, 1, &queueToUse->queueFence);
-    vkQueueWaitIdle(queueToUse->queue);
+    submissions->mutex.ExitLock();
 
-    queueToUse->queueMutex.ExitLock();
+    return result;
+}
+void AstralCanvasVk_AwaitTransientSubmission(AstralVulkanGPU *gpu, AstralCanvasVkCommandQueue *queueToUse, AstralCanvasVkSubmitTicket ticket)
+{
+    AstralCanvasVkSubmissionTracker *submissions = queueToUse->submissions;
 
-    //finally, free the command buffer
-    queueToUse->commandPoolMutex.EnterLock();
+    VkFence toWaitFor = NULL;
+    submissions->mutex.EnterLock();
+    for (usize i = 0; i < submissions->pending.count; i++)
+    {
+        if (submissions->pending.ptr[i].ticket == ticket)
+        {
+            //pinned until the wait returns, otherwise another thread could retire it and reuse the fence meanwhile
+            toWaitFor = submissions->pending.ptr[i].fence;
+            submissions->pending.ptr[i].waiters += 1;
+            break;
+        }
+    }
+    submissions->mutex.ExitLock();
 
-    vkFreeCommandBuffers(gpu->logicalDevice, queueToUse->transientCommandPool, 1, &commandBuffer);
+    //not pending means it has already been retired
+    if (toWaitFor != NULL)
+    {
+        vkWaitForFences(gpu->logicalDevice, 1, &toWaitFor, true, UINT64_MAX);
 
-    queueToUse->commandPoolMutex.ExitLock();
+        //retiring moves entries around, so the submission has to be found again
+        submissions->mutex.EnterLock();
+        for (usize i = 0; i < submissions->pending.count; i++)
+        {
+            if (submissions->pending.ptr[i].ticket == ticket)
+            {
+                submissions->pending.ptr[i].waiters -= 1;
+                break;
+            }
+        }
+        submissions->mutex.ExitLock();
+
+        AstralCanvasVk_RetireTransientSubmissions(gpu, queueToUse);
+    }
+}
+void AstralCanvasVk_EndTransientCommandBuffer(AstralVulkanGPU *gpu, AstralCanvasVkCommandQueue *queueToUse, VkCommandBuffer commandBuffer)
+{
+    //only waits on this submission's fence rather than idling the whole queue
+    AstralCanvasVkSubmitTicket ticket = AstralCanvasVk_SubmitTransientCommandBuffer(gpu, queueToUse, commandBuffer);
+    AstralCanvasVk_AwaitTransientSubmission(gpu, queueToUse, ticket);
 }
 
 void AstralCanvasVk_TransitionTextureLayouts(AstralVulkanGPU *gpu, AstralCanvasVkTextureToTransition* textures, usize numTextures)
 {
+    //the textures may still have staged uploads whose layout transitions have yet to run
+    AstralCanvasVk_AwaitStaging(gpu);
+
     AstralCanvasVkCommandQueue *cmdQueue = &gpu->DedicatedGraphicsQueue;
     VkCommandBuffer cmdBuffer = AstralCanvasVk_CreateTransientCommandBuffer(gpu, cmdQueue, true);
+
+    AstralCanvasVkBarrierBatch barriers = AstralCanvasVkBarrierBatch(gpu, cmdBuffer);
     for (usize i = 0; i < numTextures; i++)
     {
-        AstralCanvasVk_TransitionTextureLayout(gpu, cmdBuffer, textures[i].texture, textures[i].aspectFlags, textures[i].newLayout);
+        barriers.TransitionTexture(textures[i].texture, textures[i].aspectFlags, textures[i].newLayout);
     }
+    barriers.Flush();
+
     AstralCanvasVk_EndTransientCommandBuffer(gpu, cmdQueue, cmdBuffer);
 }
 void AstralCanvasVk_TransitionTextureLayout(AstralVulkanGPU *gpu, VkCommandBuffer commandBufferToUse, Texture2D *texture, VkImageAspectFlags aspectFlags, VkImageLayout newLayout)
@@ -121,134 +248,22 @@ void AstralCanvasVk_TransitionTextureLayout(AstralVulkanGPU *gpu, VkCommandBuffe
 }
 void AstralCanvasVk_TransitionImageLayout(AstralVulkanGPU *gpu, VkCommandBuffer commandBufferToUse, VkImage imageHandle, u32 mipLevels, VkImageAspectFlags aspectFlags, VkImageLayout oldLayout, VkImageLayout newLayout)
 {
-    VkImageMemoryBarrier memBarrier = {};
-    memBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    memBarrier.oldLayout = oldLayout;
-    memBarrier.newLayout = newLayout;
-    memBarrier.srcQueueFamilyIndex = 0;
-    memBarrier.dstQueueFamilyIndex = 0;
-    memBarrier.image = imageHandle;
-    memBarrier.subresourceRange.aspectMask = aspectFlags;
-    memBarrier.subresourceRange.baseMipLevel = 0;
-    memBarrier.subresourceRange.levelCount = mipLevels;
-    memBarrier.subresourceRange.baseArrayLayer = 0;
-    memBarrier.subresourceRange.layerCount = 1;
-
-    VkPipelineStageFlags sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-    VkPipelineStageFlags destinationStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-
     AstralCanvasVkCommandQueue *cmdQueue = &gpu->DedicatedGraphicsQueue;
     VkCommandBuffer cmdBuffer = commandBufferToUse;
     if (commandBufferToUse == NULL)
     {
+        AstralCanvasVk_AwaitStaging(gpu);
         cmdBuffer = AstralCanvasVk_CreateTransientCommandBuffer(gpu, cmdQueue, true);
     }
 
     if (cmdBuffer != NULL)
     {
-        VkPipelineStageFlags depthStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-        VkPipelineStageFlags sampledStageMask = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-
-        switch (oldLayout)
-        {
-            case VK_IMAGE_LAYOUT_UNDEFINED:
-                break;
-
-            case VK_IMAGE_LAYOUT_GENERAL:
-                sourceStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
-                memBarrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
-                break;
-
-            case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
-                sourceStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-                memBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-                break;
-
-            case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
-                sourceStage = depthStageMask;
-                memBarrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-                break;
-
-            case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
-                sourceStage = depthStageMask | sampledStageMask;
-                break;
-
-            case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
-                sourceStage = sampledStageMask;
-                break;
-
-            case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
-                sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-                break;
-
-            case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
-                sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-                memBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-                break;
-
-            case VK_IMAGE_LAYOUT_PREINITIALIZED:
-                sourceStage = VK_PIPELINE_STAGE_HOST_BIT;
-                memBarrier.srcAccessMask = VK_ACCESS_HOST_WRITE_BIT;
-                break;
-
-            case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
-                break;
-
-            default:
-                THROW_ERR("Invalid source layout!");
-                break;
-        }
-
-        switch (newLayout)
-        {
-            switch (newLayout)
-            {
-                case VK_IMAGE_LAYOUT_GENERAL:
-                    destinationStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
-                    memBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
-                    break;
-
-                case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
-                    destinationStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-                    memBarrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-                    break;
-
-                case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
-                    destinationStage = depthStageMask;
-                    memBarrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-                    break;
-
-                case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
-                    destinationStage = depthStageMask | sampledStageMask;
-                    memBarrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
-                    break;
-
-                case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
-                    destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-                    memBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
-                    break;
-
-                case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
-                    destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-                    memBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-                    break;
-
-                case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
-                    destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-                    memBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-                    break;
-
-                case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
-                    // vkQueuePresentKHR performs automatic visibility operations
-                    break;
-
-                default:
-                    THROW_ERR("Invalid destination layout!");
-            }
-        }
+        //stage and access masks for both sides come from the layout state table
+        AstralCanvasVkBarrierBatch barriers = AstralCanvasVkBarrierBatch(gpu, cmdBuffer);
+        barriers.TransitionImage(imageHandle, mipLevels, aspectFlags, oldLayout, newLayout);
 
         cmdQueue->commandPoolMutex.EnterLock();
-        vkCmdPipelineBarrier(cmdBuffer, sourceStage, destinationStage, 0, 0, NULL, 0, NULL, 1, &memBarrier);
+        barriers.Flush();
         cmdQueue->commandPoolMutex.ExitLock();
 
         //only end and submit the buffer if the user did not provide one.
@@ -259,8 +274,36 @@ void AstralCanvasVk_TransitionImageLayout(AstralVulkanGPU *gpu, VkCommandBuffer
         }
     }
 }
+u32 AstralCanvasVk_GetPassAttachmentFormats(RenderProgram *program, u32 renderPass, VkFormat *colorFormats, VkFormat *depthFormat, VkFormat *stencilFormat)
+{
+    RenderPass *pass = &program->renderPasses.ptr[renderPass];
+    u32 colorCount = (u32)pass->colorAttachmentIndices.length;
+    if (colorCount > ASTRALVULKAN_MAX_COLOR_ATTACHMENTS)
+    {
+        THROW_ERR("Render pass writes to too many color attachments");
+        colorCount = ASTRALVULKAN_MAX_COLOR_ATTACHMENTS;
+    }
+    for (u32 i = 0; i < colorCount; i++)
+    {
+        colorFormats[i] = AstralCanvasVk_FromImageFormat(program->attachments.ptr[pass->colorAttachmentIndices.data[i]].imageFormat);
+    }
+    *depthFormat = VK_FORMAT_UNDEFINED;
+    *stencilFormat = VK_FORMAT_UNDEFINED;
+    if (pass->depthAttachmentIndex > -1)
+    {
+        ImageFormat format = program->attachments.ptr[pass->depthAttachmentIndex].imageFormat;
+        *depthFormat = AstralCanvasVk_FromImageFormat(format);
+        if (format == ImageFormat_Depth16Stencil8 || format == ImageFormat_Depth24Stencil8)
+        {
+            *stencilFormat = *depthFormat;
+        }
+    }
+    return colorCount;
+}
+
 void AstralCanvasVk_CopyBufferToBuffer(AstralVulkanGPU *gpu, VkBuffer from, VkBuffer to, usize copySize)
 {
+    AstralCanvasVk_AwaitStaging(gpu);
     VkCommandBuffer transientCmdBuffer = AstralCanvasVk_CreateTransientCommandBuffer(gpu, &gpu->DedicatedTransferQueue, true);
 
     VkBufferCopy bufferCopy{};
@@ -274,6 +317,7 @@ void AstralCanvasVk_CopyBufferToBuffer(AstralVulkanGPU *gpu, VkBuffer from, VkBu
 }
 void AstralCanvasVk_CopyImageToBuffer(AstralVulkanGPU *gpu, VkImage from, VkBuffer to, u32 width, u32 height)
 {
+    AstralCanvasVk_AwaitStaging(gpu);
     VkCommandBuffer transientCmdBuffer = AstralCanvasVk_CreateTransientCommandBuffer(gpu, &gpu->DedicatedTransferQueue, true);
 
     VkBufferImageCopy bufferImageCopy = {};
@@ -299,6 +343,7 @@ void AstralCanvasVk_CopyImageToBuffer(AstralVulkanGPU *gpu, VkImage from, VkBuff
 }
 void AstralCanvasVk_CopyBufferToImage(AstralVulkanGPU *gpu, VkBuffer from, VkImage imageHandle, u32 width, u32 height)
 {
+    AstralCanvasVk_AwaitStaging(gpu);
     VkCommandBuffer transientCmdBuffer = AstralCanvasVk_CreateTransientCommandBuffer(gpu, &gpu->DedicatedTransferQueue, true);
 
     VkBufferImageCopy bufferImageCopy = {};
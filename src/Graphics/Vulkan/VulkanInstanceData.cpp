@@ -12,11 +12,11 @@ bool                                    AstralCanvasVk_validationLayers = false;
 VkInstance                              AstralCanvasVk_instance = NULL;
 AstralVulkanGPU                         AstralCanvasVk_GPU = {};
 VmaAllocator                            AstralCanvasVk_vma = NULL;
-VkSemaphore                             AstralCanvasVk_AwaitPresentCompleteSemaphore = NULL;
-VkSemaphore                             AstralCanvasVk_AwaitRenderCompleteSemaphore = NULL;
-VkCommandPool                           AstralCanvasVk_MainCommandPool = NULL;
-VkCommandBuffer                         AstralCanvasVk_MainCommandBuffer = NULL;
-VkDescriptorPool                        AstralCanvasVk_DescriptorPool = NULL;
+u32                                     AstralCanvasVk_FramesInFlight = ASTRALVULKAN_DEFAULT_FRAMES_IN_FLIGHT;
+u32                                     AstralCanvasVk_CurrentFrame = 0;
+u64                                     AstralCanvasVk_FrameNumber = 0;
+bool                                    AstralCanvasVk_DynamicRenderingEnabled = false;
+AstralCanvasVkFrameData                 AstralCanvasVk_Frames[ASTRALVULKAN_MAX_FRAMES_IN_FLIGHT] = {};
 
 collections::vector<AstralVulkanSwapchain> windowToSwapchain;
 
@@ -74,48 +74,73 @@ void AstralCanvasVk_SetCurrentVulkanAllocator(VmaAllocator allocator)
     AstralCanvasVk_vma = allocator;
 }
 
-VkSemaphore AstralCanvasVk_GetAwaitPresentCompleteSemaphore()
+void AstralCanvasVk_SetFramesInFlight(u32 count)
 {
-    return AstralCanvasVk_AwaitPresentCompleteSemaphore;
+    if (count < ASTRALVULKAN_MIN_FRAMES_IN_FLIGHT)
+    {
+        count = ASTRALVULKAN_MIN_FRAMES_IN_FLIGHT;
+    }
+    else if (count > ASTRALVULKAN_MAX_FRAMES_IN_FLIGHT)
+    {
+        count = ASTRALVULKAN_MAX_FRAMES_IN_FLIGHT;
+    }
+    AstralCanvasVk_FramesInFlight = count;
 }
-void AstralCanvasVk_SetAwaitPresentCompleteSemaphore(VkSemaphore semaphore)
+u32 AstralCanvasVk_GetFramesInFlight()
 {
-    AstralCanvasVk_AwaitPresentCompleteSemaphore = semaphore;
+    return AstralCanvasVk_FramesInFlight;
 }
 
-VkSemaphore AstralCanvasVk_GetAwaitRenderCompleteSemaphore()
+u32 AstralCanvasVk_GetCurrentFrame()
+{
+    return AstralCanvasVk_CurrentFrame;
+}
+void AstralCanvasVk_SetCurrentFrame(u32 frame)
 {
-    return AstralCanvasVk_AwaitRenderCompleteSemaphore;
+    AstralCanvasVk_CurrentFrame = frame;
 }
-void AstralCanvasVk_SetAwaitRenderCompleteSemaphore(VkSemaphore semaphore)
+void AstralCanvasVk_AdvanceFrame()
 {
-    AstralCanvasVk_AwaitRenderCompleteSemaphore = semaphore;
+    AstralCanvasVk_CurrentFrame = (AstralCanvasVk_CurrentFrame + 1) % AstralCanvasVk_FramesInFlight;
+    AstralCanvasVk_FrameNumber += 1;
+}
+u64 AstralCanvasVk_GetFrameNumber()
+{
+    return AstralCanvasVk_FrameNumber;
 }
 
-VkCommandPool AstralCanvasVk_GetMainCmdPool()
+AstralCanvasVkFrameData *AstralCanvasVk_GetFrameData(u32 frame)
 {
-    return AstralCanvasVk_MainCommandPool;
+    return &AstralCanvasVk_Frames[frame];
 }
-void AstralCanvasVk_SetMainCmdPool(VkCommandPool commandPool)
+AstralCanvasVkFrameData *AstralCanvasVk_GetCurrentFrameData()
 {
-    AstralCanvasVk_MainCommandPool = commandPool;
+    return &AstralCanvasVk_Frames[AstralCanvasVk_CurrentFrame];
 }
 
-VkCommandBuffer AstralCanvasVk_GetMainCmdBuffer()
+VkSemaphore AstralCanvasVk_GetAwaitPresentCompleteSemaphore()
+{
+    return AstralCanvasVk_Frames[AstralCanvasVk_CurrentFrame].awaitPresentCompleteSemaphore;
+}
+VkSemaphore AstralCanvasVk_GetAwaitRenderCompleteSemaphore()
 {
-    return AstralCanvasVk_MainCommandBuffer;
+    return AstralCanvasVk_Frames[AstralCanvasVk_CurrentFrame].awaitRenderCompleteSemaphore;
 }
-void AstralCanvasVk_SetMainCmdBuffer(VkCommandBuffer commandBuffer)
+VkCommandPool AstralCanvasVk_GetMainCmdPool()
+{
+    return AstralCanvasVk_Frames[AstralCanvasVk_CurrentFrame].commandPool;
+}
+VkCommandBuffer AstralCanvasVk_GetMainCmdBuffer()
 {
-    AstralCanvasVk_MainCommandBuffer = commandBuffer;
+    return AstralCanvasVk_Frames[AstralCanvasVk_CurrentFrame].commandBuffer;
 }
 
-VkDescriptorPool AstralCanvasVk_GetDescriptorPool()
+void AstralCanvasVk_SetDynamicRenderingEnabled(bool value)
 {
-    return AstralCanvasVk_DescriptorPool;
+    AstralCanvasVk_DynamicRenderingEnabled = value;
 }
-void AstralCanvasVk_SetDescriptorPool(VkDescriptorPool pool)
+bool AstralCanvasVk_UseDynamicRendering()
 {
-    AstralCanvasVk_DescriptorPool = pool;
+    return AstralCanvasVk_DynamicRenderingEnabled && AstralCanvasVk_GPU.supportsDynamicRendering;
 }
 #endif
@@ -0,0 +1,161 @@
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanMemoryStatistics.hpp"
+#include "Graphics/Vulkan/VulkanInstanceData.hpp"
+#include "Graphics/Vulkan/vk_mem_alloc.h"
+#include "threading.hpp"
+
+AstralCanvas::GPUMemoryKindStatistics AstralCanvasVk_MemoryKindStatistics[AstralCanvas::GPUMemoryKind_Count] = {};
+u64 AstralCanvasVk_HeapPeakUsage[ASTRALCANVAS_MAX_MEMORY_HEAPS] = {};
+/// Heaps that have already been reported as over the soft budget
+bool AstralCanvasVk_HeapOverSoftBudget[ASTRALCANVAS_MAX_MEMORY_HEAPS] = {};
+float AstralCanvasVk_SoftBudgetFraction = 1.0f;
+AstralCanvas::GPUMemoryBudgetCallback AstralCanvasVk_SoftBudgetCallback = NULL;
+threading::Mutex AstralCanvasVk_MemoryStatisticsMutex;
+
+void AstralCanvasVk_CreateMemoryStatistics()
+{
+    AstralCanvasVk_MemoryStatisticsMutex = threading::Mutex::init();
+    for (u32 i = 0; i < AstralCanvas::GPUMemoryKind_Count; i++)
+    {
+        AstralCanvasVk_MemoryKindStatistics[i] = {};
+    }
+    for (u32 i = 0; i < ASTRALCANVAS_MAX_MEMORY_HEAPS; i++)
+    {
+        AstralCanvasVk_HeapPeakUsage[i] = 0;
+        AstralCanvasVk_HeapOverSoftBudget[i] = false;
+    }
+}
+void AstralCanvasVk_DestroyMemoryStatistics()
+{
+    AstralCanvasVk_MemoryStatisticsMutex.deinit();
+}
+
+void AstralCanvasVk_TrackAllocation(AstralCanvas::GPUMemoryKind kind, AstralCanvas::MemoryAllocation *memory)
+{
+    AstralCanvasVk_MemoryStatisticsMutex.EnterLock();
+    AstralCanvas::GPUMemoryKindStatistics *stats = &AstralCanvasVk_MemoryKindStatistics[kind];
+    stats->allocationCount += 1;
+    stats->bytes += memory->vkAllocationInfo.size;
+    if (stats->bytes > stats->peakBytes)
+    {
+        stats->peakBytes = stats->bytes;
+    }
+    AstralCanvasVk_MemoryStatisticsMutex.ExitLock();
+}
+void AstralCanvasVk_UntrackAllocation(AstralCanvas::GPUMemoryKind kind, AstralCanvas::MemoryAllocation *memory)
+{
+    AstralCanvasVk_MemoryStatisticsMutex.EnterLock();
+    AstralCanvas::GPUMemoryKindStatistics *stats = &AstralCanvasVk_MemoryKindStatistics[kind];
+    if (stats->allocationCount > 0)
+    {
+        stats->allocationCount -= 1;
+    }
+    stats->bytes = stats->bytes > memory->vkAllocationInfo.size ? stats->bytes - memory->vkAllocationInfo.size : 0;
+    AstralCanvasVk_MemoryStatisticsMutex.ExitLock();
+}
+
+/// Reads the allocator's budgets into result and raises the heap peaks to match. Must be called with the statistics mutex held
+void AstralCanvasVk_ReadHeapBudgets(AstralCanvas::GPUMemoryStatistics *result)
+{
+    VmaAllocator vma = AstralCanvasVk_GetCurrentVulkanAllocator();
+    if (vma == NULL)
+    {
+        result->heapCount = 0;
+        return;
+    }
+    const VkPhysicalDeviceMemoryProperties *memoryProperties;
+    vmaGetMemoryProperties(vma, &memoryProperties);
+
+    VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+    vmaGetHeapBudgets(vma, budgets);
+
+    result->heapCount = memoryProperties->memoryHeapCount;
+    for (u32 i = 0; i < result->heapCount; i++)
+    {
+        if (budgets[i].usage > AstralCanvasVk_HeapPeakUsage[i])
+        {
+            AstralCanvasVk_HeapPeakUsage[i] = budgets[i].usage;
+        }
+        AstralCanvas::GPUMemoryHeapStatistics *heap = &result->heaps[i];
+        heap->usage = budgets[i].usage;
+        heap->budget = budgets[i].budget;
+        heap->peakUsage = AstralCanvasVk_HeapPeakUsage[i];
+        heap->allocationBytes = budgets[i].statistics.allocationBytes;
+        heap->allocationCount = budgets[i].statistics.allocationCount;
+        heap->deviceLocal = (memoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+    }
+}
+
+void AstralCanvasVk_GetMemoryStatistics(AstralCanvas::GPUMemoryStatistics *result)
+{
+    AstralCanvasVk_MemoryStatisticsMutex.EnterLock();
+    AstralCanvasVk_ReadHeapBudgets(result);
+    for (u32 i = 0; i < AstralCanvas::GPUMemoryKind_Count; i++)
+    {
+        result->kinds[i] = AstralCanvasVk_MemoryKindStatistics[i];
+    }
+    AstralCanvasVk_MemoryStatisticsMutex.ExitLock();
+}
+void AstralCanvasVk_ResetMemoryPeaks()
+{
+    AstralCanvasVk_MemoryStatisticsMutex.EnterLock();
+    for (u32 i = 0; i < ASTRALCANVAS_MAX_MEMORY_HEAPS; i++)
+    {
+        AstralCanvasVk_HeapPeakUsage[i] = 0;
+    }
+    for (u32 i = 0; i < AstralCanvas::GPUMemoryKind_Count; i++)
+    {
+        AstralCanvasVk_MemoryKindStatistics[i].peakBytes = AstralCanvasVk_MemoryKindStatistics[i].bytes;
+    }
+    //heap peaks restart from the current usage
+    AstralCanvas::GPUMemoryStatistics current;
+    AstralCanvasVk_ReadHeapBudgets(&current);
+    AstralCanvasVk_MemoryStatisticsMutex.ExitLock();
+}
+void AstralCanvasVk_SetMemorySoftBudget(float budgetFraction, AstralCanvas::GPUMemoryBudgetCallback callback)
+{
+    AstralCanvasVk_SoftBudgetFraction = budgetFraction;
+    AstralCanvasVk_SoftBudgetCallback = callback;
+    for (u32 i = 0; i < ASTRALCANVAS_MAX_MEMORY_HEAPS; i++)
+    {
+        AstralCanvasVk_HeapOverSoftBudget[i] = false;
+    }
+}
+void AstralCanvasVk_UpdateMemoryBudgets(u64 frameNumber)
+{
+    VmaAllocator vma = AstralCanvasVk_GetCurrentVulkanAllocator();
+    if (vma == NULL)
+    {
+        return;
+    }
+    //budgets are only fetched from the driver when the frame index changes
+    vmaSetCurrentFrameIndex(vma, (u32)frameNumber);
+
+    AstralCanvas::GPUMemoryStatistics current;
+    AstralCanvasVk_MemoryStatisticsMutex.EnterLock();
+    AstralCanvasVk_ReadHeapBudgets(&current);
+    AstralCanvasVk_MemoryStatisticsMutex.ExitLock();
+
+    AstralCanvas::GPUMemoryBudgetCallback callback = AstralCanvasVk_SoftBudgetCallback;
+    if (callback == NULL)
+    {
+        return;
+    }
+    for (u32 i = 0; i < current.heapCount; i++)
+    {
+        u64 softBudget = (u64)((double)current.heaps[i].budget * (double)AstralCanvasVk_SoftBudgetFraction);
+        if (current.heaps[i].usage > softBudget)
+        {
+            if (!AstralCanvasVk_HeapOverSoftBudget[i])
+            {
+                AstralCanvasVk_HeapOverSoftBudget[i] = true;
+                callback(i, current.heaps[i].usage, softBudget);
+            }
+        }
+        else
+        {
+            AstralCanvasVk_HeapOverSoftBudget[i] = false;
+        }
+    }
+}
+#endif
@@ -0,0 +1,197 @@
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanPipelineCache.hpp"
+#include "ErrorHandling.hpp"
+#include "hash.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ASTRALVULKAN_PIPELINE_CACHE_MAGIC 0x43505341
+
+/// Written in front of the driver's own cache data. The driver header already identifies the vendor, device and
+/// cache UUID, the driver version and hash catch caches written by an older driver or truncated on disk
+struct AstralCanvasVkPipelineCacheFileHeader
+{
+    u32 magic;
+    u32 driverVersion;
+    u32 dataSize;
+    u32 dataHash;
+};
+
+const char *AstralCanvasVk_PipelineCachePath = NULL;
+VkPipelineCache AstralCanvasVk_PipelineCache = NULL;
+
+void AstralCanvasVk_SetPipelineCachePath(const char *path)
+{
+    AstralCanvasVk_PipelineCachePath = path;
+}
+const char *AstralCanvasVk_GetPipelineCachePath()
+{
+    return AstralCanvasVk_PipelineCachePath;
+}
+VkPipelineCache AstralCanvasVk_GetPipelineCache()
+{
+    return AstralCanvasVk_PipelineCache;
+}
+
+bool AstralCanvasVk_PipelineCacheDataIsValid(AstralVulkanGPU *gpu, u8 *data, usize size)
+{
+    if (size < sizeof(AstralCanvasVkPipelineCacheFileHeader) + sizeof(VkPipelineCacheHeaderVersionOne))
+    {
+        return false;
+    }
+    AstralCanvasVkPipelineCacheFileHeader fileHeader;
+    memcpy(&fileHeader, data, sizeof(AstralCanvasVkPipelineCacheFileHeader));
+    u8 *cacheData = data + sizeof(AstralCanvasVkPipelineCacheFileHeader);
+
+    if (fileHeader.magic != ASTRALVULKAN_PIPELINE_CACHE_MAGIC || fileHeader.driverVersion != gpu->properties.driverVersion)
+    {
+        return false;
+    }
+    if (fileHeader.dataSize != size - sizeof(AstralCanvasVkPipelineCacheFileHeader) || fileHeader.dataHash != GetHash(cacheData, fileHeader.dataSize))
+    {
+        return false;
+    }
+
+    VkPipelineCacheHeaderVersionOne cacheHeader;
+    memcpy(&cacheHeader, cacheData, sizeof(VkPipelineCacheHeaderVersionOne));
+    if (cacheHeader.headerSize < sizeof(VkPipelineCacheHeaderVersionOne) || cacheHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE)
+    {
+        return false;
+    }
+    if (cacheHeader.vendorID != gpu->properties.vendorID || cacheHeader.deviceID != gpu->properties.deviceID)
+    {
+        return false;
+    }
+    return memcmp(cacheHeader.pipelineCacheUUID, gpu->properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+bool AstralCanvasVk_CreatePipelineCache(AstralVulkanGPU *gpu)
+{
+    u8 *fileData = NULL;
+    usize fileSize = 0;
+
+    if (AstralCanvasVk_PipelineCachePath != NULL)
+    {
+        FILE *file = fopen(AstralCanvasVk_PipelineCachePath, "rb");
+        if (file != NULL)
+        {
+            fseek(file, 0, SEEK_END);
+            long length = ftell(file);
+            fseek(file, 0, SEEK_SET);
+            if (length > 0)
+            {
+                fileData = (u8 *)malloc((usize)length);
+                fileSize = fread(fileData, 1, (usize)length, file);
+            }
+            fclose(file);
+        }
+    }
+
+    VkPipelineCacheCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    if (fileData != NULL)
+    {
+        if (AstralCanvasVk_PipelineCacheDataIsValid(gpu, fileData, fileSize))
+        {
+            createInfo.initialDataSize = fileSize - sizeof(AstralCanvasVkPipelineCacheFileHeader);
+            createInfo.pInitialData = fileData + sizeof(AstralCanvasVkPipelineCacheFileHeader);
+        }
+        else
+        {
+            LOG_WARNING("Pipeline cache file was written by a different device or driver, discarding it");
+        }
+    }
+
+    VkResult result = vkCreatePipelineCache(gpu->logicalDevice, &createInfo, NULL, &AstralCanvasVk_PipelineCache);
+    if (result != VK_SUCCESS && createInfo.pInitialData != NULL)
+    {
+        //drivers may still reject data that passed validation, an empty cache is always better than none
+        createInfo.initialDataSize = 0;
+        createInfo.pInitialData = NULL;
+        result = vkCreatePipelineCache(gpu->logicalDevice, &createInfo, NULL, &AstralCanvasVk_PipelineCache);
+    }
+    if (fileData != NULL)
+    {
+        free(fileData);
+    }
+    if (result != VK_SUCCESS)
+    {
+        AstralCanvasVk_PipelineCache = NULL;
+        return false;
+    }
+    return true;
+}
+
+bool AstralCanvasVk_SavePipelineCache(AstralVulkanGPU *gpu)
+{
+    if (AstralCanvasVk_PipelineCache == NULL || AstralCanvasVk_PipelineCachePath == NULL)
+    {
+        return false;
+    }
+    usize dataSize = 0;
+    if (vkGetPipelineCacheData(gpu->logicalDevice, AstralCanvasVk_PipelineCache, &dataSize, NULL) != VK_SUCCESS || dataSize == 0)
+    {
+        return false;
+    }
+    u8 *fileData = (u8 *)malloc(sizeof(AstralCanvasVkPipelineCacheFileHeader) + dataSize);
+    u8 *cacheData = fileData + sizeof(AstralCanvasVkPipelineCacheFileHeader);
+    //the cache may have grown between the two calls, in which case the data written is still a valid prefix
+    if (vkGetPipelineCacheData(gpu->logicalDevice, AstralCanvasVk_PipelineCache, &dataSize, cacheData) < VK_SUCCESS)
+    {
+        free(fileData);
+        return false;
+    }
+
+    AstralCanvasVkPipelineCacheFileHeader fileHeader;
+    fileHeader.magic = ASTRALVULKAN_PIPELINE_CACHE_MAGIC;
+    fileHeader.driverVersion = gpu->properties.driverVersion;
+    fileHeader.dataSize = (u32)dataSize;
+    fileHeader.dataHash = GetHash(cacheData, dataSize);
+    memcpy(fileData, &fileHeader, sizeof(AstralCanvasVkPipelineCacheFileHeader));
+
+    //write to a temporary file first so that a crash midway never leaves a truncated cache behind
+    usize pathLength = strlen(AstralCanvasVk_PipelineCachePath);
+    char *tempPath = (char *)malloc(pathLength + 5);
+    memcpy(tempPath, AstralCanvasVk_PipelineCachePath, pathLength);
+    memcpy(tempPath + pathLength, ".tmp", 5);
+
+    bool succeeded = false;
+    FILE *file = fopen(tempPath, "wb");
+    if (file != NULL)
+    {
+        usize totalSize = sizeof(AstralCanvasVkPipelineCacheFileHeader) + dataSize;
+        succeeded = fwrite(fileData, 1, totalSize, file) == totalSize;
+        succeeded = fclose(file) == 0 && succeeded;
+        if (succeeded)
+        {
+            //rename does not replace existing files on all platforms
+            remove(AstralCanvasVk_PipelineCachePath);
+            succeeded = rename(tempPath, AstralCanvasVk_PipelineCachePath) == 0;
+        }
+        else
+        {
+            remove(tempPath);
+        }
+    }
+    if (!succeeded)
+    {
+        LOG_WARNING("Failed to write pipeline cache file");
+    }
+
+    free(tempPath);
+    free(fileData);
+    return succeeded;
+}
+
+void AstralCanvasVk_DestroyPipelineCache(AstralVulkanGPU *gpu)
+{
+    if (AstralCanvasVk_PipelineCache == NULL)
+    {
+        return;
+    }
+    AstralCanvasVk_SavePipelineCache(gpu);
+    vkDestroyPipelineCache(gpu->logicalDevice, AstralCanvasVk_PipelineCache, NULL);
+    AstralCanvasVk_PipelineCache = NULL;
+}
+#endif
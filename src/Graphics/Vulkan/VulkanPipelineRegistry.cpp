@@ -0,0 +1,229 @@
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanPipelineRegistry.hpp"
+#include "Graphics/Vulkan/VulkanPipelineCache.hpp"
+#include "Graphics/Vulkan/VulkanBindless.hpp"
+#include "Graphics/Vulkan/VulkanDestructionQueue.hpp"
+#include "ErrorHandling.hpp"
+#include "hashmap.hpp"
+#include "vector.hpp"
+#include "threading.hpp"
+#include <string.h>
+
+struct AstralCanvasVkRegisteredPipeline
+{
+    AstralCanvasVkPipelineStateKey key;
+    VkPipeline pipeline;
+    u32 refCount;
+};
+struct AstralCanvasVkRegisteredLayout
+{
+    VkDescriptorSetLayout setLayout;
+    u32 pushConstantsSize;
+    VkShaderStageFlags pushConstantsStages;
+    VkDescriptorSetLayout bindlessSetLayout;
+    VkPipelineLayout layout;
+    u32 refCount;
+};
+
+inline u32 AstralCanvasVk_PipelineStateKeyHash(AstralCanvasVkPipelineStateKey key)
+{
+    return key.hash;
+}
+inline bool AstralCanvasVk_PipelineStateKeyEql(AstralCanvasVkPipelineStateKey A, AstralCanvasVkPipelineStateKey B)
+{
+    return A.hash == B.hash && A.size == B.size && memcmp(A.data, B.data, A.size) == 0;
+}
+
+IAllocator AstralCanvasVk_PipelineRegistryAllocator;
+//keys in the map point into the owning entry's copy of the key data
+collections::hashmap<AstralCanvasVkPipelineStateKey, AstralCanvasVkRegisteredPipeline *> AstralCanvasVk_RegisteredPipelines;
+//releases look up by handle, which only happens on deinit, so a linear search is fine
+collections::vector<AstralCanvasVkRegisteredPipeline *> AstralCanvasVk_RegisteredPipelineList;
+collections::vector<AstralCanvasVkRegisteredLayout> AstralCanvasVk_RegisteredLayouts;
+threading::Mutex AstralCanvasVk_PipelineRegistryMutex;
+
+bool AstralCanvasVk_CreatePipelineRegistry(IAllocator allocator)
+{
+    AstralCanvasVk_PipelineRegistryAllocator = allocator;
+    AstralCanvasVk_RegisteredPipelines = collections::hashmap<AstralCanvasVkPipelineStateKey, AstralCanvasVkRegisteredPipeline *>(allocator, &AstralCanvasVk_PipelineStateKeyHash, &AstralCanvasVk_PipelineStateKeyEql);
+    AstralCanvasVk_RegisteredPipelineList = collections::vector<AstralCanvasVkRegisteredPipeline *>(allocator);
+    AstralCanvasVk_RegisteredLayouts = collections::vector<AstralCanvasVkRegisteredLayout>(allocator);
+    AstralCanvasVk_PipelineRegistryMutex = threading::Mutex::init();
+    return true;
+}
+void AstralCanvasVk_DestroyPipelineRegistry(AstralVulkanGPU *gpu)
+{
+    for (usize i = 0; i < AstralCanvasVk_RegisteredPipelineList.count; i++)
+    {
+        AstralCanvasVkRegisteredPipeline *entry = AstralCanvasVk_RegisteredPipelineList.ptr[i];
+        vkDestroyPipeline(gpu->logicalDevice, entry->pipeline, NULL);
+        AstralCanvasVk_PipelineRegistryAllocator.Free(entry->key.data);
+        AstralCanvasVk_PipelineRegistryAllocator.Free(entry);
+    }
+    for (usize i = 0; i < AstralCanvasVk_RegisteredLayouts.count; i++)
+    {
+        vkDestroyPipelineLayout(gpu->logicalDevice, AstralCanvasVk_RegisteredLayouts.ptr[i].layout, NULL);
+    }
+    AstralCanvasVk_RegisteredPipelines.deinit();
+    AstralCanvasVk_RegisteredPipelineList.deinit();
+    AstralCanvasVk_RegisteredLayouts.deinit();
+    AstralCanvasVk_PipelineRegistryMutex.deinit();
+}
+
+VkPipelineLayout AstralCanvasVk_AcquirePipelineLayout(AstralVulkanGPU *gpu, VkDescriptorSetLayout setLayout, u32 pushConstantsSize, VkShaderStageFlags pushConstantsStages, VkDescriptorSetLayout bindlessSetLayout)
+{
+    AstralCanvasVk_PipelineRegistryMutex.EnterLock();
+    for (usize i = 0; i < AstralCanvasVk_RegisteredLayouts.count; i++)
+    {
+        AstralCanvasVkRegisteredLayout *entry = &AstralCanvasVk_RegisteredLayouts.ptr[i];
+        if (entry->setLayout == setLayout && entry->pushConstantsSize == pushConstantsSize && entry->pushConstantsStages == pushConstantsStages && entry->bindlessSetLayout == bindlessSetLayout)
+        {
+            entry->refCount += 1;
+            AstralCanvasVk_PipelineRegistryMutex.ExitLock();
+            return entry->layout;
+        }
+    }
+
+    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
+    pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
+    pipelineLayoutCreateInfo.pPushConstantRanges = NULL;
+    VkPushConstantRange pushConstantRange{};
+    if (pushConstantsSize > 0)
+    {
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = pushConstantsSize;
+        pushConstantRange.stageFlags = pushConstantsStages;
+        pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+        pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+    }
+    pipelineLayoutCreateInfo.flags = 0;
+    pipelineLayoutCreateInfo.setLayoutCount = 0;
+    VkDescriptorSetLayout setLayouts[2];
+    if (bindlessSetLayout != NULL)
+    {
+        //the heap always lives in the second set, so the first needs a placeholder if the shader has no set of its own
+        setLayouts[0] = setLayout != NULL ? setLayout : AstralCanvasVk_GetEmptySetLayout();
+        setLayouts[1] = bindlessSetLayout;
+        pipelineLayoutCreateInfo.setLayoutCount = 2;
+        pipelineLayoutCreateInfo.pSetLayouts = setLayouts;
+    }
+    else if (setLayout != NULL)
+    {
+        pipelineLayoutCreateInfo.setLayoutCount = 1;
+        pipelineLayoutCreateInfo.pSetLayouts = &setLayout;
+    }
+
+    VkPipelineLayout layout;
+    if (vkCreatePipelineLayout(gpu->logicalDevice, &pipelineLayoutCreateInfo, NULL, &layout) != VK_SUCCESS)
+    {
+        AstralCanvasVk_PipelineRegistryMutex.ExitLock();
+        return NULL;
+    }
+    AstralCanvasVkRegisteredLayout entry;
+    entry.setLayout = setLayout;
+    entry.pushConstantsSize = pushConstantsSize;
+    entry.pushConstantsStages = pushConstantsStages;
+    entry.bindlessSetLayout = bindlessSetLayout;
+    entry.layout = layout;
+    entry.refCount = 1;
+    AstralCanvasVk_RegisteredLayouts.Add(entry);
+
+    AstralCanvasVk_PipelineRegistryMutex.ExitLock();
+    return layout;
+}
+void AstralCanvasVk_ReleasePipelineLayout(AstralVulkanGPU *gpu, VkPipelineLayout layout)
+{
+    if (layout == NULL)
+    {
+        return;
+    }
+    AstralCanvasVk_PipelineRegistryMutex.EnterLock();
+    for (usize i = 0; i < AstralCanvasVk_RegisteredLayouts.count; i++)
+    {
+        AstralCanvasVkRegisteredLayout *entry = &AstralCanvasVk_RegisteredLayouts.ptr[i];
+        if (entry->layout == layout)
+        {
+            entry->refCount -= 1;
+            if (entry->refCount == 0)
+            {
+                //command buffers of frames still in flight may have been recorded with it
+                AstralCanvasVk_QueueDestroyPipelineLayout(entry->layout);
+                AstralCanvasVk_RegisteredLayouts.RemoveAt_Swap(i);
+            }
+            break;
+        }
+    }
+    AstralCanvasVk_PipelineRegistryMutex.ExitLock();
+}
+
+VkPipeline AstralCanvasVk_AcquirePipeline(AstralVulkanGPU *gpu, AstralCanvasVkPipelineStateKey key, VkGraphicsPipelineCreateInfo *createInfo)
+{
+    AstralCanvasVk_PipelineRegistryMutex.EnterLock();
+    AstralCanvasVkRegisteredPipeline *existing = AstralCanvasVk_RegisteredPipelines.GetCopyOr(key, NULL);
+    if (existing != NULL)
+    {
+        existing->refCount += 1;
+        AstralCanvasVk_PipelineRegistryMutex.ExitLock();
+        return existing->pipeline;
+    }
+    //compile without holding the lock, prewarm workers may be creating unrelated pipelines at the same time
+    AstralCanvasVk_PipelineRegistryMutex.ExitLock();
+
+    VkPipeline pipeline;
+    if (vkCreateGraphicsPipelines(gpu->logicalDevice, AstralCanvasVk_GetPipelineCache(), 1, createInfo, NULL, &pipeline) != VK_SUCCESS)
+    {
+        return NULL;
+    }
+
+    AstralCanvasVk_PipelineRegistryMutex.EnterLock();
+    existing = AstralCanvasVk_RegisteredPipelines.GetCopyOr(key, NULL);
+    if (existing != NULL)
+    {
+        //another thread compiled the same state in the meantime
+        existing->refCount += 1;
+        AstralCanvasVk_PipelineRegistryMutex.ExitLock();
+        vkDestroyPipeline(gpu->logicalDevice, pipeline, NULL);
+        return existing->pipeline;
+    }
+
+    AstralCanvasVkRegisteredPipeline *entry = (AstralCanvasVkRegisteredPipeline *)AstralCanvasVk_PipelineRegistryAllocator.Allocate(sizeof(AstralCanvasVkRegisteredPipeline));
+    entry->key.data = (u8 *)AstralCanvasVk_PipelineRegistryAllocator.Allocate(key.size);
+    memcpy(entry->key.data, key.data, key.size);
+    entry->key.size = key.size;
+    entry->key.hash = key.hash;
+    entry->pipeline = pipeline;
+    entry->refCount = 1;
+
+    AstralCanvasVk_RegisteredPipelines.Add(entry->key, entry);
+    AstralCanvasVk_RegisteredPipelineList.Add(entry);
+    AstralCanvasVk_PipelineRegistryMutex.ExitLock();
+    return pipeline;
+}
+void AstralCanvasVk_ReleasePipeline(AstralVulkanGPU *gpu, VkPipeline pipeline)
+{
+    if (pipeline == NULL)
+    {
+        return;
+    }
+    AstralCanvasVk_PipelineRegistryMutex.EnterLock();
+    for (usize i = 0; i < AstralCanvasVk_RegisteredPipelineList.count; i++)
+    {
+        AstralCanvasVkRegisteredPipeline *entry = AstralCanvasVk_RegisteredPipelineList.ptr[i];
+        if (entry->pipeline == pipeline)
+        {
+            entry->refCount -= 1;
+            if (entry->refCount == 0)
+            {
+                AstralCanvasVk_QueueDestroyPipeline(entry->pipeline);
+                AstralCanvasVk_RegisteredPipelines.Remove(entry->key);
+                AstralCanvasVk_RegisteredPipelineList.RemoveAt_Swap(i);
+                AstralCanvasVk_PipelineRegistryAllocator.Free(entry->key.data);
+                AstralCanvasVk_PipelineRegistryAllocator.Free(entry);
+            }
+            break;
+        }
+    }
+    AstralCanvasVk_PipelineRegistryMutex.ExitLock();
+}
+#endif
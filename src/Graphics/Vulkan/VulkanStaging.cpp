@@ -0,0 +1,284 @@
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanStaging.hpp"
+#include "Graphics/Vulkan/VulkanHelpers.hpp"
+#include "Graphics/Vulkan/VulkanBarriers.hpp"
+#include "Graphics/Vulkan/vk_mem_alloc.h"
+#include <string.h>
+
+struct AstralCanvasVkStagingInFlight
+{
+    AstralCanvasVkSubmitTicket ticket;
+    u64 ringEnd;
+};
+struct AstralCanvasVkStagingDedicated
+{
+    //0 while the copy is still in the unsubmitted batch
+    AstralCanvasVkSubmitTicket ticket;
+    VkBuffer buffer;
+    AstralCanvas::MemoryAllocation memory;
+};
+
+//ring positions are virtual and only ever increase, the physical offset is position % capacity
+VkBuffer AstralCanvasVk_StagingRingBuffer = NULL;
+AstralCanvas::MemoryAllocation AstralCanvasVk_StagingRingMemory = {};
+usize AstralCanvasVk_StagingRingCapacity = 0;
+u64 AstralCanvasVk_StagingRingHead = 0;
+u64 AstralCanvasVk_StagingRingTail = 0;
+
+VkCommandBuffer AstralCanvasVk_StagingBatch = NULL;
+collections::vector<AstralCanvasVkStagingInFlight> AstralCanvasVk_StagingInFlight;
+collections::vector<AstralCanvasVkStagingDedicated> AstralCanvasVk_StagingDedicated;
+threading::Mutex AstralCanvasVk_StagingMutex;
+
+inline u64 AstralCanvasVk_AlignUp(u64 value, u64 alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+bool AstralCanvasVk_CreateStagingRing(AstralVulkanGPU *gpu, usize size)
+{
+    AstralCanvasVk_StagingRingBuffer = AstralCanvasVk_CreateResourceBuffer(gpu, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    if (AstralCanvasVk_StagingRingBuffer == NULL)
+    {
+        return false;
+    }
+    AstralCanvasVk_StagingRingMemory = AstralCanvasVk_AllocateMemoryForBuffer(AstralCanvasVk_StagingRingBuffer, AstralCanvas::GPUMemoryKind_Staging, VMA_MEMORY_USAGE_CPU_TO_GPU, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, true);
+    AstralCanvasVk_StagingRingCapacity = size;
+    AstralCanvasVk_StagingRingHead = 0;
+    AstralCanvasVk_StagingRingTail = 0;
+    AstralCanvasVk_StagingBatch = NULL;
+    AstralCanvasVk_StagingInFlight = collections::vector<AstralCanvasVkStagingInFlight>(GetCAllocator());
+    AstralCanvasVk_StagingDedicated = collections::vector<AstralCanvasVkStagingDedicated>(GetCAllocator());
+    AstralCanvasVk_StagingMutex = threading::Mutex::init();
+    return true;
+}
+
+//all functions below expect the staging mutex to be held
+void AstralCanvasVk_RetireStaging(AstralVulkanGPU *gpu)
+{
+    AstralCanvasVkCommandQueue *queue = &gpu->DedicatedGraphicsQueue;
+    while (AstralCanvasVk_StagingInFlight.count > 0 && AstralCanvasVk_TransientSubmissionCompleted(gpu, queue, AstralCanvasVk_StagingInFlight.ptr[0].ticket))
+    {
+        AstralCanvasVk_StagingRingTail = AstralCanvasVk_StagingInFlight.ptr[0].ringEnd;
+        AstralCanvasVk_StagingInFlight.RemoveAt_Pullback(0);
+    }
+    for (usize i = AstralCanvasVk_StagingDedicated.count; i > 0; i--)
+    {
+        AstralCanvasVkStagingDedicated *dedicated = AstralCanvasVk_StagingDedicated.Get(i - 1);
+        if (dedicated->ticket != 0 && AstralCanvasVk_TransientSubmissionCompleted(gpu, queue, dedicated->ticket))
+        {
+            vkDestroyBuffer(gpu->logicalDevice, dedicated->buffer, NULL);
+            AstralCanvasVk_FreeMemory(AstralCanvas::GPUMemoryKind_Staging, &dedicated->memory);
+            AstralCanvasVk_StagingDedicated.RemoveAt_Swap(i - 1);
+        }
+    }
+}
+VkCommandBuffer AstralCanvasVk_GetStagingBatch(AstralVulkanGPU *gpu)
+{
+    if (AstralCanvasVk_StagingBatch == NULL)
+    {
+        AstralCanvasVk_StagingBatch = AstralCanvasVk_CreateTransientCommandBuffer(gpu, &gpu->DedicatedGraphicsQueue, true);
+
+        //copies may overwrite resources that previously submitted frames are still reading from
+        AstralCanvasVkBarrierBatch barriers = AstralCanvasVkBarrierBatch(gpu, AstralCanvasVk_StagingBatch);
+        barriers.GlobalBarrier(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, 0, VK_PIPELINE_STAGE_2_TRANSFER_BIT, 0);
+        barriers.Flush();
+    }
+    return AstralCanvasVk_StagingBatch;
+}
+AstralCanvasVkSubmitTicket AstralCanvasVk_FlushStagingLocked(AstralVulkanGPU *gpu)
+{
+    if (AstralCanvasVk_StagingBatch == NULL)
+    {
+        return 0;
+    }
+
+    //make the copies visible to everything submitted after this batch
+    AstralCanvasVkBarrierBatch barriers = AstralCanvasVkBarrierBatch(gpu, AstralCanvasVk_StagingBatch);
+    barriers.GlobalBarrier(VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_2_INDEX_READ_BIT | VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_UNIFORM_READ_BIT | VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_TRANSFER_READ_BIT);
+    barriers.Flush();
+
+    AstralCanvasVkSubmitTicket ticket = AstralCanvasVk_SubmitTransientCommandBuffer(gpu, &gpu->DedicatedGraphicsQueue, AstralCanvasVk_StagingBatch);
+    AstralCanvasVk_StagingBatch = NULL;
+
+    AstralCanvasVkStagingInFlight inFlight;
+    inFlight.ticket = ticket;
+    inFlight.ringEnd = AstralCanvasVk_StagingRingHead;
+    AstralCanvasVk_StagingInFlight.Add(inFlight);
+
+    for (usize i = 0; i < AstralCanvasVk_StagingDedicated.count; i++)
+    {
+        if (AstralCanvasVk_StagingDedicated.ptr[i].ticket == 0)
+        {
+            AstralCanvasVk_StagingDedicated.ptr[i].ticket = ticket;
+        }
+    }
+    return ticket;
+}
+
+//the region must have its copy recorded before the mutex is released, otherwise a flush in between would submit the
+//batch with a ring end covering the region and free it on retirement while its copy still waits in the next batch
+AstralCanvasVkStagingRegion AstralCanvasVk_StagingAllocateLocked(AstralVulkanGPU *gpu, usize size, usize alignment)
+{
+    AstralCanvasVkStagingRegion result = {};
+    result.size = size;
+
+    AstralCanvasVk_RetireStaging(gpu);
+
+    //too large to share the ring with other uploads, give it its own buffer
+    if (size > AstralCanvasVk_StagingRingCapacity / 2)
+    {
+        AstralCanvasVkStagingDedicated dedicated;
+        dedicated.ticket = 0;
+        dedicated.buffer = AstralCanvasVk_CreateResourceBuffer(gpu, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+        if (dedicated.buffer == NULL)
+        {
+            THROW_ERR("Failed to create dedicated staging buffer");
+        }
+        dedicated.memory = AstralCanvasVk_AllocateMemoryForBuffer(dedicated.buffer, AstralCanvas::GPUMemoryKind_Staging, VMA_MEMORY_USAGE_CPU_TO_GPU, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, true);
+        AstralCanvasVk_StagingDedicated.Add(dedicated);
+
+        result.buffer = dedicated.buffer;
+        result.offset = 0;
+        result.mappedData = dedicated.memory.vkAllocationInfo.pMappedData;
+        return result;
+    }
+
+    u64 capacity = AstralCanvasVk_StagingRingCapacity;
+    u64 head = AstralCanvasVk_AlignUp(AstralCanvasVk_StagingRingHead, alignment);
+    u64 physicalOffset = head % capacity;
+    //regions never straddle the end of the ring
+    if (physicalOffset + size > capacity)
+    {
+        head += capacity - physicalOffset;
+        physicalOffset = 0;
+    }
+
+    //wait for older uploads to release enough of the ring
+    while (head + size - AstralCanvasVk_StagingRingTail > capacity)
+    {
+        if (AstralCanvasVk_StagingInFlight.count == 0)
+        {
+            //the space is taken up by the batch we have yet to submit
+            AstralCanvasVk_FlushStagingLocked(gpu);
+            if (AstralCanvasVk_StagingInFlight.count == 0)
+            {
+                //nothing recorded and nothing in flight, so the whole ring is free
+                AstralCanvasVk_StagingRingTail = AstralCanvasVk_StagingRingHead;
+                break;
+            }
+        }
+        AstralCanvasVk_AwaitTransientSubmission(gpu, &gpu->DedicatedGraphicsQueue, AstralCanvasVk_StagingInFlight.ptr[0].ticket);
+        AstralCanvasVk_RetireStaging(gpu);
+    }
+
+    AstralCanvasVk_StagingRingHead = head + size;
+
+    result.buffer = AstralCanvasVk_StagingRingBuffer;
+    result.offset = (usize)physicalOffset;
+    result.mappedData = (u8 *)AstralCanvasVk_StagingRingMemory.vkAllocationInfo.pMappedData + physicalOffset;
+    return result;
+}
+
+void AstralCanvasVk_StagingCopyToBufferLocked(AstralVulkanGPU *gpu, AstralCanvasVkStagingRegion region, VkBuffer to, usize toOffset)
+{
+    VkBufferCopy bufferCopy{};
+    bufferCopy.size = region.size;
+    bufferCopy.srcOffset = region.offset;
+    bufferCopy.dstOffset = toOffset;
+
+    vkCmdCopyBuffer(AstralCanvasVk_GetStagingBatch(gpu), region.buffer, to, 1, &bufferCopy);
+}
+void AstralCanvasVk_StagingCopyToImageLocked(AstralVulkanGPU *gpu, AstralCanvasVkStagingRegion region, VkImage to, u32 mipLevels, VkImageAspectFlags aspectFlags, u32 width, u32 height)
+{
+    VkBufferImageCopy bufferImageCopy = {};
+    bufferImageCopy.bufferOffset = region.offset;
+    bufferImageCopy.bufferRowLength = 0;
+    bufferImageCopy.bufferImageHeight = 0;
+    bufferImageCopy.imageSubresource.aspectMask = aspectFlags;
+    bufferImageCopy.imageSubresource.mipLevel = 0;
+    bufferImageCopy.imageSubresource.baseArrayLayer = 0;
+    bufferImageCopy.imageSubresource.layerCount = 1;
+    bufferImageCopy.imageOffset = {};
+    bufferImageCopy.imageExtent.width = width;
+    bufferImageCopy.imageExtent.height = height;
+    bufferImageCopy.imageExtent.depth = 1;
+
+    VkCommandBuffer batch = AstralCanvasVk_GetStagingBatch(gpu);
+    AstralCanvasVkBarrierBatch barriers = AstralCanvasVkBarrierBatch(gpu, batch);
+
+    barriers.TransitionImage(to, mipLevels, aspectFlags, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    barriers.Flush();
+
+    vkCmdCopyBufferToImage(batch, region.buffer, to, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &bufferImageCopy);
+
+    barriers.TransitionImage(to, mipLevels, aspectFlags, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    barriers.Flush();
+}
+
+void AstralCanvasVk_StageBufferUpload(AstralVulkanGPU *gpu, void *data, usize size, VkBuffer to, usize toOffset)
+{
+    AstralCanvasVk_StagingMutex.EnterLock();
+    AstralCanvasVkStagingRegion region = AstralCanvasVk_StagingAllocateLocked(gpu, size, ASTRALVULKAN_STAGING_ALIGNMENT);
+    memcpy(region.mappedData, data, size);
+    AstralCanvasVk_StagingCopyToBufferLocked(gpu, region, to, toOffset);
+    AstralCanvasVk_StagingMutex.ExitLock();
+}
+void AstralCanvasVk_StageImageUpload(AstralVulkanGPU *gpu, void *data, usize size, VkImage to, u32 mipLevels, VkImageAspectFlags aspectFlags, u32 width, u32 height)
+{
+    AstralCanvasVk_StagingMutex.EnterLock();
+    AstralCanvasVkStagingRegion region = AstralCanvasVk_StagingAllocateLocked(gpu, size, ASTRALVULKAN_STAGING_ALIGNMENT);
+    memcpy(region.mappedData, data, size);
+    AstralCanvasVk_StagingCopyToImageLocked(gpu, region, to, mipLevels, aspectFlags, width, height);
+    AstralCanvasVk_StagingMutex.ExitLock();
+}
+
+AstralCanvasVkSubmitTicket AstralCanvasVk_FlushStaging(AstralVulkanGPU *gpu)
+{
+    AstralCanvasVk_StagingMutex.EnterLock();
+    AstralCanvasVkSubmitTicket result = AstralCanvasVk_FlushStagingLocked(gpu);
+    AstralCanvasVk_RetireStaging(gpu);
+    AstralCanvasVk_StagingMutex.ExitLock();
+    return result;
+}
+void AstralCanvasVk_AwaitStaging(AstralVulkanGPU *gpu)
+{
+    if (AstralCanvasVk_StagingRingBuffer == NULL)
+    {
+        return;
+    }
+    AstralCanvasVk_StagingMutex.EnterLock();
+    AstralCanvasVk_FlushStagingLocked(gpu);
+    //other queues are not ordered against the staging batch, so flushing alone is not enough
+    for (usize i = 0; i < AstralCanvasVk_StagingInFlight.count; i++)
+    {
+        AstralCanvasVk_AwaitTransientSubmission(gpu, &gpu->DedicatedGraphicsQueue, AstralCanvasVk_StagingInFlight.ptr[i].ticket);
+    }
+    AstralCanvasVk_RetireStaging(gpu);
+    AstralCanvasVk_StagingMutex.ExitLock();
+}
+
+void AstralCanvasVk_DestroyStagingRing(AstralVulkanGPU *gpu)
+{
+    if (AstralCanvasVk_StagingRingBuffer == NULL)
+    {
+        return;
+    }
+    AstralCanvasVk_StagingMutex.EnterLock();
+    AstralCanvasVk_FlushStagingLocked(gpu);
+    for (usize i = 0; i < AstralCanvasVk_StagingInFlight.count; i++)
+    {
+        AstralCanvasVk_AwaitTransientSubmission(gpu, &gpu->DedicatedGraphicsQueue, AstralCanvasVk_StagingInFlight.ptr[i].ticket);
+    }
+    AstralCanvasVk_RetireStaging(gpu);
+    AstralCanvasVk_StagingMutex.ExitLock();
+
+    vkDestroyBuffer(gpu->logicalDevice, AstralCanvasVk_StagingRingBuffer, NULL);
+    AstralCanvasVk_FreeMemory(AstralCanvas::GPUMemoryKind_Staging, &AstralCanvasVk_StagingRingMemory);
+    AstralCanvasVk_StagingRingBuffer = NULL;
+
+    AstralCanvasVk_StagingInFlight.deinit();
+    AstralCanvasVk_StagingDedicated.deinit();
+    AstralCanvasVk_StagingMutex.deinit();
+}
+#endif
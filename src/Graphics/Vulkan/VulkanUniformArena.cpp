@@ -0,0 +1,138 @@
+#ifdef ASTRALCANVAS_VULKAN
+#include "Graphics/Vulkan/VulkanUniformArena.hpp"
+#include "Graphics/Vulkan/VulkanInstanceData.hpp"
+#include "Graphics/Vulkan/VulkanHelpers.hpp"
+#include "Graphics/Vulkan/vk_mem_alloc.h"
+#include "ErrorHandling.hpp"
+#include "vector.hpp"
+#include "threading.hpp"
+
+struct AstralCanvasVkUniformArenaBlock
+{
+    VkBuffer buffer;
+    AstralCanvas::MemoryAllocation memory;
+    usize size;
+};
+struct AstralCanvasVkFrameUniformArena
+{
+    /// Blocks are never freed until shutdown, so a frame that needed several once keeps them around for the next time
+    collections::vector<AstralCanvasVkUniformArenaBlock> blocks;
+    usize currentBlock;
+    usize head;
+};
+
+AstralCanvasVkFrameUniformArena AstralCanvasVk_FrameUniformArenas[ASTRALVULKAN_MAX_FRAMES_IN_FLIGHT];
+threading::Mutex AstralCanvasVk_UniformArenaMutex;
+
+inline usize AstralCanvasVk_UniformAlignUp(usize value, usize alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+bool AstralCanvasVk_CreateUniformArenaBlock(AstralVulkanGPU *gpu, usize size, AstralCanvasVkUniformArenaBlock *result)
+{
+    result->buffer = AstralCanvasVk_CreateResourceBuffer(gpu, size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+    if (result->buffer == NULL)
+    {
+        return false;
+    }
+    result->memory = AstralCanvasVk_AllocateMemoryForBuffer(result->buffer, AstralCanvas::GPUMemoryKind_Uniform, VMA_MEMORY_USAGE_CPU_TO_GPU, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, true);
+    if (result->memory.vkAllocation == NULL)
+    {
+        vkDestroyBuffer(gpu->logicalDevice, result->buffer, NULL);
+        return false;
+    }
+    result->size = size;
+    return true;
+}
+
+bool AstralCanvasVk_CreateUniformArenas(AstralVulkanGPU *gpu, IAllocator allocator)
+{
+    AstralCanvasVk_UniformArenaMutex = threading::Mutex::init();
+    for (u32 i = 0; i < ASTRALVULKAN_MAX_FRAMES_IN_FLIGHT; i++)
+    {
+        AstralCanvasVk_FrameUniformArenas[i].blocks = collections::vector<AstralCanvasVkUniformArenaBlock>(allocator);
+        AstralCanvasVk_FrameUniformArenas[i].currentBlock = 0;
+        AstralCanvasVk_FrameUniformArenas[i].head = 0;
+    }
+    for (u32 i = 0; i < AstralCanvasVk_GetFramesInFlight(); i++)
+    {
+        AstralCanvasVkUniformArenaBlock block;
+        if (!AstralCanvasVk_CreateUniformArenaBlock(gpu, ASTRALVULKAN_UNIFORM_ARENA_BLOCK_SIZE, &block))
+        {
+            return false;
+        }
+        AstralCanvasVk_FrameUniformArenas[i].blocks.Add(block);
+    }
+    return true;
+}
+void AstralCanvasVk_DestroyUniformArenas(AstralVulkanGPU *gpu)
+{
+    for (u32 i = 0; i < ASTRALVULKAN_MAX_FRAMES_IN_FLIGHT; i++)
+    {
+        AstralCanvasVkFrameUniformArena *arena = &AstralCanvasVk_FrameUniformArenas[i];
+        for (usize j = 0; j < arena->blocks.count; j++)
+        {
+            vkDestroyBuffer(gpu->logicalDevice, arena->blocks.ptr[j].buffer, NULL);
+            AstralCanvasVk_FreeMemory(AstralCanvas::GPUMemoryKind_Uniform, &arena->blocks.ptr[j].memory);
+        }
+        arena->blocks.deinit();
+        arena->currentBlock = 0;
+        arena->head = 0;
+    }
+    AstralCanvasVk_UniformArenaMutex.deinit();
+}
+
+void AstralCanvasVk_ResetFrameUniformArena(u32 frame)
+{
+    AstralCanvasVk_UniformArenaMutex.EnterLock();
+    AstralCanvasVk_FrameUniformArenas[frame].currentBlock = 0;
+    AstralCanvasVk_FrameUniformArenas[frame].head = 0;
+    AstralCanvasVk_UniformArenaMutex.ExitLock();
+}
+AstralCanvasVkUniformAllocation AstralCanvasVk_AllocateFromFrameArena(AstralVulkanGPU *gpu, usize size, usize alignment)
+{
+    AstralCanvasVkUniformAllocation result{};
+
+    AstralCanvasVk_UniformArenaMutex.EnterLock();
+    AstralCanvasVkFrameUniformArena *arena = &AstralCanvasVk_FrameUniformArenas[AstralCanvasVk_GetCurrentFrame()];
+    while (true)
+    {
+        if (arena->currentBlock >= arena->blocks.count)
+        {
+            AstralCanvasVkUniformArenaBlock block;
+            usize blockSize = size > ASTRALVULKAN_UNIFORM_ARENA_BLOCK_SIZE ? size : ASTRALVULKAN_UNIFORM_ARENA_BLOCK_SIZE;
+            if (!AstralCanvasVk_CreateUniformArenaBlock(gpu, blockSize, &block))
+            {
+                THROW_ERR("Failed to create uniform arena block");
+                break;
+            }
+            arena->blocks.Add(block);
+        }
+        AstralCanvasVkUniformArenaBlock *block = &arena->blocks.ptr[arena->currentBlock];
+        usize offset = AstralCanvasVk_UniformAlignUp(arena->head, alignment);
+        if (offset + size <= block->size)
+        {
+            arena->head = offset + size;
+            result.buffer = block->buffer;
+            result.offset = (u32)offset;
+            result.mappedData = (u8 *)block->memory.vkAllocationInfo.pMappedData + offset;
+            break;
+        }
+        //this block is full for the rest of the frame, move on to the next one
+        arena->currentBlock += 1;
+        arena->head = 0;
+    }
+    AstralCanvasVk_UniformArenaMutex.ExitLock();
+    return result;
+}
+AstralCanvasVkUniformAllocation AstralCanvasVk_AllocateFrameUniform(AstralVulkanGPU *gpu, usize size)
+{
+    return AstralCanvasVk_AllocateFromFrameArena(gpu, size, (usize)gpu->properties.limits.minUniformBufferOffsetAlignment);
+}
+AstralCanvasVkUniformAllocation AstralCanvasVk_AllocateFrameIndirect(AstralVulkanGPU *gpu, usize size)
+{
+    //indirect buffer offsets only need to be a multiple of 4
+    return AstralCanvasVk_AllocateFromFrameArena(gpu, size, sizeof(u32));
+}
+#endif